@@ -0,0 +1,119 @@
+#!/usr/bin/env node
+
+/**
+ * Gateway stand-in for load testing zoom-bot instances offline
+ * Accepts bot connections like the real gateway but only counts traffic:
+ * audio frames and bytes (reported as seconds of 16kHz mono audio) and
+ * metadata messages by type, per connection, every 5 seconds.
+ *
+ * Reconnect testing:
+ *   FAKE_GATEWAY_TLS_CERT / FAKE_GATEWAY_TLS_KEY  serve wss:// with this cert
+ *   FAKE_GATEWAY_DROP_MS                          drop every bot after N ms
+ *
+ * Rewind testing:
+ *   FAKE_GATEWAY_REWIND_S  every N seconds, ask each bot to replay its last
+ *                          N seconds; the replay (on /rewind) is timed
+ *
+ * Usage: node fake-gateway.js [port]
+ */
+
+const fs = require('fs');
+const https = require('https');
+const { WebSocketServer } = require('ws');
+
+const PORT = parseInt(process.argv[2] || process.env.GATEWAY_WS_PORT || '8080', 10);
+const REPORT_INTERVAL_MS = 5000;
+const BYTES_PER_SECOND = 16000 * 2; // 16kHz mono 16-bit
+const DROP_MS = parseInt(process.env.FAKE_GATEWAY_DROP_MS || '0', 10);
+const REWIND_S = parseInt(process.env.FAKE_GATEWAY_REWIND_S || '0', 10);
+const TLS = Boolean(process.env.FAKE_GATEWAY_TLS_CERT && process.env.FAKE_GATEWAY_TLS_KEY);
+
+let wss;
+if (TLS) {
+  const server = https.createServer({
+    cert: fs.readFileSync(process.env.FAKE_GATEWAY_TLS_CERT),
+    key: fs.readFileSync(process.env.FAKE_GATEWAY_TLS_KEY),
+  });
+  wss = new WebSocketServer({ server });
+  server.listen(PORT);
+} else {
+  wss = new WebSocketServer({ port: PORT });
+}
+let nextId = 1;
+const clients = new Map();
+let lastDisconnect = 0;
+
+function handleRewind(ws, requestId) {
+  const started = Date.now();
+  let bytes = 0;
+  ws.on('message', (data, isBinary) => {
+    if (isBinary) bytes += data.length;
+  });
+  ws.on('close', () => {
+    const audio = bytes / BYTES_PER_SECOND;
+    const elapsed = (Date.now() - started) / 1000;
+    console.log(`[FakeGateway] Rewind ${requestId}: ${audio.toFixed(1)}s of audio in ${elapsed.toFixed(1)}s ` +
+      `(${(audio / Math.max(elapsed, 0.001)).toFixed(1)}x realtime)`);
+  });
+}
+
+wss.on('connection', (ws, req) => {
+  const url = new URL(req.url || '/', 'ws://fake-gateway');
+  if (url.pathname === '/rewind') {
+    handleRewind(ws, url.searchParams.get('requestId'));
+    return;
+  }
+
+  const id = nextId++;
+  const stats = { frames: 0, bytes: 0, metadata: {} };
+  clients.set(id, stats);
+  const gap = lastDisconnect ? `, ${Date.now() - lastDisconnect}ms after last disconnect` : '';
+  console.log(`[FakeGateway] Bot #${id} connected (${clients.size} total${gap})`);
+
+  if (DROP_MS > 0) {
+    setTimeout(() => ws.terminate(), DROP_MS);
+  }
+  if (REWIND_S > 0) {
+    const timer = setInterval(() => {
+      const now = Date.now();
+      ws.send(JSON.stringify({ type: 'rewind_request', requestId: `fake-${id}-${now}`,
+        fromMs: now - REWIND_S * 1000, toMs: now }));
+    }, REWIND_S * 1000);
+    ws.on('close', () => clearInterval(timer));
+  }
+
+  ws.on('message', (data, isBinary) => {
+    if (isBinary) {
+      stats.frames++;
+      stats.bytes += data.length;
+      return;
+    }
+    try {
+      const type = JSON.parse(data.toString()).type || 'unknown';
+      stats.metadata[type] = (stats.metadata[type] || 0) + 1;
+    } catch (e) {
+      stats.metadata.invalid = (stats.metadata.invalid || 0) + 1;
+    }
+  });
+
+  ws.on('close', () => {
+    clients.delete(id);
+    lastDisconnect = Date.now();
+    console.log(`[FakeGateway] Bot #${id} disconnected (${clients.size} total)`);
+  });
+});
+
+setInterval(() => {
+  const seconds = REPORT_INTERVAL_MS / 1000;
+  for (const [id, stats] of clients) {
+    const meta = Object.entries(stats.metadata).map(([k, v]) => `${k}=${v}`).join(' ');
+    console.log(`[FakeGateway] Bot #${id}: ${(stats.frames / seconds).toFixed(1)} frames/s, ` +
+      `${(stats.bytes / BYTES_PER_SECOND / seconds).toFixed(2)}x realtime audio` +
+      (meta ? `, metadata: ${meta}` : ''));
+    stats.frames = 0;
+    stats.bytes = 0;
+    stats.metadata = {};
+  }
+}, REPORT_INTERVAL_MS);
+
+console.log(`[FakeGateway] Listening on ${TLS ? 'wss' : 'ws'}://localhost:${PORT}`);
@@ -0,0 +1,127 @@
+#!/usr/bin/env node
+
+/**
+ * Live transcription stand-in for testing the zoom-bot's direct mode offline
+ * Speaks enough of Deepgram's streaming protocol for the bot: checks the
+ * Authorization header and the encoding/sample_rate query, answers every
+ * second of audio with a final Results message ("second N", alternating
+ * speakers), and handles KeepAlive, Finalize and CloseStream.
+ *
+ * Point the bot at it with ZOOM_BOT_TRANSCRIBE_URL=ws://localhost:8081/v1/listen
+ *
+ *   FAKE_TRANSCRIBER_TOKEN     expected "Authorization: Token <value>" (default: any)
+ *   FAKE_TRANSCRIBER_DELAY_MS  delay before each result is sent (default 300)
+ *   FAKE_TRANSCRIBER_IDLE_S    close streams idle this long, like the real
+ *                              service (default 10)
+ *
+ * Usage: node fake-transcriber.js [port]
+ */
+
+const { WebSocketServer } = require('ws');
+
+const PORT = parseInt(process.argv[2] || '8081', 10);
+const TOKEN = process.env.FAKE_TRANSCRIBER_TOKEN || '';
+const DELAY_MS = parseInt(process.env.FAKE_TRANSCRIBER_DELAY_MS || '300', 10);
+const IDLE_S = parseInt(process.env.FAKE_TRANSCRIBER_IDLE_S || '10', 10);
+const BYTES_PER_SECOND = 16000 * 2; // linear16 mono at 16kHz
+
+const wss = new WebSocketServer({
+  port: PORT,
+  verifyClient: ({ req }, done) => {
+    const url = new URL(req.url || '/', 'ws://fake-transcriber');
+    if (TOKEN && req.headers.authorization !== `Token ${TOKEN}`) {
+      console.warn('[FakeTranscriber] Rejected: bad Authorization header');
+      return done(false, 401, 'Unauthorized');
+    }
+    if (url.searchParams.get('encoding') !== 'linear16' || url.searchParams.get('sample_rate') !== '16000') {
+      console.warn(`[FakeTranscriber] Rejected: unsupported audio format in ${url.search}`);
+      return done(false, 400, 'Bad Request');
+    }
+    done(true);
+  },
+});
+let nextId = 1;
+
+wss.on('connection', (ws) => {
+  const id = nextId++;
+  const started = Date.now();
+  let bytes = 0;
+  let reported = 0; // seconds already answered
+  let lastActivity = Date.now();
+  let closing = false;
+  console.log(`[FakeTranscriber] Stream #${id} opened`);
+
+  const result = (start, duration) => {
+    const speaker = Math.floor(start) % 2;
+    ws.send(JSON.stringify({
+      type: 'Results',
+      is_final: true,
+      speech_final: true,
+      start,
+      duration,
+      channel: {
+        alternatives: [{
+          transcript: `second ${Math.floor(start)}`,
+          confidence: 0.9,
+          words: [{ word: 'second', start, end: start + duration, speaker }],
+        }],
+      },
+    }));
+  };
+
+  // Answers whatever partial second is pending, then optionally closes
+  const flush = (close) => {
+    const sent = bytes / BYTES_PER_SECOND;
+    if (sent > reported) result(reported, sent - reported);
+    reported = sent;
+    if (close) {
+      ws.send(JSON.stringify({ type: 'Metadata', duration: sent }));
+      ws.close(1000);
+    }
+  };
+
+  const idleTimer = setInterval(() => {
+    if (Date.now() - lastActivity > IDLE_S * 1000) {
+      console.warn(`[FakeTranscriber] Stream #${id}: no audio or KeepAlive for ${IDLE_S}s, closing`);
+      ws.close(1011, 'NET-0001');
+    }
+  }, 1000);
+
+  ws.on('message', (data, isBinary) => {
+    lastActivity = Date.now();
+    if (isBinary) {
+      if (closing) return;
+      bytes += data.length;
+      while ((bytes / BYTES_PER_SECOND) - reported >= 1) {
+        const start = reported++;
+        setTimeout(() => ws.readyState === ws.OPEN && result(start, 1), DELAY_MS);
+      }
+      return;
+    }
+    let msg;
+    try {
+      msg = JSON.parse(data.toString());
+    } catch (e) {
+      console.warn(`[FakeTranscriber] Stream #${id}: invalid control message`);
+      return;
+    }
+    if (msg.type === 'Finalize') {
+      setTimeout(() => flush(false), DELAY_MS);
+    } else if (msg.type === 'CloseStream') {
+      closing = true;
+      setTimeout(() => flush(true), DELAY_MS);
+    } else if (msg.type !== 'KeepAlive') {
+      console.warn(`[FakeTranscriber] Stream #${id}: unknown message type ${msg.type}`);
+    }
+  });
+
+  ws.on('close', (code) => {
+    clearInterval(idleTimer);
+    const audio = bytes / BYTES_PER_SECOND;
+    const elapsed = (Date.now() - started) / 1000;
+    console.log(`[FakeTranscriber] Stream #${id} closed (${code}): ${audio.toFixed(1)}s of audio ` +
+      `in ${elapsed.toFixed(1)}s`);
+  });
+});
+
+console.log(`[FakeTranscriber] Listening on ws://localhost:${PORT}`);
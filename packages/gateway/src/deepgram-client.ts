@@ -72,7 +72,8 @@ export class DeepgramStreamClient extends EventEmitter {
             confidence: alternatives[0].confidence || 0
           };
 
-          this.emit('transcript', segment);
+          // start: seconds since the beginning of this Deepgram stream
+          this.emit('transcript', segment, data.start ?? 0);
         });
 
         this.connection.on(LiveTranscriptionEvents.Error, (error: any) => {
@@ -3,12 +3,14 @@
  */
 
 import { WebSocketServer, WebSocket } from 'ws';
+import type { IncomingMessage } from 'http';
 import type Redis from 'ioredis';
 import {
   TranscriptionState,
   REDIS_CHANNELS,
   CommandType,
-  type TranscriptSegment
+  type TranscriptSegment,
+  type TalkStatsData
 } from '@transcriber/shared';
 import { DeepgramStreamClient } from './deepgram-client';
 import { SessionManager } from './session-manager';
@@ -23,6 +25,19 @@ export class GatewayServer {
   private connectingToDeepgram = false;
   private deepgramRetryAt = 0; // timestamp: don't retry before this time
 
+  // Rewind: the bot's live connection (requests go out on it), when live
+  // audio started being dropped, and outstanding requests by id
+  private botSocket: WebSocket | null = null;
+  private transcriptionLostAt: number | null = null;
+  private rewinds = new Map<string, string>(); // requestId -> reason
+
+  // Stream id of the last transcript_result from a bot transcribing
+  // directly; it changes whenever the bot opens a new transcription stream
+  private transcriberStream: number | null = null;
+
+  // IRC users waiting for talk stats, answered in order by the bot
+  private talkStatsRequests: string[] = [];
+
   constructor(
     private config: GatewayConfig,
     private redis: Redis,
@@ -35,8 +50,18 @@ export class GatewayServer {
   }
 
   private setupWebSocketServer(): void {
-    this.wss.on('connection', async (ws: WebSocket) => {
+    this.wss.on('connection', async (ws: WebSocket, req: IncomingMessage) => {
+      // Replayed audio arrives on its own connection and never reaches the
+      // live Deepgram stream
+      const url = new URL(req.url ?? '/', 'ws://gateway');
+      if (url.pathname === '/rewind') {
+        this.handleRewindConnection(ws, url.searchParams.get('requestId') ?? '');
+        return;
+      }
+
       console.log('[Gateway] Client connected');
+      this.botSocket = ws;
+      this.notifyBotState();
 
       ws.on('message', async (data: Buffer, isBinary: boolean) => {
         if (isBinary) {
@@ -49,6 +74,7 @@ export class GatewayServer {
 
       ws.on('close', () => {
         console.log('[Gateway] Client disconnected');
+        if (this.botSocket === ws) this.botSocket = null;
       });
 
       ws.on('error', (error: Error) => {
@@ -78,6 +104,29 @@ export class GatewayServer {
       await this.resume(cmd.triggeredBy);
     });
 
+    this.sessionManager.onCommand(CommandType.REWIND, async (cmd) => {
+      if (!this.sessionManager.isChair(cmd.triggeredBy)) {
+        console.warn(`[Gateway] Unauthorized rewind attempt by ${cmd.triggeredBy}`);
+        return;
+      }
+
+      // The bot holds a few minutes at most; it answers with what it has
+      const seconds = Math.min(Number(cmd.args?.seconds) || 0, 3600);
+      if (seconds > 0) {
+        const now = Date.now();
+        this.requestRewind(now - seconds * 1000, now, `requested by ${cmd.triggeredBy}`);
+      }
+    });
+
+    this.sessionManager.onCommand(CommandType.TALK_STATS, async (cmd) => {
+      if (!this.botSocket || this.botSocket.readyState !== WebSocket.OPEN) {
+        console.warn(`[Gateway] Talk stats requested by ${cmd.triggeredBy}, but no bot is connected`);
+        return;
+      }
+      this.talkStatsRequests.push(cmd.triggeredBy);
+      this.botSocket.send(JSON.stringify({ type: 'talk_stats_request' }));
+    });
+
     this.sessionManager.onCommand(CommandType.SET_CHAIR, async (cmd) => {
       const nick = cmd.args?.nick as string;
       if (nick) {
@@ -132,6 +181,15 @@ export class GatewayServer {
     // This avoids Deepgram timing out before the zoom-bot is ready
 
     await this.sessionManager.updateState(TranscriptionState.ACTIVE, 'Started');
+    this.notifyBotState();
+  }
+
+  // Bots transcribing directly hold their audio back unless told the
+  // session is active; gateway-bound audio is gated in handleAudioData
+  private notifyBotState(): void {
+    if (!this.botSocket || this.botSocket.readyState !== WebSocket.OPEN) return;
+    const paused = this.sessionManager.getState() !== TranscriptionState.ACTIVE;
+    this.botSocket.send(JSON.stringify({ type: 'transcription_state', paused }));
   }
 
   private handleMetadata(message: string): void {
@@ -139,17 +197,83 @@ export class GatewayServer {
       const msg = JSON.parse(message);
       const type = msg.type;
 
-      if (type === 'participant_joined') {
-        console.log(`[Gateway] Participant joined: ${msg.name} (ID: ${msg.userId})`);
-        this.speakerMap.addParticipant(msg.userId, msg.name);
-      } else if (type === 'participant_left') {
-        console.log(`[Gateway] Participant left: ${msg.name} (ID: ${msg.userId})`);
-        this.speakerMap.removeParticipant(msg.userId);
+      if (type === 'participants_delta') {
+        // Roster changes batched by the bot; a rename carries the new name
+        const joined = msg.joined ?? [];
+        const left = msg.left ?? [];
+        const renamed = msg.renamed ?? [];
+        for (const p of [...joined, ...renamed]) {
+          this.speakerMap.addParticipant(p.userId, p.name);
+        }
+        for (const p of left) {
+          this.speakerMap.removeParticipant(p.userId);
+        }
+        if (joined.length + left.length + renamed.length <= 3) {
+          for (const p of joined) console.log(`[Gateway] Participant joined: ${p.name} (ID: ${p.userId})`);
+          for (const p of left) console.log(`[Gateway] Participant left: ${p.name} (ID: ${p.userId})`);
+          for (const p of renamed) console.log(`[Gateway] Participant renamed: ${p.name} (ID: ${p.userId})`);
+        } else {
+          console.log(`[Gateway] Participants: ${joined.length} joined, ${left.length} left, ` +
+            `${renamed.length} renamed`);
+        }
       } else if (type === 'speaker_update') {
         // Feed active speaker info to SpeakerMap for name resolution
         if (msg.activeSpeakers) {
           this.speakerMap.updateActiveSpeakers(msg.activeSpeakers);
         }
+      } else if (type === 'speaker_change') {
+        // Turn boundary found in the mixed audio, latencyMs before the bot
+        // sent it. Placed on our own clock, since speaker reports are
+        // stamped on arrival and the bot's wall clock may be ahead.
+        this.speakerMap.markTurnBoundary(Date.now() - (Number(msg.latencyMs) || 0));
+      } else if (type === 'audio_stats') {
+        // Periodic audio quality summary; only surface windows with problems
+        const mixed = msg.mixed;
+        if (mixed && (mixed.clipped > 0 || mixed.gaps > 0)) {
+          console.warn(`[Gateway] Audio quality: clipped=${mixed.clipped} gaps=${mixed.gaps} ` +
+            `(${mixed.gapMs}ms) jitter=${mixed.jitterMs}ms rms=${mixed.rmsDbfs}dBFS`);
+        }
+        if (mixed && mixed.stalledMs > 0) {
+          console.warn(`[Gateway] Bot has had no mixed audio from Zoom for ${mixed.stalledMs}ms`);
+        }
+      } else if (type === 'audio_discontinuity') {
+        // ahead: the bot's stream ran ahead of its clock (late audio after
+        // a concealed stall); concealed then means it was trimmed
+        const what = msg.ahead ? 'stream ahead by' : 'discontinuity of';
+        console.warn(`[Gateway] Audio ${what} ${msg.gapMs}ms at sample ${msg.position}` +
+          (msg.concealed ? (msg.ahead ? ' (trimmed by bot)' : ' (concealed by bot)') : ' (timeline re-anchored)'));
+      } else if (type === 'rewind_status') {
+        // The bot could not serve a rewind (busy, unavailable, invalid, failed)
+        console.warn(`[Gateway] Rewind ${msg.requestId} (${this.rewinds.get(msg.requestId) ?? 'unknown'}): ${msg.status}`);
+        this.rewinds.delete(msg.requestId);
+      } else if (type === 'transcript_result') {
+        // Final result from a bot streaming to the transcription service
+        // itself; attributed and published like the gateway's own results.
+        // A new stream (the bot reconnected to the service) has fresh
+        // diarization indices, as in connectToDeepgram.
+        if (msg.stream !== undefined && msg.stream !== this.transcriberStream) {
+          if (this.transcriberStream !== null) {
+            console.log('[Gateway] Bot opened a new transcription stream, resetting speaker map');
+          }
+          this.transcriberStream = msg.stream;
+          this.speakerMap.reset();
+        }
+        this.handleTranscript({
+          speaker: msg.speaker,
+          text: msg.text,
+          timestamp: msg.timestamp,
+          confidence: msg.confidence,
+        }).catch((error: Error) => {
+          console.error('[Gateway] Failed to publish transcript:', error.message || error);
+        });
+      } else if (type === 'talk_stats') {
+        this.handleTalkStats(msg);
+      } else if (type === 'load_shedding') {
+        // Bot is over its CPU budget; mixed audio is unaffected, speaker
+        // updates and audio_stats may arrive less often
+        const log = msg.level > 0 ? console.warn : console.log;
+        log(`[Gateway] Bot load level ${msg.level} (${msg.name}): ${msg.cycleUs}us per callback, ` +
+          `budget ${msg.budgetUs}us`);
       } else {
         console.log(`[Gateway] Metadata: ${type}`);
       }
@@ -158,6 +282,29 @@ export class GatewayServer {
     }
   }
 
+  private handleTalkStats(msg: TalkStatsData & { requested?: boolean }): void {
+    const top = msg.participants.slice(0, 3)
+      .map((p) => `${p.name} ${Math.round(p.talkMs / 1000)}s/${p.turns}`).join(', ');
+    console.log(`[Gateway] Talk stats: ${Math.round(msg.speechMs / 1000)}s of speech, ` +
+      `${Math.round(msg.overlapMs / 1000)}s overlapped` + (top ? `; top: ${top}` : ''));
+
+    // Periodic snapshots are only logged; answers to a request go to IRC
+    if (!msg.requested) return;
+    const data: TalkStatsData = {
+      speechMs: msg.speechMs,
+      overlapMs: msg.overlapMs,
+      overlaps: msg.overlaps,
+      participants: msg.participants,
+      requestedBy: this.talkStatsRequests.shift(),
+    };
+    this.redis.publish(
+      REDIS_CHANNELS.TRANSCRIPTION_EVENTS,
+      JSON.stringify({ type: 'talk_stats', data, timestamp: Date.now() })
+    ).catch((error: Error) => {
+      console.error('[Gateway] Failed to publish talk stats:', error.message || error);
+    });
+  }
+
   private async handleAudioData(data: Buffer): Promise<void> {
     const state = this.sessionManager.getState();
 
@@ -172,11 +319,18 @@ export class GatewayServer {
 
     // Connect to Deepgram on first audio (lazy connection avoids timeout)
     if (!this.deepgram || !this.deepgram.connected) {
+      this.transcriptionLostAt ??= Date.now();
       if (!this.connectingToDeepgram && Date.now() >= this.deepgramRetryAt) {
         console.log('[Gateway] Audio received, connecting to Deepgram...');
         this.connectingToDeepgram = true;
         await this.connectToDeepgram();
         this.connectingToDeepgram = false;
+
+        // Have the bot replay what was dropped while Deepgram was away
+        if (this.deepgram?.connected && this.transcriptionLostAt !== null) {
+          this.requestRewind(this.transcriptionLostAt, Date.now(), 'transcription outage');
+          this.transcriptionLostAt = null;
+        }
       }
       return; // Drop frames while connecting or during backoff
     }
@@ -205,12 +359,101 @@ export class GatewayServer {
     );
   }
 
+  private requestRewind(fromMs: number, toMs: number, reason: string): void {
+    if (!this.botSocket || this.botSocket.readyState !== WebSocket.OPEN) {
+      console.warn(`[Gateway] Cannot rewind (${reason}): zoom-bot not connected`);
+      return;
+    }
+
+    const requestId = `rw-${Date.now().toString(36)}`;
+    this.rewinds.set(requestId, reason);
+    this.botSocket.send(JSON.stringify({ type: 'rewind_request', requestId, fromMs, toMs }));
+    console.log(`[Gateway] Requested rewind ${requestId} of ${((toMs - fromMs) / 1000).toFixed(1)}s (${reason})`);
+  }
+
+  private handleRewindConnection(ws: WebSocket, requestId: string): void {
+    const reason = this.rewinds.get(requestId) ?? 'unknown request';
+    this.rewinds.delete(requestId);
+
+    // A separate Deepgram stream: its diarization starts afresh, so its
+    // "Speaker N" labels cannot be resolved through the live speaker map
+    const deepgram = new DeepgramStreamClient(this.config.deepgram);
+    const pending: Buffer[] = [];
+    let fromMs = Date.now();
+    let ready = false;
+    let finished = false;
+
+    deepgram.on('transcript', async (segment: TranscriptSegment, startSec: number) => {
+      await this.publishReplayedTranscript(segment, fromMs + startSec * 1000);
+    });
+
+    deepgram.on('error', (error: Error) => {
+      console.error(`[Gateway] Rewind ${requestId} Deepgram error:`, error.message || error);
+    });
+
+    deepgram.connect().then(() => {
+      ready = true;
+      for (const data of pending) deepgram.sendAudio(data);
+      pending.length = 0;
+      if (finished) deepgram.disconnect();
+    }).catch((error: any) => {
+      console.error(`[Gateway] Rewind ${requestId}: cannot connect to Deepgram:`, error.message || error);
+      ws.close();
+    });
+
+    ws.on('message', (data: Buffer, isBinary: boolean) => {
+      if (isBinary) {
+        if (ready) deepgram.sendAudio(data); else pending.push(data);
+        return;
+      }
+      try {
+        const msg = JSON.parse(data.toString());
+        if (msg.type === 'rewind_start') {
+          fromMs = msg.fromMs;
+          console.log(`[Gateway] Rewind ${requestId} (${reason}): receiving ` +
+            `${((msg.toMs - msg.fromMs) / 1000).toFixed(1)}s from ${new Date(msg.fromMs).toISOString()}`);
+        } else if (msg.type === 'rewind_end') {
+          console.log(`[Gateway] Rewind ${requestId}: ${msg.sentMs}ms received` +
+            (msg.complete ? '' : ' (bot stopped early)'));
+        }
+      } catch (e) {
+        console.warn(`[Gateway] Rewind ${requestId}: bad control message`);
+      }
+    });
+
+    // Deepgram flushes its last results for the audio already sent
+    ws.on('close', () => {
+      finished = true;
+      if (ready) deepgram.disconnect();
+    });
+  }
+
+  private async publishReplayedTranscript(segment: TranscriptSegment, capturedAt: number): Promise<void> {
+    if (this.sessionManager.getState() === TranscriptionState.IDLE) {
+      return;
+    }
+
+    segment.speaker = `${segment.speaker} (replayed)`;
+    segment.timestamp = Math.round(capturedAt);
+    segment.replayed = true;
+
+    await this.redis.publish(
+      REDIS_CHANNELS.TRANSCRIPTION_EVENTS,
+      JSON.stringify({
+        type: 'transcript',
+        data: segment,
+        timestamp: Date.now()
+      })
+    );
+  }
+
   async pause(triggeredBy: string): Promise<void> {
     console.log(`[Gateway] Pausing transcription (by ${triggeredBy})`);
     await this.sessionManager.updateState(
       TranscriptionState.PAUSED,
       `Paused by ${triggeredBy}`
     );
+    this.notifyBotState();
   }
 
   async resume(triggeredBy: string): Promise<void> {
@@ -219,6 +462,7 @@ export class GatewayServer {
       TranscriptionState.ACTIVE,
       `Resumed by ${triggeredBy}`
     );
+    this.notifyBotState();
   }
 
   async stop(): Promise<void> {
@@ -230,6 +474,7 @@ export class GatewayServer {
     }
 
     await this.sessionManager.updateState(TranscriptionState.IDLE, 'Stopped');
+    this.notifyBotState();
     this.wss.close();
   }
 }
@@ -10,6 +10,10 @@
  * - If not, we assume the currently active Zoom speaker corresponds to this
  *   new Deepgram index and create the mapping.
  * - Once a mapping is established, it persists for the session.
+ * - The bot also reports turn boundaries found in the mixed audio
+ *   (speaker_change). Active-speaker reports from before the latest
+ *   boundary describe the previous turn, so they are not used to map a new
+ *   index.
  */
 
 interface SpeakerEntry {
@@ -32,11 +36,14 @@ export class SpeakerMap {
   private activeSpeakers: ActiveSpeaker[] = [];
   // Last speaker seen as active, used as a fallback for phantom indices
   private lastActiveSpeaker: ActiveSpeaker | null = null;
+  // Wall clock of the latest turn boundary reported by the zoom-bot
+  private lastTurnBoundary = 0;
 
   /**
    * Update the list of currently active speakers (from zoom-bot metadata).
+   * The bot ranks them, dominant speaker first.
    */
-  updateActiveSpeakers(speakers: Array<{ userId: number; name: string }>): void {
+  updateActiveSpeakers(speakers: Array<{ userId: number; name: string; confidence?: number }>): void {
     const now = Date.now();
     this.activeSpeakers = speakers.map(s => ({
       userId: s.userId,
@@ -48,6 +55,14 @@ export class SpeakerMap {
     }
   }
 
+  /**
+   * Record a turn boundary detected in the mixed audio (from zoom-bot
+   * metadata). timestamp is on the gateway's clock, like speaker reports.
+   */
+  markTurnBoundary(timestamp: number): void {
+    this.lastTurnBoundary = Math.max(this.lastTurnBoundary, timestamp);
+  }
+
   /**
    * Handle a participant joining - no action needed, speaker_update handles it.
    */
@@ -89,8 +104,9 @@ export class SpeakerMap {
     let firstActiveMapped: ActiveSpeaker | null = null;
 
     for (const speaker of this.activeSpeakers) {
-      // Only consider recent activity (within last 3 seconds)
+      // Only consider recent activity (within last 3 seconds) in the current turn
       if (now - speaker.timestamp > 3000) continue;
+      if (speaker.timestamp < this.lastTurnBoundary) continue;
 
       if (!this.assignedNames.has(speaker.name)) {
         // New participant seen for the first time - create a fresh mapping
@@ -109,7 +125,9 @@ export class SpeakerMap {
     // Deepgram created a phantom index for someone already mapped under a
     // different index (common when diarization re-clusters mid-session).
     // Attribute it to whoever the zoom-bot says is currently speaking.
-    const fallback = firstActiveMapped ?? this.lastActiveSpeaker;
+    const fallback = firstActiveMapped ??
+      (this.lastActiveSpeaker && this.lastActiveSpeaker.timestamp >= this.lastTurnBoundary
+        ? this.lastActiveSpeaker : null);
     if (fallback) {
       this.indexToName.set(index, { name: fallback.name, zoomUserId: fallback.userId });
       console.log(`[SpeakerMap] Mapped phantom Speaker ${index} → ${fallback.name} (re-cluster)`);
@@ -128,5 +146,6 @@ export class SpeakerMap {
     this.assignedNames.clear();
     this.activeSpeakers = [];
     this.lastActiveSpeaker = null;
+    this.lastTurnBoundary = 0;
   }
 }
@@ -8,6 +8,7 @@ import {
   TranscriptionState,
   type TranscriptSegment,
   type StateChangeData,
+  type TalkStatsData,
   type TranscriptionEvent
 } from '@transcriber/shared';
 import { IRCClient, type IRCMessage } from './irc-client';
@@ -18,6 +19,8 @@ import type { BotConfig } from './config';
 const MAX_LINE_LENGTH = 400;
 // Flush buffer after this many ms of no new transcript from same speaker
 const BUFFER_FLUSH_DELAY_MS = 3000;
+// Participants listed in a stats reply; the rest are summarised
+const MAX_STATS_LINES = 8;
 
 interface TranscriptBuffer {
   speaker: string;
@@ -94,6 +97,10 @@ export class TranscriptionBot {
   }
 
   private handleTranscriptEvent(event: TranscriptionEvent): void {
+    if (event.type === 'talk_stats') {
+      this.postTalkStats(event.data as TalkStatsData);
+      return;
+    }
     if (event.type !== 'transcript') {
       return;
     }
@@ -161,6 +168,31 @@ export class TranscriptionBot {
     }
   }
 
+  private postTalkStats(stats: TalkStatsData): void {
+    const duration = (ms: number): string => {
+      const seconds = Math.round(ms / 1000);
+      return seconds >= 60 ? `${Math.floor(seconds / 60)}m${String(seconds % 60).padStart(2, '0')}s` : `${seconds}s`;
+    };
+
+    if (stats.participants.length === 0) {
+      this.sendMessage('📊 Nobody has spoken yet');
+      return;
+    }
+
+    const lines = [`📊 Speaking time: ${duration(stats.speechMs)} of speech, ` +
+      `${duration(stats.overlapMs)} with people talking at once (${stats.overlaps} times)`];
+    for (const p of stats.participants.slice(0, MAX_STATS_LINES)) {
+      const share = stats.speechMs > 0 ? Math.round(100 * p.talkMs / stats.speechMs) : 0;
+      lines.push(`  ${p.name}${p.present ? '' : ' (left)'}: ${duration(p.talkMs)} (${share}%), ` +
+        `${p.turns} turns, ${p.interruptions} interruptions`);
+    }
+    const rest = stats.participants.length - MAX_STATS_LINES;
+    if (rest > 0) {
+      lines.push(`  ...and ${rest} more`);
+    }
+    this.sendMessage(lines.join('\n'));
+  }
+
   private flushBuffer(): void {
     if (!this.buffer || !this.buffer.text) return;
 
@@ -46,6 +46,12 @@ export class CommandHandler {
       case 'chair':
         return await this.handleChair(nick, args);
 
+      case 'rewind':
+        return await this.handleRewind(nick, args);
+
+      case 'stats':
+        return await this.handleStats(nick);
+
       case 'scribe':
         return this.handleScribe();
 
@@ -111,6 +117,36 @@ export class CommandHandler {
     return `✓ Added ${chairNick} as meeting chair`;
   }
 
+  private async handleRewind(nick: string, args: string[]): Promise<string | null> {
+    const seconds = parseInt(args[0], 10);
+    if (!(seconds > 0)) {
+      return `Usage: ${this.commandPrefix} rewind <seconds> - Re-transcribe the last <seconds> of audio`;
+    }
+
+    const cmd: Command = {
+      type: CommandType.REWIND,
+      triggeredBy: nick,
+      timestamp: Date.now(),
+      args: { seconds }
+    };
+
+    await this.redis.publish(REDIS_CHANNELS.COMMANDS, JSON.stringify(cmd));
+    // Replayed transcripts are posted as they arrive
+    return null;
+  }
+
+  private async handleStats(nick: string): Promise<null> {
+    const cmd: Command = {
+      type: CommandType.TALK_STATS,
+      triggeredBy: nick,
+      timestamp: Date.now()
+    };
+
+    await this.redis.publish(REDIS_CHANNELS.COMMANDS, JSON.stringify(cmd));
+    // The zoom-bot's answer is posted when it arrives
+    return null;
+  }
+
   private handleScribe(): string {
     this.scribeActive = !this.scribeActive;
     return this.scribeActive ? 'scribe+' : 'scribe-';
@@ -124,6 +160,8 @@ export class CommandHandler {
       `  ${p} resume         - Resume transcription (chairs only)`,
       `  ${p} status         - Show transcription status`,
       `  ${p} chair <nick>   - Add a meeting chair`,
+      `  ${p} rewind <secs>  - Re-transcribe the last <secs> of audio (chairs only)`,
+      `  ${p} stats          - Show speaking time per participant`,
       `  ${p} scribe         - Toggle scribe mode (scribe+/scribe-)`,
       `  ${p} help           - Show this help message`
     ].join('\n');
@@ -14,7 +14,9 @@ export enum CommandType {
   RESUME = 'resume',
   STATUS = 'status',
   SET_CHAIR = 'set_chair',
-  REMOVE_CHAIR = 'remove_chair'
+  REMOVE_CHAIR = 'remove_chair',
+  REWIND = 'rewind',
+  TALK_STATS = 'talk_stats'
 }
 
 export interface Command {
@@ -14,11 +14,12 @@ export interface TranscriptSegment {
   text: string;
   timestamp: number;
   confidence: number;
+  replayed?: boolean; // re-transcribed from the bot's rewind buffer
 }
 
 export interface TranscriptionEvent {
-  type: 'transcript' | 'state_change' | 'error';
-  data: TranscriptSegment | StateChangeData | ErrorData;
+  type: 'transcript' | 'state_change' | 'error' | 'talk_stats';
+  data: TranscriptSegment | StateChangeData | ErrorData | TalkStatsData;
   timestamp: number;
 }
 
@@ -29,6 +30,25 @@ export interface StateChangeData {
   triggeredBy?: string; // IRC user who triggered the change
 }
 
+export interface ParticipantTalkStats {
+  userId: number;
+  name: string;
+  talkMs: number;
+  turns: number; // speech runs started
+  interruptions: number; // runs started while someone else was talking
+  overlapMs: number; // time spent talking over someone else
+  speaking: boolean;
+  present: boolean; // false once the participant has left
+}
+
+export interface TalkStatsData {
+  speechMs: number; // time with at least one person talking
+  overlapMs: number; // time with two or more talking at once
+  overlaps: number;
+  participants: ParticipantTalkStats[]; // most talk time first
+  requestedBy?: string; // IRC user who asked
+}
+
 export interface ErrorData {
   message: string;
   code?: string;
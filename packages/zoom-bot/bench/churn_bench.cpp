@@ -0,0 +1,152 @@
+// churn-bench: hours of participant churn through ParticipantTracker and
+// its NameTable on the participant arena, in simulated time. The roster
+// stays at --participants; every change is a leave and a join, or a
+// rename, applied in batches as RosterBatcher would, with a few people
+// talking at any time. Joiners and renames draw from a name pool a few
+// times the roster size, so names are both reused and freed. Every
+// --report-s of meeting time it prints what the arena holds, has carved
+// and has spilled to the heap, the interned name count, process RSS, and
+// the time and arena allocations per change (interning included). With a
+// working arena the figures level off after the first rows; run again
+// with --arena-mb 0 to compare RSS on the heap.
+//
+//   churn-bench                                      200 people, 200 changes/s, 4h
+//   churn-bench --participants 1000 --churn-per-s 500 --hours 8 --arena-mb 0
+
+#include "participant_arena.h"
+#include "participant_tracker.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t BATCH_MS = 100;        // RosterBatcher's coalescing window
+constexpr double RENAME_SHARE = 0.2;      // of changes
+constexpr size_t NAME_POOL_FACTOR = 4;    // distinct names per roster seat
+constexpr size_t TALKERS = 3;
+
+double residentMb() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t sizePages = 0;
+    uint64_t residentPages = 0;
+    if (!(statm >> sizePages >> residentPages)) return 0.0;
+    return residentPages * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024 * 1024);
+}
+
+std::string poolName(size_t i) {
+    // Long enough to need a heap buffer, as display names usually do
+    return "Participant " + std::to_string(i) + " (Example Organization)";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t participants = 200;
+    double churnPerS = 200;
+    double hours = 4;
+    double reportS = 900;
+    size_t arenaMb = 16;
+    unsigned int seed = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--participants") participants = std::stoul(argv[i + 1]);
+        else if (arg == "--churn-per-s") churnPerS = std::stod(argv[i + 1]);
+        else if (arg == "--hours") hours = std::stod(argv[i + 1]);
+        else if (arg == "--report-s") reportS = std::stod(argv[i + 1]);
+        else if (arg == "--arena-mb") arenaMb = std::stoul(argv[i + 1]);
+        else if (arg == "--seed") seed = std::stoul(argv[i + 1]);
+        else {
+            std::fprintf(stderr, "usage: %s [--participants N] [--churn-per-s N] [--hours N] [--report-s N] "
+                                 "[--arena-mb MB] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (participants == 0) participants = 1;
+    if (reportS < 1) reportS = 1;
+
+    // The tracker logs every batch; only the report goes to stdout
+    std::cout.rdbuf(nullptr);
+
+    ParticipantArena arena(arenaMb);
+    ParticipantTracker tracker(&arena);
+    NameTable& names = tracker.names();
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::uniform_int_distribution<size_t> pool(0, participants * NAME_POOL_FACTOR - 1);
+
+    // Seats hold the user ids currently in the meeting
+    std::vector<uint32_t> seats;
+    uint32_t nextUserId = 1;
+    std::vector<RosterChange> batch;
+    for (size_t s = 0; s < participants; s++) {
+        seats.push_back(nextUserId);
+        batch.push_back({RosterChange::Kind::Join, nextUserId++, names.intern(poolName(pool(rng)))});
+    }
+    tracker.apply(batch);
+    for (const auto& change : batch) names.release(change.name);
+    batch.clear();
+    arena.stats();  // start counting allocations from here
+
+    std::printf("meeting          %zu participants, %.0f changes/s in %llums batches, %.1fh, arena %zuMB\n",
+                participants, churnPerS, static_cast<unsigned long long>(BATCH_MS), hours, arenaMb);
+    std::printf("%-8s %10s %10s %10s %11s %11s %9s %7s %8s %10s %13s\n", "minute", "changes", "in use kb", "peak kb",
+                "reserved kb", "overflow kb", "large kb", "names", "rss mb", "us/change", "allocs/change");
+
+    std::uniform_int_distribution<size_t> seat(0, participants - 1);
+    double perBatch = churnPerS * BATCH_MS / 1000.0;
+    double owed = 0;
+    uint64_t changes = 0, windowChanges = 0;
+    double windowS = 0;
+    auto endMs = static_cast<uint64_t>(hours * 3600 * 1000);
+    auto reportMs = static_cast<uint64_t>(reportS * 1000);
+    const uint64_t startMs = 1700000000000ULL;
+
+    for (uint64_t t = BATCH_MS; t <= endMs; t += BATCH_MS) {
+        auto t0 = std::chrono::steady_clock::now();
+        owed += perBatch;
+        for (; owed >= 1; owed -= 1) {
+            changes++;
+            windowChanges++;
+            size_t s = seat(rng);
+            if (unit(rng) < RENAME_SHARE) {
+                batch.push_back({RosterChange::Kind::Rename, seats[s], names.intern(poolName(pool(rng)))});
+            } else {
+                batch.push_back({RosterChange::Kind::Leave, seats[s], nullptr});
+                seats[s] = nextUserId++;
+                batch.push_back({RosterChange::Kind::Join, seats[s], names.intern(poolName(pool(rng)))});
+            }
+        }
+
+        if (!batch.empty()) {
+            tracker.apply(batch);
+            for (const auto& change : batch) names.release(change.name);
+            batch.clear();
+        }
+
+        // A few people talking, so speech runs open and close
+        uint64_t now = startMs + t;
+        for (size_t k = 0; k < TALKERS; k++) tracker.markActive(seats[(t / 3000 + k * 7) % participants], now);
+        tracker.decayActivity(now);
+        windowS += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        if (t % reportMs == 0 || t + BATCH_MS > endMs) {
+            auto stats = arena.stats();
+            double perChange = windowChanges ? 1.0 / windowChanges : 0.0;
+            std::printf("%-8.0f %10llu %10.1f %10.1f %11.1f %11.1f %9.1f %7zu %8.1f %10.2f %13.2f\n", t / 60000.0,
+                        static_cast<unsigned long long>(changes), stats.inUseBytes / 1024.0,
+                        stats.peakBytes / 1024.0, stats.reservedBytes / 1024.0, stats.overflowBytes / 1024.0,
+                        stats.largeBytes / 1024.0, names.size(), residentMb(), windowS * 1e6 * perChange,
+                        stats.allocations * perChange);
+            std::fflush(stdout);
+            windowChanges = 0;
+            windowS = 0;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,200 @@
+// drift-bench: runs DriftEstimator and DriftResampler over hours of mixed
+// callbacks from a simulated SDK whose audio clock is off by a known
+// amount. Callbacks arrive late by a random amount and some are skipped,
+// like the real thing. Reports how close the estimate gets and how soon,
+// how far the samples sent stray from the wall clock with and without
+// correction, and how clean a test tone stays through the resampler (SNR
+// of each 100ms block against a fitted sine; blocks spanning a skipped
+// callback are left out).
+//
+//   drift-bench                                   4 hours at +120ppm
+//   drift-bench --hours 8 --ppm -300 --jitter-ms 8 --skip-percent 1 --seed 3
+
+#include "drift_estimator.h"
+#include "drift_resampler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr unsigned int RATE = 16000;
+constexpr size_t CHUNK = RATE / 100;     // one 10ms mixed callback, after AudioResampler
+constexpr double AMPLITUDE = 8000.0;
+constexpr double MAX_LATE_MS = 200.0;
+constexpr double CONVERGED_PPM = 5.0;    // estimate error counted as converged
+
+// Least-squares fit of a sine at a known frequency to each block of a
+// stream; what the fit leaves over is noise and distortion
+class ToneMeter {
+public:
+    static constexpr size_t BLOCK = RATE / 10;
+
+    // Samples at cyclesPerSample; a discontinuity spoils the current block
+    void push(const int16_t* samples, size_t count, double cyclesPerSample) {
+        for (size_t i = 0; i < count; i++) {
+            block_.push_back(samples[i]);
+            if (block_.size() == BLOCK) measure(cyclesPerSample);
+        }
+    }
+
+    void discontinuity() { spoiled_ = true; }
+
+    double snrDb() const { return 10 * std::log10(signal_ / std::max(residual_, 1e-9)); }
+    double worstDb() const { return worst_; }
+    size_t blocks() const { return blocks_; }
+
+private:
+    std::vector<double> block_;
+    bool spoiled_ = false;
+    double signal_ = 0;
+    double residual_ = 0;
+    double worst_ = 1e9;
+    size_t blocks_ = 0;
+
+    void measure(double cyclesPerSample) {
+        if (!spoiled_) {
+            // Normal equations for a*sin + b*cos
+            double ss = 0, cc = 0, sc = 0, ys = 0, yc = 0;
+            for (size_t i = 0; i < block_.size(); i++) {
+                double phase = 2 * M_PI * cyclesPerSample * i;
+                double s = std::sin(phase), c = std::cos(phase);
+                ss += s * s;
+                cc += c * c;
+                sc += s * c;
+                ys += block_[i] * s;
+                yc += block_[i] * c;
+            }
+            double det = ss * cc - sc * sc;
+            double a = (ys * cc - yc * sc) / det;
+            double b = (yc * ss - ys * sc) / det;
+            double signal = 0, residual = 0;
+            for (size_t i = 0; i < block_.size(); i++) {
+                double phase = 2 * M_PI * cyclesPerSample * i;
+                double fit = a * std::sin(phase) + b * std::cos(phase);
+                signal += fit * fit;
+                residual += (block_[i] - fit) * (block_[i] - fit);
+            }
+            signal_ += signal;
+            residual_ += residual;
+            worst_ = std::min(worst_, 10 * std::log10(signal / std::max(residual, 1e-9)));
+            blocks_++;
+        }
+        block_.clear();
+        spoiled_ = false;
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double hours = 4;
+    double ppm = 120;
+    double jitterMs = 3;
+    double skipPercent = 0.2;
+    unsigned int toneHz = 1000;
+    unsigned int seed = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--hours") hours = std::stod(argv[i + 1]);
+        else if (arg == "--ppm") ppm = std::stod(argv[i + 1]);
+        else if (arg == "--jitter-ms") jitterMs = std::stod(argv[i + 1]);
+        else if (arg == "--skip-percent") skipPercent = std::stod(argv[i + 1]);
+        else if (arg == "--tone") toneHz = std::stoul(argv[i + 1]);
+        else if (arg == "--seed") seed = std::stoul(argv[i + 1]);
+        else {
+            std::fprintf(stderr, "usage: %s [--hours N] [--ppm N] [--jitter-ms MS] [--skip-percent P] "
+                                 "[--tone HZ] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::exponential_distribution<double> late(jitterMs > 0 ? 1.0 / jitterMs : 1e9);
+    std::uniform_real_distribution<double> percent(0, 100);
+
+    DriftEstimator estimator(RATE);
+    DriftResampler resampler(RATE);
+    ToneMeter rawTone, correctedTone;
+
+    // The SDK produces 10ms of audio by its own clock every period seconds
+    const double period = 0.01 / (1.0 + ppm * 1e-6);
+    const auto callbacks = static_cast<uint64_t>(hours * 3600 / period);
+    const DriftEstimator::Clock::time_point base{};
+
+    std::vector<int16_t> chunk(CHUNK);
+    std::vector<int16_t> out;
+    uint64_t generated = 0, delivered = 0, lost = 0, sent = 0;
+    double lostCorrected = 0;
+    double lastArrival = 0;
+    double readyAt = -1, convergedAt = 0;
+    double maxRawMs = 0, maxCorrectedMs = 0, rawMs = 0, correctedMs = 0;
+    double processUs = 0;
+
+    for (uint64_t n = 0; n < callbacks; n++) {
+        // Tone by sample index, exact however long the run
+        for (size_t i = 0; i < CHUNK; i++) {
+            uint64_t k = (generated + i) * toneHz % RATE;
+            chunk[i] = static_cast<int16_t>(std::lround(AMPLITUDE * std::sin(2 * M_PI * k / RATE)));
+        }
+        generated += CHUNK;
+
+        double end = (n + 1) * period;  // when the frame's last sample was captured
+        if (percent(rng) < skipPercent) {
+            lost += CHUNK;
+            lostCorrected += CHUNK / (1.0 + resampler.correctionPpm() * 1e-6);
+            rawTone.discontinuity();
+            correctedTone.discontinuity();
+            continue;
+        }
+        double arrival = std::max(end + std::min(late(rng), MAX_LATE_MS) / 1000, lastArrival);
+        lastArrival = arrival;
+
+        estimator.add(base + std::chrono::duration_cast<DriftEstimator::Clock::duration>(
+                                 std::chrono::duration<double>(arrival)), CHUNK);
+        delivered += CHUNK;
+        if (estimator.ready()) {
+            if (readyAt < 0) readyAt = arrival;
+            resampler.setTarget(estimator.ppm());
+        }
+        if (!estimator.ready() || std::abs(estimator.ppm() - ppm) > CONVERGED_PPM) convergedAt = arrival;
+
+        auto t0 = std::chrono::steady_clock::now();
+        resampler.process(chunk.data(), CHUNK, out);
+        processUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        sent += out.size();
+
+        rawTone.push(chunk.data(), CHUNK, static_cast<double>(toneHz) / RATE);
+        correctedTone.push(out.data(), out.size(),
+                           toneHz * (1.0 + resampler.correctionPpm() * 1e-6) / RATE);
+
+        // Skipped audio counts as sent, as the gap concealer would fill it,
+        // for as long as it lasted by the wall clock
+        double expected = end * RATE;
+        rawMs = (delivered + lost - expected) * 1000 / RATE;
+        correctedMs = (sent + lostCorrected - expected) * 1000 / RATE;
+        maxRawMs = std::max(maxRawMs, std::abs(rawMs));
+        maxCorrectedMs = std::max(maxCorrectedMs, std::abs(correctedMs));
+    }
+
+    double audioS = callbacks * period;
+    std::printf("audio            %.1fh, clock %+.0fppm, callbacks late by %.1fms on average, %.2f%% skipped\n",
+                audioS / 3600, ppm, jitterMs, skipPercent);
+    std::printf("estimate         %+.2fppm (error %.2fppm)\n", estimator.ppm(), std::abs(estimator.ppm() - ppm));
+    if (readyAt < 0) {
+        std::printf("ready after      never (callbacks too irregular to trust a slope)\n");
+    } else {
+        std::printf("ready after      %.0fs, within %.0fppm from %.0fs on\n", readyAt, CONVERGED_PPM, convergedAt);
+    }
+    std::printf("correction       %+.2fppm applied at the end\n", resampler.correctionPpm());
+    std::printf("timeline offset  uncorrected %+.1fms at the end (max %.1fms), corrected %+.1fms (max %.1fms)\n",
+                rawMs, maxRawMs, correctedMs, maxCorrectedMs);
+    std::printf("tone %uHz SNR    input %.1fdB, corrected %.1fdB (worst 100ms block %.1fdB, %zu blocks)\n",
+                toneHz, rawTone.snrDb(), correctedTone.snrDb(), correctedTone.worstDb(), correctedTone.blocks());
+    std::printf("cpu              %.2fus per 10ms callback\n", processUs / std::max<uint64_t>(delivered / CHUNK, 1));
+    return 0;
+}
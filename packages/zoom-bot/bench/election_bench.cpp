@@ -0,0 +1,206 @@
+// election-bench: cost and accuracy of SpeakerElection with many open
+// mics. A few participants talk (bursts of voiced syllables with pauses,
+// sometimes over each other); every other stream is an open mic picking
+// them up bleedDb down, on top of its own noise floor. Frames of 10ms are
+// fed as the one-way callbacks would, and an election runs every 300ms as
+// in AudioRawDataHandler. For each stream count it reports the time per
+// election (and per stream, to show it stays linear), the energy pass per
+// frame, how many speakers each update lists, how often a bleeding mic is
+// elected or a talker missed, and for comparison how many "speakers" a
+// per-stream RMS threshold would report.
+//
+//   election-bench                                   10 to 200 streams, 2 talkers, 12dB bleed
+//   election-bench --streams 50,60 --talkers 3 --bleed-db 6 --seconds 120 --seed 2
+
+#include "speaker_election.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr unsigned int RATE = 16000;
+constexpr size_t FRAME = RATE / 100;
+constexpr uint64_t FRAME_MS = 10;
+constexpr uint64_t UPDATE_MS = 300;        // AudioRawDataHandler::SPEAKER_UPDATE_INTERVAL_MS
+constexpr double SPEECH_RMS = 200.0;       // AudioRawDataHandler::SPEECH_THRESHOLD
+constexpr size_t WINDOW_FRAMES = 50;       // election window, 500ms
+constexpr double ACTIVE_SHARE = 0.2;       // of the window, for a talker to count as talking
+constexpr double NOISE_RMS = 30.0;
+
+// One talker: bursts of 4Hz syllables on a voiced tone, with pauses
+class Talker {
+public:
+    Talker(std::mt19937& rng, double pitchHz) : rng_(rng), pitch_(pitchHz) { next(); }
+
+    // Fills one frame; returns whether any speech was on in it
+    bool frame(float* out) {
+        bool on = talking_;
+        for (size_t i = 0; i < FRAME; i++) {
+            double t = static_cast<double>(sample_++) / RATE;
+            double envelope = talking_ ? std::abs(std::sin(2 * M_PI * 4 * t)) : 0.0;
+            out[i] = static_cast<float>(
+                envelope * 4000 * (std::sin(2 * M_PI * pitch_ * t) + 0.5 * std::sin(4 * M_PI * pitch_ * t)));
+        }
+        if (--framesLeft_ == 0) next();
+        return on;
+    }
+
+private:
+    std::mt19937& rng_;
+    double pitch_;
+    uint64_t sample_ = 0;
+    bool talking_ = false;
+    int framesLeft_ = 1;
+
+    void next() {
+        talking_ = !talking_;
+        std::uniform_int_distribution<int> burst(talking_ ? 30 : 20, talking_ ? 300 : 200);
+        framesLeft_ = burst(rng_);
+    }
+};
+
+struct Result {
+    double electP50Us = 0;
+    double electMaxUs = 0;
+    double energyUs = 0;       // per frame
+    double speakers = 0;       // per update
+    double bleedPercent = 0;   // of updates electing a stream that was not talking
+    double missedPercent = 0;  // of talkers active in the window but not elected
+    double naiveSpeakers = 0;  // per update, by a per-stream threshold
+};
+
+Result run(size_t streams, size_t talkers, double bleedDb, double seconds, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, static_cast<float>(NOISE_RMS));
+    talkers = std::min(talkers, streams);
+    std::vector<Talker> voices;
+    for (size_t k = 0; k < talkers; k++) voices.emplace_back(rng, 110.0 + 45.0 * k);
+
+    const float bleed = static_cast<float>(std::pow(10.0, -bleedDb / 20.0));
+    SpeakerElection election(SPEECH_RMS);
+
+    std::vector<std::vector<float>> speech(talkers, std::vector<float>(FRAME));
+    std::vector<float> sum(FRAME);
+    std::vector<int16_t> frame(FRAME);
+    std::vector<std::vector<bool>> on(talkers, std::vector<bool>(WINDOW_FRAMES));
+    std::vector<double> naiveEnergy(streams, 0.0);
+
+    std::vector<double> electUs;
+    double energyS = 0;
+    uint64_t frames = 0, updates = 0, elected = 0, bleedUpdates = 0, active = 0, missed = 0, naive = 0;
+
+    auto ticks = static_cast<uint64_t>(seconds * 1000 / FRAME_MS);
+    for (uint64_t t = 0; t < ticks; t++) {
+        uint64_t nowMs = t * FRAME_MS;
+        std::fill(sum.begin(), sum.end(), 0.0f);
+        for (size_t k = 0; k < talkers; k++) {
+            on[k][t % WINDOW_FRAMES] = voices[k].frame(speech[k].data());
+            for (size_t i = 0; i < FRAME; i++) sum[i] += speech[k][i];
+        }
+
+        // Talkers are the first streams; everyone hears everyone else's voice
+        for (size_t s = 0; s < streams; s++) {
+            for (size_t i = 0; i < FRAME; i++) {
+                float own = s < talkers ? speech[s][i] : 0.0f;
+                float v = own + bleed * (sum[i] - own) + noise(rng);
+                frame[i] = static_cast<int16_t>(std::clamp(v, -32768.0f, 32767.0f));
+            }
+            auto t0 = std::chrono::steady_clock::now();
+            float energy = SpeakerElection::energy(frame.data(), FRAME);
+            energyS += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            election.addEnergy(static_cast<uint32_t>(s + 1), energy, FRAME, nowMs);
+            naiveEnergy[s] += energy;
+            frames++;
+        }
+
+        if (nowMs == 0 || nowMs % UPDATE_MS != 0) continue;
+        auto t0 = std::chrono::steady_clock::now();
+        auto speakers = election.elect(nowMs);
+        electUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+
+        updates++;
+        elected += speakers.size();
+        bool bleedElected = false;
+        std::vector<bool> found(talkers, false);
+        for (const auto& c : speakers) {
+            size_t s = c.userId - 1;
+            if (s < talkers) found[s] = true;
+            else bleedElected = true;
+        }
+        bleedUpdates += bleedElected;
+        for (size_t k = 0; k < talkers; k++) {
+            size_t frameOn = static_cast<size_t>(std::count(on[k].begin(), on[k].end(), true));
+            if (frameOn < ACTIVE_SHARE * WINDOW_FRAMES) continue;
+            active++;
+            if (!found[k]) missed++;
+        }
+
+        // A per-stream threshold on the RMS since the last update
+        double frameCount = static_cast<double>(UPDATE_MS / FRAME_MS) * FRAME;
+        for (size_t s = 0; s < streams; s++) {
+            if (std::sqrt(naiveEnergy[s] / frameCount) > SPEECH_RMS) naive++;
+            naiveEnergy[s] = 0.0;
+        }
+    }
+
+    Result r;
+    if (!electUs.empty()) {
+        std::sort(electUs.begin(), electUs.end());
+        r.electP50Us = electUs[electUs.size() / 2];
+        r.electMaxUs = electUs.back();
+    }
+    r.energyUs = frames ? energyS * 1e6 / frames : 0;
+    r.speakers = updates ? static_cast<double>(elected) / updates : 0;
+    r.bleedPercent = updates ? 100.0 * bleedUpdates / updates : 0;
+    r.missedPercent = active ? 100.0 * missed / active : 0;
+    r.naiveSpeakers = updates ? static_cast<double>(naive) / updates : 0;
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> streamCounts = {10, 25, 50, 100, 200};
+    size_t talkers = 2;
+    double bleedDb = 12;
+    double seconds = 60;
+    unsigned int seed = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--streams") {
+            streamCounts.clear();
+            std::stringstream ss(argv[i + 1]);
+            std::string item;
+            while (std::getline(ss, item, ',')) {
+                if (!item.empty()) streamCounts.push_back(std::stoul(item));
+            }
+        } else if (arg == "--talkers") talkers = std::stoul(argv[i + 1]);
+        else if (arg == "--bleed-db") bleedDb = std::stod(argv[i + 1]);
+        else if (arg == "--seconds") seconds = std::stod(argv[i + 1]);
+        else if (arg == "--seed") seed = std::stoul(argv[i + 1]);
+        else {
+            std::fprintf(stderr, "usage: %s [--streams N,N,...] [--talkers N] [--bleed-db DB] [--seconds N] "
+                                 "[--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("meeting          %zu talkers, open mics %.0fdB down, %.0fs per stream count\n", talkers, bleedDb,
+                seconds);
+    std::printf("%-8s %11s %11s %10s %12s %9s %8s %8s %8s\n", "streams", "elect p50", "elect max", "per stream",
+                "energy/frame", "speakers", "bleed", "missed", "naive");
+    for (size_t streams : streamCounts) {
+        if (streams == 0) continue;
+        Result r = run(streams, talkers, bleedDb, seconds, seed);
+        std::printf("%-8zu %9.1fus %9.1fus %8.2fus %10.2fus %9.2f %7.1f%% %7.1f%% %8.2f\n", streams, r.electP50Us,
+                    r.electMaxUs, r.electP50Us / streams, r.energyUs, r.speakers, r.bleedPercent, r.missedPercent,
+                    r.naiveSpeakers);
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+// frame-bench: sends the mixed audio of many simulated meetings through
+// FrameAggregator for each ZOOM_BOT_FRAME_MS setting, in real time. Every
+// meeting gets a 10ms callback per tick, and now and then a pause long
+// enough for the latency timer to flush a partial frame. Frames are
+// written as masked WebSocket binary frames to a local socket, with a
+// reader thread draining the other end, so per-frame costs on both sides
+// are counted. Reports frames/s per meeting, process CPU, and the latency
+// framing adds (how long a frame's first sample waited).
+//
+//   frame-bench                                  20 meetings, 5s per setting
+//   frame-bench --meetings 100 --seconds 10 --max-latency-ms 60 --pause-percent 1
+
+#include "frame_aggregator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr unsigned int RATE = 16000;
+constexpr size_t CALLBACK_SAMPLES = RATE / 100;
+constexpr unsigned int FRAME_MS[] = {10, 20, 40, 50, 60, 100};
+constexpr int PAUSE_MS = 250;  // SDK callbacks stop for this long
+
+double cpuSeconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+// One meeting's connection: the sink frames and masks the audio as a
+// WebSocket client does and writes it to one end of a socket pair
+class Connection {
+public:
+    Connection() {
+        socketpair(AF_UNIX, SOCK_STREAM, 0, fds_);
+        frame_.reserve(RATE * 2 + 14);
+    }
+    ~Connection() {
+        close(fds_[0]);
+        close(fds_[1]);
+    }
+
+    int readFd() const { return fds_[1]; }
+
+    void send(const int16_t* samples, size_t count) {
+        size_t length = count * sizeof(int16_t);
+        frame_.clear();
+        frame_.push_back(0x82);  // FIN, binary
+        if (length < 126) {
+            frame_.push_back(static_cast<uint8_t>(0x80 | length));
+        } else {
+            frame_.push_back(0x80 | 126);
+            frame_.push_back(static_cast<uint8_t>(length >> 8));
+            frame_.push_back(static_cast<uint8_t>(length));
+        }
+        uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+        frame_.insert(frame_.end(), mask, mask + 4);
+        const auto* bytes = reinterpret_cast<const uint8_t*>(samples);
+        for (size_t i = 0; i < length; i++) frame_.push_back(bytes[i] ^ mask[i & 3]);
+
+        const uint8_t* p = frame_.data();
+        size_t left = frame_.size();
+        while (left > 0) {
+            ssize_t n = write(fds_[0], p, left);
+            if (n <= 0) return;
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+    }
+
+private:
+    int fds_[2];
+    std::vector<uint8_t> frame_;
+};
+
+struct Result {
+    double framesPerS = 0;
+    double partialPercent = 0;
+    double cpuPercent = 0;
+    double meanLatencyMs = 0;
+    double maxLatencyMs = 0;
+};
+
+Result runSetting(unsigned int frameMs, unsigned int maxLatencyMs, size_t meetings, double seconds,
+                  double pausePercent, unsigned int seed) {
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::vector<std::unique_ptr<FrameAggregator>> aggregators;
+    for (size_t m = 0; m < meetings; m++) {
+        connections.push_back(std::make_unique<Connection>());
+        Connection* connection = connections.back().get();
+        aggregators.push_back(std::make_unique<FrameAggregator>(
+            RATE, frameMs, maxLatencyMs,
+            [connection](const int16_t* samples, size_t count) { connection->send(samples, count); }));
+    }
+
+    std::atomic<bool> running{true};
+
+    // The gateway end: drain every socket as data arrives
+    std::thread reader([&] {
+        std::vector<pollfd> fds;
+        for (auto& c : connections) fds.push_back({c->readFd(), POLLIN, 0});
+        std::vector<char> buffer(64 * 1024);
+        while (running) {
+            if (poll(fds.data(), fds.size(), 20) <= 0) continue;
+            for (auto& fd : fds) {
+                if (fd.revents & POLLIN) {
+                    if (read(fd.fd, buffer.data(), buffer.size()) < 0) break;
+                }
+            }
+        }
+    });
+
+    // The main loop's flush timer, at the same period as ZoomSDKManager's
+    std::thread flusher([&] {
+        auto period = std::chrono::milliseconds(std::max(5u, maxLatencyMs / 2));
+        auto next = std::chrono::steady_clock::now();
+        while (running) {
+            next += period;
+            std::this_thread::sleep_until(next);
+            for (auto& a : aggregators) a->flushStale();
+        }
+    });
+
+    // The SDK audio thread: one 10ms callback per meeting per tick
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> percent(0, 100);
+    std::vector<int16_t> chunk(CALLBACK_SAMPLES);
+    for (size_t i = 0; i < chunk.size(); i++) chunk[i] = static_cast<int16_t>(i * 37);
+    std::vector<int> pausedTicks(meetings, 0);
+
+    double cpu0 = cpuSeconds();
+    auto start = std::chrono::steady_clock::now();
+    auto next = start;
+    auto ticks = static_cast<uint64_t>(seconds * 100);
+    for (uint64_t t = 0; t < ticks; t++) {
+        next += std::chrono::milliseconds(10);
+        std::this_thread::sleep_until(next);
+        for (size_t m = 0; m < meetings; m++) {
+            if (pausedTicks[m] > 0) {
+                pausedTicks[m]--;
+                continue;
+            }
+            if (percent(rng) < pausePercent) {
+                pausedTicks[m] = PAUSE_MS / 10;
+                continue;
+            }
+            aggregators[m]->push(chunk.data(), chunk.size());
+        }
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    running = false;
+    flusher.join();
+    reader.join();
+    double cpu = cpuSeconds() - cpu0;
+
+    Result result;
+    uint64_t frames = 0, partial = 0;
+    double latencySum = 0;
+    for (auto& a : aggregators) {
+        FrameAggregator::Stats stats = a->takeStats();
+        frames += stats.frames;
+        partial += stats.partialFrames;
+        latencySum += stats.meanLatencyMs * stats.frames;
+        result.maxLatencyMs = std::max(result.maxLatencyMs, stats.maxLatencyMs);
+    }
+    result.framesPerS = frames / wall / meetings;
+    result.partialPercent = frames ? 100.0 * partial / frames : 0;
+    result.cpuPercent = 100 * cpu / wall;
+    result.meanLatencyMs = frames ? latencySum / frames : 0;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t meetings = 20;
+    double seconds = 5;
+    unsigned int maxLatencyMs = 100;
+    double pausePercent = 0.2;
+    unsigned int seed = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--meetings") meetings = std::stoul(argv[i + 1]);
+        else if (arg == "--seconds") seconds = std::stod(argv[i + 1]);
+        else if (arg == "--max-latency-ms") maxLatencyMs = std::stoul(argv[i + 1]);
+        else if (arg == "--pause-percent") pausePercent = std::stod(argv[i + 1]);
+        else if (arg == "--seed") seed = std::stoul(argv[i + 1]);
+        else {
+            std::fprintf(stderr, "usage: %s [--meetings N] [--seconds N] [--max-latency-ms MS] "
+                                 "[--pause-percent P] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (meetings == 0) meetings = 1;
+
+    std::printf("meetings         %zu, %.0fs per setting, max latency %ums, %.2f%% of callbacks start a %dms pause\n",
+                meetings, seconds, maxLatencyMs, pausePercent, PAUSE_MS);
+    std::printf("%-9s %10s %9s %8s %17s %17s\n", "frame ms", "frames/s", "partial", "cpu", "mean latency ms",
+                "max latency ms");
+    for (unsigned int frameMs : FRAME_MS) {
+        Result r = runSetting(frameMs, maxLatencyMs, meetings, seconds, pausePercent, seed);
+        std::printf("%-9u %10.1f %8.1f%% %7.1f%% %17.1f %17.1f\n", frameMs, r.framesPerS, r.partialPercent,
+                    r.cpuPercent, r.meanLatencyMs, r.maxLatencyMs);
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+// jitter-bench: callback-to-send latency of the audio path next to
+// CPU-bound neighbours, without and then with a threading profile. An
+// "audio" thread is woken every 10ms, as the SDK would call back, and
+// resamples 32kHz stereo to 16kHz into a FrameAggregator; each completed
+// frame is queued to a "network" thread that writes it to a local socket.
+// Latency runs from when the callback was due to when its frame was
+// written, so it includes waking both threads. Reports p50/p99/max for
+// each run, as audio.callback_us_* does in [Metrics].
+//
+//   jitter-bench                                     SCHED_FIFO 10, 10s per run
+//   jitter-bench --neighbours 8 --audio-cpus 2 --network-cpus 3 --policy rr --priority 20
+
+#include "audio_resampler.h"
+#include "frame_aggregator.h"
+#include "latency_recorder.h"
+#include "thread_profile.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr unsigned int SDK_RATE = 32000;
+constexpr unsigned int CHANNELS = 2;
+constexpr size_t CALLBACK_FRAMES = SDK_RATE / 100;
+
+struct Options {
+    double seconds = 10;
+    unsigned int neighbours = 0;  // 0: one per core
+    unsigned int frameMs = 10;
+    std::string audioCpus;
+    std::string networkCpus;
+    std::string policy = "fifo";
+    int priority = 10;
+};
+
+// A frame handed from the audio thread to the network thread
+struct Frame {
+    std::vector<int16_t> samples;
+    Clock::time_point due;  // when the callback that completed it was due
+};
+
+LatencyRecorder::Summary runOnce(const Options& options, bool withProfile) {
+    ThreadProfile audioProfile, networkProfile;
+    if (withProfile) {
+        audioProfile = ThreadProfile::parse(options.audioCpus, options.policy, options.priority);
+        networkProfile = ThreadProfile::parse(options.networkCpus, options.policy, options.priority);
+    }
+
+    std::atomic<bool> running{true};
+    unsigned int neighbours = options.neighbours ? options.neighbours
+                                                 : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> spinners;
+    for (unsigned int i = 0; i < neighbours; i++) {
+        spinners.emplace_back([&running] {
+            volatile uint64_t x = 0;
+            while (running) x = x + 1;
+        });
+    }
+
+    int fds[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    std::thread drain([&running, fd = fds[1]] {
+        std::vector<char> buffer(64 * 1024);
+        while (running && read(fd, buffer.data(), buffer.size()) > 0) {}
+    });
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Frame> queue;
+    LatencyRecorder latency;
+
+    std::thread network([&] {
+        networkProfile.applyToCurrentThread("network");
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running || !queue.empty()) {
+            ready.wait_for(lock, std::chrono::milliseconds(50), [&] { return !running || !queue.empty(); });
+            while (!queue.empty()) {
+                Frame frame = std::move(queue.front());
+                queue.pop_front();
+                lock.unlock();
+                const char* p = reinterpret_cast<const char*>(frame.samples.data());
+                size_t left = frame.samples.size() * sizeof(int16_t);
+                while (left > 0) {
+                    ssize_t n = write(fds[0], p, left);
+                    if (n <= 0) break;
+                    p += n;
+                    left -= static_cast<size_t>(n);
+                }
+                latency.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - frame.due).count()));
+                lock.lock();
+            }
+        }
+    });
+
+    std::thread audio([&] {
+        audioProfile.applyToCurrentThread("audio");
+        AudioResampler resampler;
+        std::vector<int16_t> input(CALLBACK_FRAMES * CHANNELS);
+        std::vector<int16_t> resampled;
+        Clock::time_point due;
+        FrameAggregator aggregator(AudioResampler::OUTPUT_SAMPLE_RATE, options.frameMs, 1000,
+                                   [&](const int16_t* samples, size_t count) {
+                                       Frame frame{std::vector<int16_t>(samples, samples + count), due};
+                                       std::lock_guard<std::mutex> lock(mutex);
+                                       queue.push_back(std::move(frame));
+                                       ready.notify_one();
+                                   });
+
+        auto ticks = static_cast<uint64_t>(options.seconds * 100);
+        due = Clock::now();
+        for (uint64_t t = 0; t < ticks; t++) {
+            due += std::chrono::milliseconds(10);
+            std::this_thread::sleep_until(due);
+            for (size_t i = 0; i < input.size(); i++) {
+                input[i] = static_cast<int16_t>(8000 * std::sin(0.05 * (t * input.size() + i)));
+            }
+            resampler.resample(reinterpret_cast<const char*>(input.data()),
+                               static_cast<unsigned int>(input.size() * sizeof(int16_t)), SDK_RATE, CHANNELS,
+                               AudioResampler::ChannelMode::Mix, resampled);
+            aggregator.push(resampled.data(), resampled.size());
+        }
+    });
+
+    audio.join();
+    running = false;
+    ready.notify_one();
+    network.join();
+    for (auto& spinner : spinners) spinner.join();
+    shutdown(fds[0], SHUT_RDWR);
+    drain.join();
+    close(fds[0]);
+    close(fds[1]);
+    return latency.take();
+}
+
+void print(const char* label, const LatencyRecorder::Summary& s) {
+    std::printf("%-17s p50 %.0fus, p99 %.0fus, max %.0fus (%llu frames)\n", label, s.p50Us, s.p99Us, s.maxUs,
+                static_cast<unsigned long long>(s.count));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--seconds") options.seconds = std::stod(argv[i + 1]);
+        else if (arg == "--neighbours") options.neighbours = std::stoul(argv[i + 1]);
+        else if (arg == "--frame-ms") options.frameMs = std::stoul(argv[i + 1]);
+        else if (arg == "--audio-cpus") options.audioCpus = argv[i + 1];
+        else if (arg == "--network-cpus") options.networkCpus = argv[i + 1];
+        else if (arg == "--policy") options.policy = argv[i + 1];
+        else if (arg == "--priority") options.priority = std::stoi(argv[i + 1]);
+        else {
+            std::fprintf(stderr, "usage: %s [--seconds N] [--neighbours N] [--frame-ms MS] [--audio-cpus LIST] "
+                                 "[--network-cpus LIST] [--policy fifo|rr|none] [--priority N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    unsigned int neighbours = options.neighbours ? options.neighbours
+                                                 : std::max(1u, std::thread::hardware_concurrency());
+    std::printf("setup            %u CPU-bound neighbours, %ums frames, %.0fs per run\n", neighbours,
+                options.frameMs, options.seconds);
+    print("no profile", runOnce(options, false));
+    print("with profile", runOnce(options, true));
+    return 0;
+}
@@ -0,0 +1,224 @@
+// speaker-change-bench: runs SpeakerChangeDetector over a synthetic meeting
+// and reports what it costs and how well it finds the turns. Speakers are
+// formant-synthesised voices (their own pitch and vocal-tract length,
+// random vowels, syllable rhythm and pauses) taking turns, fed in 10ms
+// chunks like the mixed callback. CPU is the share of one core per
+// meeting; latency runs from the true turn start to the report.
+//
+//   speaker-change-bench                        10 minutes, 3 speakers
+//   speaker-change-bench --minutes 60 --speakers 5 --noise 100 --seed 7
+
+#include "speaker_change_detector.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr unsigned int RATE = SpeakerChangeDetector::SAMPLE_RATE;
+constexpr size_t CHUNK = RATE / 100;            // one 10ms mixed callback
+constexpr double SPEECH_RMS = 200.0;            // as in AudioRawDataHandler
+constexpr uint64_t MATCH_MS = 250;              // a report this close to a turn start finds it
+
+struct Voice {
+    double f0;          // Hz
+    double tract;       // formant scale (shorter tract, higher formants)
+    double level;       // RMS
+};
+
+// Two-pole resonator at one formant
+struct Resonator {
+    double a1 = 0, a2 = 0, gain = 0, y1 = 0, y2 = 0;
+
+    void tune(double hz, double bandwidth) {
+        double r = std::exp(-M_PI * bandwidth / RATE);
+        a1 = 2 * r * std::cos(2 * M_PI * hz / RATE);
+        a2 = -r * r;
+        gain = 1 - r;
+    }
+    double step(double x) {
+        double y = gain * x + a1 * y1 + a2 * y2;
+        y2 = y1;
+        y1 = y;
+        return y;
+    }
+};
+
+const double VOWELS[][3] = {
+    {730, 1090, 2440}, {270, 2290, 3010}, {300, 870, 2240}, {530, 1840, 2480}, {570, 840, 2410},
+};
+
+class Meeting {
+public:
+    Meeting(size_t speakers, double noiseRms, unsigned int seed) : rng_(seed), noise_(0.0, noiseRms) {
+        std::uniform_real_distribution<double> f0(90, 240), tract(0.85, 1.2), level(1000, 5000);
+        for (size_t i = 0; i < speakers; i++) voices_.push_back({f0(rng_), tract(rng_), level(rng_)});
+    }
+
+    // Appends one turn of the next speaker (never the current one) and
+    // returns the sample where its speech starts
+    uint64_t turn(std::vector<int16_t>& out) {
+        size_t next = current_;
+        while (voices_.size() > 1 && next == current_) {
+            next = std::uniform_int_distribution<size_t>(0, voices_.size() - 1)(rng_);
+        }
+        current_ = next;
+        const Voice& v = voices_[current_];
+
+        pause(out, std::uniform_int_distribution<size_t>(0, 300)(rng_));
+        uint64_t start = out.size();
+        size_t turnMs = std::uniform_int_distribution<size_t>(1500, 6000)(rng_);
+        while ((out.size() - start) * 1000 / RATE < turnMs) {
+            syllable(out, v, std::uniform_int_distribution<size_t>(120, 280)(rng_));
+            pause(out, std::uniform_int_distribution<size_t>(20, 120)(rng_));
+        }
+        return start;
+    }
+
+    const std::vector<Voice>& voices() const { return voices_; }
+
+private:
+    std::mt19937 rng_;
+    std::normal_distribution<double> noise_;
+    std::vector<Voice> voices_;
+    size_t current_ = SIZE_MAX;
+    double phase_ = 0;
+
+    void pause(std::vector<int16_t>& out, size_t ms) {
+        for (size_t i = 0; i < ms * RATE / 1000; i++) out.push_back(clip(noise_(rng_)));
+    }
+
+    void syllable(std::vector<int16_t>& out, const Voice& v, size_t ms) {
+        const double* f = VOWELS[std::uniform_int_distribution<size_t>(0, 4)(rng_)];
+        Resonator formants[3];
+        for (int i = 0; i < 3; i++) formants[i].tune(f[i] * v.tract, 60 + 40 * i);
+
+        size_t n = ms * RATE / 1000;
+        double glide = std::uniform_real_distribution<double>(-0.15, 0.15)(rng_);
+        std::vector<double> voiced(n);
+        double sumSquares = 0;
+        for (size_t i = 0; i < n; i++) {
+            phase_ += v.f0 * (1 + glide * i / n) / RATE;
+            double y = 0;
+            if (phase_ >= 1) {
+                phase_ -= 1;
+                y = 1;
+            }
+            for (auto& r : formants) y = r.step(y);
+            voiced[i] = y;
+            sumSquares += y * y;
+        }
+
+        // Scaled to the voice's level, under a rise-and-fall envelope
+        double scale = v.level / std::sqrt(std::max(sumSquares / n, 1e-30));
+        for (size_t i = 0; i < n; i++) {
+            double envelope = 0.5 - 0.5 * std::cos(2 * M_PI * i / n);
+            out.push_back(clip(voiced[i] * scale * envelope + noise_(rng_)));
+        }
+    }
+
+    static int16_t clip(double x) {
+        return static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, x)));
+    }
+};
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double minutes = 10;
+    size_t speakers = 3;
+    double noiseRms = 30;
+    unsigned int seed = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--minutes") minutes = std::stod(argv[i + 1]);
+        else if (arg == "--speakers") speakers = std::stoul(argv[i + 1]);
+        else if (arg == "--noise") noiseRms = std::stod(argv[i + 1]);
+        else if (arg == "--seed") seed = std::stoul(argv[i + 1]);
+        else {
+            std::fprintf(stderr, "usage: %s [--minutes N] [--speakers N] [--noise RMS] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Meeting meeting(std::max<size_t>(speakers, 2), noiseRms, seed);
+    std::vector<int16_t> audio;
+    std::vector<uint64_t> turns;
+    while (audio.size() < minutes * 60 * RATE) turns.push_back(meeting.turn(audio));
+
+    SpeakerChangeDetector detector(SPEECH_RMS);
+    std::vector<SpeakerChangeDetector::Change> changes;
+    std::vector<uint64_t> reported;   // boundary sample
+    std::vector<uint64_t> reportedAt; // sample count when reported
+    std::vector<double> chunkUs;
+    chunkUs.reserve(audio.size() / CHUNK + 1);
+
+    using Clock = std::chrono::steady_clock;
+    auto started = Clock::now();
+    for (size_t pos = 0; pos < audio.size(); pos += CHUNK) {
+        size_t n = std::min(CHUNK, audio.size() - pos);
+        auto t0 = Clock::now();
+        changes.clear();
+        detector.push(audio.data() + pos, n, changes);
+        chunkUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+        for (const auto& c : changes) {
+            reported.push_back(pos + n - c.samplesAgo);
+            reportedAt.push_back(pos + n);
+        }
+    }
+    double elapsedS = std::chrono::duration<double>(Clock::now() - started).count();
+    double audioS = static_cast<double>(audio.size()) / RATE;
+
+    // Each turn after the first is found by the nearest unused report
+    size_t found = 0;
+    std::vector<bool> used(reported.size(), false);
+    std::vector<double> latencyMs;
+    std::vector<double> errorMs;
+    for (size_t t = 1; t < turns.size(); t++) {
+        size_t best = SIZE_MAX;
+        uint64_t bestDistance = MATCH_MS * RATE / 1000 + 1;
+        for (size_t r = 0; r < reported.size(); r++) {
+            if (used[r]) continue;
+            uint64_t d = reported[r] > turns[t] ? reported[r] - turns[t] : turns[t] - reported[r];
+            if (d < bestDistance) {
+                bestDistance = d;
+                best = r;
+            }
+        }
+        if (best == SIZE_MAX) continue;
+        used[best] = true;
+        found++;
+        latencyMs.push_back((static_cast<double>(reportedAt[best]) - turns[t]) * 1000 / RATE);
+        errorMs.push_back(static_cast<double>(bestDistance) * 1000 / RATE);
+    }
+    size_t boundaries = turns.size() - 1;
+    size_t falseAlarms = reported.size() - found;
+
+    std::printf("audio            %.0fs, %zu speakers, %zu turn changes\n", audioS, speakers, boundaries);
+    std::printf("voices          ");
+    for (const auto& v : meeting.voices()) std::printf(" %.0fHz/x%.2f", v.f0, v.tract);
+    std::printf("\n");
+    std::printf("cpu              %.3f%% of one core per meeting (%.1fms per second of audio)\n",
+                100.0 * elapsedS / audioS, 1000.0 * elapsedS / audioS);
+    std::printf("per 10ms chunk   p50 %.1fus  p99 %.1fus  max %.1fus\n",
+                percentile(chunkUs, 0.5), percentile(chunkUs, 0.99), percentile(chunkUs, 1.0));
+    std::printf("recall           %.1f%% (%zu of %zu within %llums)\n",
+                boundaries ? 100.0 * found / boundaries : 0.0, found, boundaries,
+                static_cast<unsigned long long>(MATCH_MS));
+    std::printf("false alarms     %zu (%.1f per minute)\n", falseAlarms, falseAlarms * 60.0 / audioS);
+    std::printf("boundary error   p50 %.0fms  p90 %.0fms\n", percentile(errorMs, 0.5), percentile(errorMs, 0.9));
+    std::printf("report latency   p50 %.0fms  p90 %.0fms  max %.0fms (from turn start)\n",
+                percentile(latencyMs, 0.5), percentile(latencyMs, 0.9), percentile(latencyMs, 1.0));
+    return 0;
+}
@@ -0,0 +1,575 @@
+// Fake Zoom Meeting SDK for offline load testing.
+//
+// Implements the subset of the SDK declared in fake_sdk/h and simulates a
+// meeting: N participants with synthetic speech taking turns (and sometimes
+// talking over each other), optional join/leave churn, and optionally
+// skipped mixed-audio callbacks. Control callbacks (auth, meeting status,
+// roster changes) are dispatched on the GLib main loop like the real SDK;
+// raw audio is delivered from a dedicated thread every 10 ms.
+//
+// Configured from the environment:
+//   FAKE_ZOOM_PARTICIPANTS       participants in the meeting (default 5)
+//   FAKE_ZOOM_SAMPLE_RATE        raw audio sample rate in Hz (default 32000)
+//   FAKE_ZOOM_CHURN_MS           interval between a leave and a join, 0 = none (default 0)
+//   FAKE_ZOOM_JOIN_BURST         muted participants joining all at once a second into
+//                                the meeting, one onUserJoin each (default 0)
+//   FAKE_ZOOM_SKIP_PERCENT       percentage of mixed callbacks dropped (default 0)
+//   FAKE_ZOOM_RECORDING_DENIALS  CanStartRawRecording failures before success (default 0)
+//   FAKE_ZOOM_BLEED_DB           other talkers leak into each one-way stream this many
+//                                dB down, like open mics in one room, 0 = none (default 0)
+//   FAKE_ZOOM_CLOCK_PPM          audio clock runs this many ppm fast, or slow if
+//                                negative, against the wall clock (default 0)
+//   FAKE_ZOOM_SEED               random seed (default 1)
+
+#include "zoom_sdk.h"
+#include "rawdata/zoom_rawdata_api.h"
+#include <glib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ZOOM_SDK_NAMESPACE {
+namespace {
+
+unsigned int envUInt(const char* key, unsigned int defaultVal) {
+    const char* val = std::getenv(key);
+    return val ? static_cast<unsigned int>(std::strtoul(val, nullptr, 10)) : defaultVal;
+}
+
+int envInt(const char* key, int defaultVal) {
+    const char* val = std::getenv(key);
+    return val ? static_cast<int>(std::strtol(val, nullptr, 10)) : defaultVal;
+}
+
+struct FakeConfig {
+    unsigned int participants = 5;
+    unsigned int sampleRate = 32000;
+    unsigned int churnMs = 0;
+    unsigned int joinBurst = 0;
+    unsigned int skipPercent = 0;
+    unsigned int recordingDenials = 0;
+    unsigned int bleedDb = 0;
+    int clockPpm = 0;
+    unsigned int seed = 1;
+};
+
+FakeConfig g_config;
+
+// Run fn on the GLib main loop after delayMs
+void post(std::function<void()> fn, guint delayMs = 0) {
+    auto* task = new std::function<void()>(std::move(fn));
+    g_timeout_add(delayMs, [](gpointer data) -> gboolean {
+        auto* t = static_cast<std::function<void()>*>(data);
+        (*t)();
+        delete t;
+        return FALSE;
+    }, task);
+}
+
+class FakeUserList : public IList<unsigned int> {
+public:
+    explicit FakeUserList(std::vector<unsigned int> ids) : ids_(std::move(ids)) {}
+    int GetCount() override { return static_cast<int>(ids_.size()); }
+    unsigned int GetItem(int index) override { return ids_.at(index); }
+
+private:
+    std::vector<unsigned int> ids_;
+};
+
+class FakeUserInfo : public IUserInfo {
+public:
+    FakeUserInfo(unsigned int id, std::string name) : id_(id), name_(std::move(name)) {}
+    const zchar_t* GetUserName() override { return name_.c_str(); }
+    unsigned int GetUserID() override { return id_; }
+
+private:
+    unsigned int id_;
+    std::string name_;
+};
+
+class FakeAudioRawData : public AudioRawData {
+public:
+    FakeAudioRawData(int16_t* samples, unsigned int count, unsigned int rate, unsigned int channels)
+        : samples_(samples), count_(count), rate_(rate), channels_(channels) {}
+    bool CanAddRef() override { return false; }
+    bool AddRef() override { return false; }
+    int Release() override { return 0; }
+    char* GetBuffer() override { return reinterpret_cast<char*>(samples_); }
+    unsigned int GetBufferLen() override { return count_ * sizeof(int16_t); }
+    unsigned int GetSampleRate() override { return rate_; }
+    unsigned int GetChannelNum() override { return channels_; }
+
+private:
+    int16_t* samples_;
+    unsigned int count_;
+    unsigned int rate_;
+    unsigned int channels_;
+};
+
+// One cycle of a harmonic-rich, voice-like waveform; speech is synthesized
+// by stepping through it at each participant's pitch (one lookup per sample)
+class Wavetable {
+public:
+    static constexpr size_t SIZE = 1024;
+
+    Wavetable() {
+        for (size_t i = 0; i < SIZE; i++) {
+            double phase = 2.0 * M_PI * i / SIZE;
+            double v = 0.0;
+            for (int k = 1; k <= 8; k++) v += std::sin(k * phase) / k;
+            table_[i] = static_cast<float>(v / 2.0);
+        }
+    }
+    float at(double phase) const { return table_[static_cast<size_t>(phase * SIZE) % SIZE]; }
+
+private:
+    float table_[SIZE];
+};
+
+struct SimParticipant {
+    unsigned int userId;
+    std::unique_ptr<FakeUserInfo> info;
+    double pitchHz;
+    float gainLeft;
+    float gainRight;
+    double phase = 0.0;
+    double syllablePhase = 0.0;
+    bool talking = false;
+    bool muted = false;       // no audio stream at all
+    uint64_t nextToggle = 0;  // sample index of the next talk/silence switch
+};
+
+// Shared meeting state; posted callbacks hold a weak reference so nothing
+// fires after the meeting service has been destroyed
+class FakeMeeting : public std::enable_shared_from_this<FakeMeeting> {
+public:
+    explicit FakeMeeting(const FakeConfig& config) : config_(config), rng_(config.seed) {}
+
+    ~FakeMeeting() {
+        stopAudio();
+        if (churnSource_) g_source_remove(churnSource_);
+    }
+
+    void setServiceEvent(IMeetingServiceEvent* e) { serviceEvent_ = e; }
+    void setParticipantsEvent(IMeetingParticipantsCtrlEvent* e) { participantsEvent_ = e; }
+
+    void join(bool stereo) {
+        channels_ = stereo ? 2 : 1;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (unsigned int i = 0; i < config_.participants; i++) addLocked();
+        }
+        std::weak_ptr<FakeMeeting> weak = shared_from_this();
+        post([weak] { if (auto m = weak.lock()) m->setStatus(MEETING_STATUS_CONNECTING); }, 50);
+        post([weak] { if (auto m = weak.lock()) m->setStatus(MEETING_STATUS_INMEETING); }, 300);
+        if (config_.joinBurst > 0) {
+            post([weak] { if (auto m = weak.lock()) m->joinBurst(); }, 1300);
+        }
+        if (config_.churnMs > 0) {
+            churnSource_ = g_timeout_add(config_.churnMs, [](gpointer data) -> gboolean {
+                static_cast<FakeMeeting*>(data)->churn();
+                return TRUE;
+            }, this);
+        }
+    }
+
+    void leave() {
+        stopAudio();
+        if (churnSource_) {
+            g_source_remove(churnSource_);
+            churnSource_ = 0;
+        }
+        std::weak_ptr<FakeMeeting> weak = shared_from_this();
+        post([weak] { if (auto m = weak.lock()) m->setStatus(MEETING_STATUS_ENDED); });
+    }
+
+    std::vector<unsigned int> userIds() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<unsigned int> ids;
+        for (const auto& [id, p] : roster_) ids.push_back(id);
+        return ids;
+    }
+
+    IUserInfo* user(unsigned int userId) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = roster_.find(userId);
+        return it != roster_.end() ? it->second.info.get() : nullptr;
+    }
+
+    bool allowRecording() {
+        if (recordingDenials_ < config_.recordingDenials) {
+            recordingDenials_++;
+            return false;
+        }
+        return true;
+    }
+
+    void startAudio(IZoomSDKAudioRawDataDelegate* delegate) {
+        stopAudio();
+        delegate_ = delegate;
+        running_ = true;
+        audioThread_ = std::thread([this] { audioLoop(); });
+    }
+
+    void stopAudio() {
+        running_ = false;
+        if (audioThread_.joinable()) audioThread_.join();
+        delegate_ = nullptr;
+    }
+
+private:
+    FakeConfig config_;
+    std::mt19937 rng_;
+    unsigned int channels_ = 1;
+    IMeetingServiceEvent* serviceEvent_ = nullptr;
+    IMeetingParticipantsCtrlEvent* participantsEvent_ = nullptr;
+
+    std::mutex mutex_;  // guards roster_, rng_ and samplePos_ between churn and the audio thread
+    std::map<unsigned int, SimParticipant> roster_;
+    unsigned int nextUserId_ = 16778240;  // Zoom-like user IDs
+    unsigned int joinCount_ = 0;
+    unsigned int recordingDenials_ = 0;
+    guint churnSource_ = 0;
+
+    std::atomic<bool> running_{false};
+    std::thread audioThread_;
+    IZoomSDKAudioRawDataDelegate* delegate_ = nullptr;
+    uint64_t samplePos_ = 0;
+    Wavetable wavetable_;
+
+    void setStatus(MeetingStatus status) {
+        if (serviceEvent_) serviceEvent_->onMeetingStatusChanged(status, 0);
+    }
+
+    unsigned int addLocked() {
+        unsigned int id = nextUserId_;
+        nextUserId_ += 1024;
+        std::uniform_real_distribution<double> pitch(90.0, 260.0);
+        std::uniform_real_distribution<float> pan(0.0f, 1.0f);
+        SimParticipant p;
+        p.userId = id;
+        p.info = std::make_unique<FakeUserInfo>(id, "Participant " + std::to_string(++joinCount_));
+        p.pitchHz = pitch(rng_);
+        float panPos = pan(rng_);
+        p.gainLeft = 1.0f - 0.5f * panPos;
+        p.gainRight = 0.5f + 0.5f * panPos;
+        p.nextToggle = samplePos_ + nextSpanSamples(false);
+        roster_.emplace(id, std::move(p));
+        return id;
+    }
+
+    // Talk spurts of 1-5 s; silences scale with meeting size so roughly one
+    // or two people are talking at any time
+    uint64_t nextSpanSamples(bool talking) {
+        double maxSilence = 4.0 * std::max(1u, config_.participants);
+        std::uniform_real_distribution<double> talk(1.0, 5.0);
+        std::uniform_real_distribution<double> silence(1.0, maxSilence);
+        return static_cast<uint64_t>((talking ? talk(rng_) : silence(rng_)) * config_.sampleRate);
+    }
+
+    // A webinar filling up: many listeners within one main-loop dispatch,
+    // each reported by its own callback
+    void joinBurst() {
+        std::vector<unsigned int> ids;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (unsigned int i = 0; i < config_.joinBurst; i++) {
+                unsigned int id = addLocked();
+                roster_[id].muted = true;
+                ids.push_back(id);
+            }
+        }
+        if (!participantsEvent_) return;
+        for (unsigned int id : ids) {
+            FakeUserList joined({id});
+            participantsEvent_->onUserJoin(&joined);
+        }
+    }
+
+    void churn() {
+        unsigned int leftId = 0;
+        unsigned int joinedId = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!roster_.empty()) {
+                auto it = roster_.begin();
+                std::advance(it, std::uniform_int_distribution<size_t>(0, roster_.size() - 1)(rng_));
+                leftId = it->first;
+                roster_.erase(it);
+            }
+            joinedId = addLocked();
+        }
+        if (!participantsEvent_) return;
+        if (leftId) {
+            FakeUserList left({leftId});
+            participantsEvent_->onUserLeft(&left);
+        }
+        FakeUserList joined({joinedId});
+        participantsEvent_->onUserJoin(&joined);
+    }
+
+    void audioLoop() {
+        const unsigned int frameSamples = config_.sampleRate / 100;
+        const unsigned int ch = channels_;
+        std::vector<std::pair<unsigned int, std::vector<int16_t>>> oneWay;
+        std::vector<int32_t> mix(frameSamples * ch);
+        std::vector<int16_t> mixed(frameSamples * ch);
+        std::uniform_int_distribution<int> noise(-30, 30);
+        std::uniform_int_distribution<unsigned int> percent(0, 99);
+
+        // 10ms of audio by the simulated SDK clock
+        const std::chrono::nanoseconds period(std::llround(1e7 / (1.0 + config_.clockPpm * 1e-6)));
+        auto next = std::chrono::steady_clock::now();
+        while (running_) {
+            next += period;
+            std::this_thread::sleep_until(next);
+
+            std::fill(mix.begin(), mix.end(), 0);
+            bool skipMixed;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                oneWay.resize(roster_.size());
+                size_t slot = 0;
+                for (auto& [id, p] : roster_) {
+                    if (p.muted) continue;
+                    auto& [userId, frame] = oneWay[slot++];
+                    userId = id;
+                    frame.resize(frameSamples * ch);
+                    synthesize(p, frame.data(), frameSamples, ch, noise);
+                    for (size_t i = 0; i < frame.size(); i++) mix[i] += frame[i];
+                }
+                oneWay.resize(slot);
+                skipMixed = config_.skipPercent > 0 && percent(rng_) < config_.skipPercent;
+                samplePos_ += frameSamples;  // read by joins on the GLib thread
+            }
+            if (config_.bleedDb > 0) {
+                // Everyone else, attenuated, on top of each participant's own mic
+                float bleed = std::pow(10.0f, -static_cast<float>(config_.bleedDb) / 20.0f);
+                for (auto& [userId, frame] : oneWay) {
+                    for (size_t i = 0; i < frame.size(); i++) {
+                        float s = frame[i] + bleed * static_cast<float>(mix[i] - frame[i]);
+                        frame[i] = static_cast<int16_t>(std::clamp(s, -32768.0f, 32767.0f));
+                    }
+                }
+            }
+
+            auto* delegate = delegate_;
+            if (!delegate) continue;
+            for (auto& [userId, frame] : oneWay) {
+                FakeAudioRawData data(frame.data(), static_cast<unsigned int>(frame.size()),
+                                      config_.sampleRate, ch);
+                delegate->onOneWayAudioRawDataReceived(&data, userId);
+            }
+            if (!skipMixed) {
+                for (size_t i = 0; i < mix.size(); i++) {
+                    mixed[i] = static_cast<int16_t>(std::clamp(mix[i], -32768, 32767));
+                }
+                FakeAudioRawData data(mixed.data(), static_cast<unsigned int>(mixed.size()),
+                                      config_.sampleRate, ch);
+                delegate->onMixedAudioRawDataReceived(&data);
+            }
+        }
+    }
+
+    void synthesize(SimParticipant& p, int16_t* out, unsigned int frames, unsigned int ch,
+                    std::uniform_int_distribution<int>& noise) {
+        if (samplePos_ >= p.nextToggle) {
+            p.talking = !p.talking;
+            p.nextToggle = samplePos_ + nextSpanSamples(p.talking);
+        }
+        const double step = p.pitchHz / config_.sampleRate;
+        const double syllableStep = 4.0 / config_.sampleRate;  // ~4 syllables per second
+        for (unsigned int i = 0; i < frames; i++) {
+            float s = static_cast<float>(noise(rng_));
+            if (p.talking) {
+                float envelope = 0.5f * (1.0f - std::cos(2.0f * static_cast<float>(M_PI * p.syllablePhase)));
+                s += 6000.0f * envelope * wavetable_.at(p.phase);
+                p.phase += step;
+                if (p.phase >= 1.0) p.phase -= 1.0;
+                p.syllablePhase += syllableStep;
+                if (p.syllablePhase >= 1.0) p.syllablePhase -= 1.0;
+            }
+            if (ch == 2) {
+                out[2 * i] = static_cast<int16_t>(s * p.gainLeft);
+                out[2 * i + 1] = static_cast<int16_t>(s * p.gainRight);
+            } else {
+                out[i] = static_cast<int16_t>(s);
+            }
+        }
+    }
+};
+
+class FakeAudioController : public IMeetingAudioController {
+public:
+    SDKError JoinVoip() override { return SDKERR_SUCCESS; }
+    SDKError MuteAudio(unsigned int, bool) override { return SDKERR_SUCCESS; }
+};
+
+class FakeRecordingController : public IMeetingRecordingController {
+public:
+    explicit FakeRecordingController(FakeMeeting& meeting) : meeting_(meeting) {}
+    SDKError CanStartRawRecording() override {
+        return meeting_.allowRecording() ? SDKERR_SUCCESS : SDKERR_NO_PERMISSION;
+    }
+    SDKError RequestLocalRecordingPrivilege() override { return SDKERR_SUCCESS; }
+    SDKError StartRawRecording() override { return SDKERR_SUCCESS; }
+
+private:
+    FakeMeeting& meeting_;
+};
+
+class FakeParticipantsController : public IMeetingParticipantsController {
+public:
+    explicit FakeParticipantsController(FakeMeeting& meeting) : meeting_(meeting) {}
+    SDKError SetEvent(IMeetingParticipantsCtrlEvent* pEvent) override {
+        meeting_.setParticipantsEvent(pEvent);
+        return SDKERR_SUCCESS;
+    }
+    IList<unsigned int>* GetParticipantsList() override {
+        list_ = std::make_unique<FakeUserList>(meeting_.userIds());
+        return list_.get();
+    }
+    IUserInfo* GetUserByUserID(unsigned int userid) override { return meeting_.user(userid); }
+
+private:
+    FakeMeeting& meeting_;
+    std::unique_ptr<FakeUserList> list_;
+};
+
+class FakeMeetingService : public IMeetingService {
+public:
+    FakeMeetingService()
+        : meeting_(std::make_shared<FakeMeeting>(g_config)),
+          participants_(*meeting_), recording_(*meeting_) {}
+
+    SDKError SetEvent(IMeetingServiceEvent* pEvent) override {
+        meeting_->setServiceEvent(pEvent);
+        return SDKERR_SUCCESS;
+    }
+    SDKError Join(JoinParam& joinParam) override {
+        const auto& join = joinParam.param.withoutloginuserJoin;
+        std::cout << "[FakeSDK] Joining simulated meeting " << join.meetingNumber << " with "
+                  << g_config.participants << " participants at " << g_config.sampleRate << " Hz"
+                  << (join.isAudioRawDataStereo ? " stereo" : " mono") << std::endl;
+        meeting_->join(join.isAudioRawDataStereo);
+        return SDKERR_SUCCESS;
+    }
+    SDKError Leave(LeaveMeetingCmd) override {
+        meeting_->leave();
+        return SDKERR_SUCCESS;
+    }
+    IMeetingParticipantsController* GetMeetingParticipantsController() override { return &participants_; }
+    IMeetingAudioController* GetMeetingAudioController() override { return &audio_; }
+    IMeetingRecordingController* GetMeetingRecordingController() override { return &recording_; }
+
+    FakeMeeting& meeting() { return *meeting_; }
+
+private:
+    std::shared_ptr<FakeMeeting> meeting_;
+    FakeParticipantsController participants_;
+    FakeAudioController audio_;
+    FakeRecordingController recording_;
+};
+
+class FakeAuthService : public IAuthService {
+public:
+    SDKError SetEvent(IAuthServiceEvent* pEvent) override {
+        event_ = pEvent;
+        return SDKERR_SUCCESS;
+    }
+    SDKError SDKAuth(AuthContext&) override {
+        auto* event = event_;
+        post([event] { if (event) event->onAuthenticationReturn(AUTHRET_SUCCESS); }, 100);
+        return SDKERR_SUCCESS;
+    }
+
+private:
+    IAuthServiceEvent* event_ = nullptr;
+};
+
+class FakeAudioHelper : public IZoomSDKAudioRawDataHelper {
+public:
+    SDKError subscribe(IZoomSDKAudioRawDataDelegate* pDelegate, bool) override {
+        if (!meeting_ || !pDelegate) return SDKERR_WRONG_USAGE;
+        meeting_->startAudio(pDelegate);
+        return SDKERR_SUCCESS;
+    }
+    SDKError unSubscribe() override {
+        if (meeting_) meeting_->stopAudio();
+        return SDKERR_SUCCESS;
+    }
+    void setMeeting(FakeMeeting* meeting) { meeting_ = meeting; }
+
+private:
+    FakeMeeting* meeting_ = nullptr;
+};
+
+FakeAudioHelper g_audioHelper;
+
+} // namespace
+
+SDKError InitSDK(InitParam&) {
+    g_config.participants = envUInt("FAKE_ZOOM_PARTICIPANTS", g_config.participants);
+    g_config.sampleRate = envUInt("FAKE_ZOOM_SAMPLE_RATE", g_config.sampleRate);
+    g_config.churnMs = envUInt("FAKE_ZOOM_CHURN_MS", g_config.churnMs);
+    g_config.joinBurst = envUInt("FAKE_ZOOM_JOIN_BURST", g_config.joinBurst);
+    g_config.skipPercent = envUInt("FAKE_ZOOM_SKIP_PERCENT", g_config.skipPercent);
+    g_config.recordingDenials = envUInt("FAKE_ZOOM_RECORDING_DENIALS", g_config.recordingDenials);
+    g_config.bleedDb = envUInt("FAKE_ZOOM_BLEED_DB", g_config.bleedDb);
+    g_config.clockPpm = envInt("FAKE_ZOOM_CLOCK_PPM", g_config.clockPpm);
+    g_config.seed = envUInt("FAKE_ZOOM_SEED", g_config.seed);
+    if (g_config.sampleRate < 100) g_config.sampleRate = 32000;
+    std::cout << "[FakeSDK] Using simulated Zoom SDK (no network, no real meeting)" << std::endl;
+    return SDKERR_SUCCESS;
+}
+
+SDKError CleanUPSDK() {
+    return SDKERR_SUCCESS;
+}
+
+SDKError CreateMeetingService(IMeetingService** pMeetingService) {
+    if (!pMeetingService) return SDKERR_INVALID_PARAMETER;
+    auto* service = new FakeMeetingService();
+    g_audioHelper.setMeeting(&service->meeting());
+    *pMeetingService = service;
+    return SDKERR_SUCCESS;
+}
+
+SDKError DestroyMeetingService(IMeetingService* pMeetingService) {
+    g_audioHelper.unSubscribe();
+    g_audioHelper.setMeeting(nullptr);
+    delete pMeetingService;
+    return SDKERR_SUCCESS;
+}
+
+SDKError CreateAuthService(IAuthService** pAuthService) {
+    if (!pAuthService) return SDKERR_INVALID_PARAMETER;
+    *pAuthService = new FakeAuthService();
+    return SDKERR_SUCCESS;
+}
+
+SDKError DestroyAuthService(IAuthService* pAuthService) {
+    delete pAuthService;
+    return SDKERR_SUCCESS;
+}
+
+bool HasRawdataLicense() {
+    return true;
+}
+
+IZoomSDKAudioRawDataHelper* GetAudioRawdataHelper() {
+    return &g_audioHelper;
+}
+
+} // namespace ZOOM_SDK_NAMESPACE
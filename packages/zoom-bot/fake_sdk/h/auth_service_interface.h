@@ -0,0 +1,50 @@
+#pragma once
+
+#include "zoom_sdk_def.h"
+
+namespace ZOOM_SDK_NAMESPACE {
+
+enum AuthResult {
+    AUTHRET_SUCCESS = 0,
+    AUTHRET_KEYORSECRETEMPTY,
+    AUTHRET_KEYORSECRETWRONG,
+    AUTHRET_ACCOUNTNOTSUPPORT,
+    AUTHRET_ACCOUNTNOTENABLESDK,
+    AUTHRET_UNKNOWN,
+};
+
+enum LOGINSTATUS {
+    LOGIN_IDLE = 0,
+    LOGIN_PROCESSING,
+    LOGIN_SUCCESS,
+    LOGIN_FAILED,
+};
+
+enum LoginFailReason {
+    LoginFail_None = 0,
+};
+
+class IAccountInfo;
+
+struct AuthContext {
+    const zchar_t* jwt_token = nullptr;
+};
+
+class IAuthServiceEvent {
+public:
+    virtual ~IAuthServiceEvent() {}
+    virtual void onAuthenticationReturn(AuthResult ret) = 0;
+    virtual void onLoginReturnWithReason(LOGINSTATUS ret, IAccountInfo* pAccountInfo, LoginFailReason reason) = 0;
+    virtual void onLogout() = 0;
+    virtual void onZoomIdentityExpired() = 0;
+    virtual void onZoomAuthIdentityExpired() = 0;
+};
+
+class IAuthService {
+public:
+    virtual ~IAuthService() {}
+    virtual SDKError SetEvent(IAuthServiceEvent* pEvent) = 0;
+    virtual SDKError SDKAuth(AuthContext& authContext) = 0;
+};
+
+} // namespace ZOOM_SDK_NAMESPACE
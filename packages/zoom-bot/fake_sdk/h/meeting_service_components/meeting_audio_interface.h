@@ -0,0 +1,14 @@
+#pragma once
+
+#include "zoom_sdk_def.h"
+
+namespace ZOOM_SDK_NAMESPACE {
+
+class IMeetingAudioController {
+public:
+    virtual ~IMeetingAudioController() {}
+    virtual SDKError JoinVoip() = 0;
+    virtual SDKError MuteAudio(unsigned int userid, bool allowUnmuteBySelf = true) = 0;
+};
+
+} // namespace ZOOM_SDK_NAMESPACE
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "zoom_sdk_def.h"
+#include "meeting_service_components/meeting_recording_interface.h"
+
+namespace ZOOM_SDK_NAMESPACE {
+
+enum LocalRecordingRequestPrivilegeStatus {
+    LocalRecordingRequestPrivilege_None,
+};
+
+enum FocusModeShareType {
+    FocusModeShareType_None,
+};
+
+class IUserInfo {
+public:
+    virtual ~IUserInfo() {}
+    virtual const zchar_t* GetUserName() = 0;
+    virtual unsigned int GetUserID() = 0;
+};
+
+class IMeetingParticipantsCtrlEvent {
+public:
+    virtual ~IMeetingParticipantsCtrlEvent() {}
+    virtual void onUserJoin(IList<unsigned int>* lstUserID, const zchar_t* strUserList = nullptr) = 0;
+    virtual void onUserLeft(IList<unsigned int>* lstUserID, const zchar_t* strUserList = nullptr) = 0;
+    virtual void onHostChangeNotification(unsigned int userId) = 0;
+    virtual void onLowOrRaiseHandStatusChanged(bool bLow, unsigned int userid) = 0;
+    virtual void onUserNamesChanged(IList<unsigned int>* lstUserID) = 0;
+    virtual void onCoHostChangeNotification(unsigned int userId, bool isCoHost) = 0;
+    virtual void onInvalidReclaimHostkey() = 0;
+    virtual void onAllHandsLowered() = 0;
+    virtual void onLocalRecordingStatusChanged(unsigned int user_id, RecordingStatus status) = 0;
+    virtual void onAllowParticipantsRenameNotification(bool bAllow) = 0;
+    virtual void onAllowParticipantsUnmuteSelfNotification(bool bAllow) = 0;
+    virtual void onAllowParticipantsStartVideoNotification(bool bAllow) = 0;
+    virtual void onAllowParticipantsShareWhiteBoardNotification(bool bAllow) = 0;
+    virtual void onRequestLocalRecordingPrivilegeChanged(LocalRecordingRequestPrivilegeStatus status) = 0;
+    virtual void onInMeetingUserAvatarPathUpdated(unsigned int userID) = 0;
+    virtual void onParticipantProfilePictureStatusChange(bool bHidden) = 0;
+    virtual void onFocusModeStateChanged(bool bEnabled) = 0;
+    virtual void onFocusModeShareTypeChanged(FocusModeShareType type) = 0;
+    virtual void onAllowParticipantsRequestCloudRecording(bool bAllow) = 0;
+    virtual void onBotAuthorizerRelationChanged(unsigned int authorizeUserID) = 0;
+    virtual void onVirtualNameTagStatusChanged(bool bOn, unsigned int userID) = 0;
+    virtual void onVirtualNameTagRosterInfoUpdated(unsigned int userID) = 0;
+    virtual void onGrantCoOwnerPrivilegeChanged(bool canGrantOther) = 0;
+};
+
+class IMeetingParticipantsController {
+public:
+    virtual ~IMeetingParticipantsController() {}
+    virtual SDKError SetEvent(IMeetingParticipantsCtrlEvent* pEvent) = 0;
+    virtual IList<unsigned int>* GetParticipantsList() = 0;
+    virtual IUserInfo* GetUserByUserID(unsigned int userid) = 0;
+};
+
+} // namespace ZOOM_SDK_NAMESPACE
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "zoom_sdk_def.h"
+
+namespace ZOOM_SDK_NAMESPACE {
+
+enum RecordingStatus {
+    Recording_Start,
+    Recording_Stop,
+};
+
+class IMeetingRecordingController {
+public:
+    virtual ~IMeetingRecordingController() {}
+    virtual SDKError CanStartRawRecording() = 0;
+    virtual SDKError RequestLocalRecordingPrivilege() = 0;
+    virtual SDKError StartRawRecording() = 0;
+};
+
+} // namespace ZOOM_SDK_NAMESPACE
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "zoom_sdk_def.h"
+#include "meeting_service_components/meeting_audio_interface.h"
+#include "meeting_service_components/meeting_participants_ctrl_interface.h"
+#include "meeting_service_components/meeting_recording_interface.h"
+
+namespace ZOOM_SDK_NAMESPACE {
+
+enum MeetingStatus {
+    MEETING_STATUS_IDLE,
+    MEETING_STATUS_CONNECTING,
+    MEETING_STATUS_WAITINGFORHOST,
+    MEETING_STATUS_INMEETING,
+    MEETING_STATUS_DISCONNECTING,
+    MEETING_STATUS_RECONNECTING,
+    MEETING_STATUS_FAILED,
+    MEETING_STATUS_ENDED,
+};
+
+enum StatisticsWarningType { Statistics_Warning_None };
+enum MeetingComponentType { MeetingComponentType_Def };
+enum ConnectionQuality { Conn_Quality_Unknown };
+
+enum SDKUserType {
+    SDK_UT_NORMALUSER = 100,
+    SDK_UT_WITHOUT_LOGIN,
+};
+
+enum LeaveMeetingCmd {
+    LEAVE_MEETING,
+    END_MEETING,
+};
+
+struct MeetingParameter {};
+
+struct JoinParam4WithoutLogin {
+    uint64_t meetingNumber;
+    const zchar_t* userName;
+    const zchar_t* psw;
+    bool isVideoOff;
+    bool isAudioOff;
+    bool isMyVoiceInMix;
+    bool isAudioRawDataStereo;
+};
+
+struct JoinParam {
+    SDKUserType userType;
+    union {
+        JoinParam4WithoutLogin withoutloginuserJoin;
+    } param;
+};
+
+class IMeetingServiceEvent {
+public:
+    virtual ~IMeetingServiceEvent() {}
+    virtual void onMeetingStatusChanged(MeetingStatus status, int iResult = 0) = 0;
+    virtual void onMeetingStatisticsWarningNotification(StatisticsWarningType type) = 0;
+    virtual void onMeetingParameterNotification(const MeetingParameter* meeting_param) = 0;
+    virtual void onSuspendParticipantsActivities() = 0;
+    virtual void onAICompanionActiveChangeNotice(bool bActive) = 0;
+    virtual void onMeetingTopicChanged(const zchar_t* sTopic) = 0;
+    virtual void onMeetingFullToWatchLiveStream(const zchar_t* sLiveStreamUrl) = 0;
+    virtual void onUserNetworkStatusChanged(MeetingComponentType type, ConnectionQuality level, unsigned int userId, bool uplink) = 0;
+};
+
+class IMeetingService {
+public:
+    virtual ~IMeetingService() {}
+    virtual SDKError SetEvent(IMeetingServiceEvent* pEvent) = 0;
+    virtual SDKError Join(JoinParam& joinParam) = 0;
+    virtual SDKError Leave(LeaveMeetingCmd leaveCmd) = 0;
+    virtual IMeetingParticipantsController* GetMeetingParticipantsController() = 0;
+    virtual IMeetingAudioController* GetMeetingAudioController() = 0;
+    virtual IMeetingRecordingController* GetMeetingRecordingController() = 0;
+};
+
+} // namespace ZOOM_SDK_NAMESPACE
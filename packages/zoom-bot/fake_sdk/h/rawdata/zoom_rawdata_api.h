@@ -0,0 +1,10 @@
+#pragma once
+
+#include "rawdata/rawdata_audio_helper_interface.h"
+
+namespace ZOOM_SDK_NAMESPACE {
+
+SDK_API bool HasRawdataLicense();
+SDK_API IZoomSDKAudioRawDataHelper* GetAudioRawdataHelper();
+
+} // namespace ZOOM_SDK_NAMESPACE
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "zoom_sdk_def.h"
+#include "auth_service_interface.h"
+#include "meeting_service_interface.h"
+
+namespace ZOOM_SDK_NAMESPACE {
+
+SDK_API SDKError InitSDK(InitParam& initParam);
+SDK_API SDKError CleanUPSDK();
+SDK_API SDKError CreateMeetingService(IMeetingService** pMeetingService);
+SDK_API SDKError DestroyMeetingService(IMeetingService* pMeetingService);
+SDK_API SDKError CreateAuthService(IAuthService** pAuthService);
+SDK_API SDKError DestroyAuthService(IAuthService* pAuthService);
+
+} // namespace ZOOM_SDK_NAMESPACE
@@ -0,0 +1,52 @@
+#pragma once
+
+// Fake Zoom Meeting SDK headers: only the subset of the real SDK interface
+// that zoom-bot uses, with the same names, namespaces and include paths so
+// the bot sources compile unchanged against either. See fake_sdk.cpp.
+
+#include <cstdint>
+
+#define ZOOM_SDK_NAMESPACE ZOOMSDK
+#define SDK_API
+
+typedef char zchar_t;
+
+namespace ZOOM_SDK_NAMESPACE {
+
+enum SDKError {
+    SDKERR_SUCCESS = 0,
+    SDKERR_NO_IMPL,
+    SDKERR_WRONG_USAGE,
+    SDKERR_INVALID_PARAMETER,
+    SDKERR_MODULE_LOAD_FAILED,
+    SDKERR_MEMORY_FAILED,
+    SDKERR_SERVICE_FAILED,
+    SDKERR_UNINITIALIZE,
+    SDKERR_UNAUTHENTICATION,
+    SDKERR_NORECORDINGINPROCESS,
+    SDKERR_TRANSCODER_NOFOUND,
+    SDKERR_VIDEO_NOTREADY,
+    SDKERR_NO_PERMISSION,
+    SDKERR_UNKNOWN,
+};
+
+enum SDK_LANGUAGE_ID {
+    LANGUAGE_Unknown = 0,
+    LANGUAGE_English,
+};
+
+template<class T>
+class IList {
+public:
+    virtual ~IList() {}
+    virtual int GetCount() = 0;
+    virtual T GetItem(int index) = 0;
+};
+
+struct InitParam {
+    const zchar_t* strWebDomain = nullptr;
+    SDK_LANGUAGE_ID emLanguageID = LANGUAGE_Unknown;
+    bool enableLogByDefault = false;
+};
+
+} // namespace ZOOM_SDK_NAMESPACE
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "zoom_sdk_def.h"
+
+class AudioRawData {
+public:
+    virtual ~AudioRawData() {}
+    virtual bool CanAddRef() = 0;
+    virtual bool AddRef() = 0;
+    virtual int Release() = 0;
+    virtual char* GetBuffer() = 0;
+    virtual unsigned int GetBufferLen() = 0;
+    virtual unsigned int GetSampleRate() = 0;
+    virtual unsigned int GetChannelNum() = 0;
+};
@@ -0,0 +1,156 @@
+// journal-export: print a time range of a meeting event journal as JSON
+// lines. Seeks with the sparse .idx index, so exporting a few minutes of a
+// long meeting reads only that part of the file.
+//
+//   journal-export meeting.journal                      whole journal
+//   journal-export meeting.journal --from +600 --to +900
+//       (+N is seconds from the start of the journal; plain numbers are
+//        wall clock ms since epoch)
+
+#include "journal_format.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only view of a whole file
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                data = static_cast<const char*>(p);
+                size = st.st_size;
+            }
+        }
+        ::close(fd);
+        return data != nullptr;
+    }
+
+    ~MappedFile() {
+        if (data) munmap(const_cast<char*>(data), size);
+    }
+};
+
+// +N seconds from createdMs, or wall clock ms; false if arg is neither
+static bool parseTime(const std::string& arg, uint64_t createdMs, uint64_t& out) {
+    try {
+        size_t used = 0;
+        if (!arg.empty() && arg[0] == '+') {
+            double seconds = std::stod(arg.substr(1), &used);
+            if (used != arg.size() - 1 || !(seconds >= 0)) return false;
+            out = createdMs + static_cast<uint64_t>(seconds * 1000);
+            return true;
+        }
+        if (arg.empty() || arg[0] == '-') return false;
+        out = std::stoull(arg, &used);
+        return used == arg.size();
+    } catch (const std::logic_error&) {  // invalid_argument, out_of_range
+        return false;
+    }
+}
+
+static const char* typeName(journal::EventType type) {
+    switch (type) {
+        case journal::EventType::Join: return "join";
+        case journal::EventType::Leave: return "leave";
+        case journal::EventType::Rename: return "rename";
+        case journal::EventType::SpeakerRun: return "speaking";
+    }
+    return "unknown";
+}
+
+static int usage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " <journal> [--from <time>] [--to <time>]\n"
+              << "       <time> is +seconds from the start of the journal, or wall clock ms since epoch"
+              << std::endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) return usage(argv[0]);
+    std::string path = argv[1];
+
+    MappedFile file;
+    if (!file.open(path) || file.size < sizeof(journal::FileHeader)) {
+        std::cerr << "Cannot read " << path << std::endl;
+        return 1;
+    }
+    journal::FileHeader header;
+    std::memcpy(&header, file.data, sizeof(header));
+    if (header.magic != journal::MAGIC || header.version != journal::VERSION) {
+        std::cerr << path << " is not a version " << journal::VERSION << " journal" << std::endl;
+        return 1;
+    }
+
+    uint64_t from = 0, to = UINT64_MAX;
+    for (int i = 2; i < argc; i += 2) {
+        std::string arg = argv[i];
+        bool ok = i + 1 < argc;
+        if (ok && arg == "--from") ok = parseTime(argv[i + 1], header.createdMs, from);
+        else if (ok && arg == "--to") ok = parseTime(argv[i + 1], header.createdMs, to);
+        else ok = false;
+        if (!ok) return usage(argv[0]);
+    }
+
+    // Start at the last index entry at or before `from`; without an index,
+    // scan from the first record
+    size_t offset = sizeof(header);
+    MappedFile index;
+    if (from > 0 && index.open(path + ".idx")) {
+        auto* begin = reinterpret_cast<const journal::IndexEntry*>(index.data);
+        auto* end = begin + index.size / sizeof(journal::IndexEntry);
+        auto it = std::upper_bound(begin, end, from, [](uint64_t t, const journal::IndexEntry& e) {
+            return t < e.timestampMs;
+        });
+        if (it != begin && (it - 1)->offset < file.size) offset = (it - 1)->offset;
+    }
+
+    // Speech runs are written after they end, so read a little past `to`
+    uint64_t scanUntil = to > UINT64_MAX - journal::MAX_RUN_SLACK_MS ? UINT64_MAX : to + journal::MAX_RUN_SLACK_MS;
+
+    while (offset + sizeof(journal::RecordHeader) <= file.size) {
+        journal::RecordHeader rec;
+        std::memcpy(&rec, file.data + offset, sizeof(rec));
+        const char* payload = file.data + offset + sizeof(rec);
+        if (offset + sizeof(rec) + rec.length > file.size) break;  // tail still being written
+        offset += sizeof(rec) + rec.length;
+
+        if (rec.timestampMs > scanUntil) break;
+        if (rec.timestampMs < from) continue;
+
+        auto type = static_cast<journal::EventType>(rec.type);
+        nlohmann::json out;
+        out["type"] = typeName(type);
+        out["userId"] = rec.userId;
+
+        if (type == journal::EventType::SpeakerRun && rec.length >= sizeof(journal::SpeakerRun)) {
+            journal::SpeakerRun run;
+            std::memcpy(&run, payload, sizeof(run));
+            uint64_t start = rec.timestampMs - run.leadMs;
+            if (start > to) continue;
+            out["start"] = start;
+            out["end"] = start + run.durationMs;
+        } else {
+            if (rec.timestampMs > to) continue;
+            out["timestamp"] = rec.timestampMs;
+            if (type == journal::EventType::Join || type == journal::EventType::Rename) {
+                out["name"] = std::string(payload, rec.length);
+            }
+        }
+        std::cout << out.dump() << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,255 @@
+#include "shm_reader.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+ShmReader::~ShmReader() {
+    for (auto& conn : connections_) close(conn);
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        ::unlink(socketPath_.c_str());
+    }
+}
+
+bool ShmReader::listen(const std::string& socketPath) {
+    socketPath_ = socketPath;
+    listenFd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) return false;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    ::unlink(socketPath.c_str());
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listenFd_, 16) < 0) {
+        std::cerr << "[SHM] Cannot listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+void ShmReader::run(const FrameHandler& onFrame, const ConnectionHandler& onConnection,
+                    const std::atomic<bool>& stop) {
+    std::vector<pollfd> fds;
+    while (!stop) {
+        // Drain everything that is ready before considering sleep
+        size_t delivered = 0;
+        for (auto& conn : connections_) delivered += drain(conn, onFrame);
+        dropCorrupt(onConnection);
+        if (delivered > 0) continue;
+
+        // Announce that we are about to sleep, then re-check so a record
+        // published in between is not missed (pairs with the writer's seq_cst)
+        bool pending = false;
+        for (auto& conn : connections_) {
+            conn.header->readerWaiting.store(1, std::memory_order_seq_cst);
+            if (conn.header->writePos.load(std::memory_order_seq_cst) !=
+                conn.header->readPos.load(std::memory_order_relaxed)) {
+                pending = true;
+            }
+        }
+
+        if (!pending) {
+            fds.clear();
+            fds.push_back({listenFd_, POLLIN, 0});
+            for (const auto& conn : connections_) {
+                fds.push_back({conn.eventFd, POLLIN, 0});
+                fds.push_back({conn.socketFd, POLLIN, 0});
+            }
+            poll(fds.data(), fds.size(), 100);
+        }
+
+        for (auto& conn : connections_) {
+            conn.header->readerWaiting.store(0, std::memory_order_relaxed);
+            uint64_t counter;
+            while (::read(conn.eventFd, &counter, sizeof(counter)) > 0) {}
+        }
+        if (pending) continue;
+
+        // Bots never write to the control socket after the handshake, so a
+        // readable or hung-up one means the bot went away
+        size_t slot = 0;
+        for (size_t i = 0; i < connections_.size(); slot++) {
+            short ev = fds[2 + 2 * slot].revents;
+            if (ev & (POLLIN | POLLHUP | POLLERR)) {
+                drain(connections_[i], onFrame);
+                if (onConnection) onConnection(connections_[i].id, false);
+                close(connections_[i]);
+                connections_.erase(connections_.begin() + i);
+            } else {
+                i++;
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            accept(onConnection);
+        }
+    }
+}
+
+uint64_t ShmReader::dropped(uint32_t connectionId) const {
+    for (const auto& conn : connections_) {
+        if (conn.id == connectionId) return conn.header->dropped.load(std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+bool ShmReader::sendCommand(uint32_t connectionId, const std::string& json) {
+    for (const auto& conn : connections_) {
+        if (conn.id != connectionId) continue;
+        // One command per message; never block the reader on a stuck bot
+        ssize_t n = ::send(conn.socketFd, json.data(), json.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        return n == static_cast<ssize_t>(json.size());
+    }
+    return false;
+}
+
+bool ShmReader::accept(const ConnectionHandler& onConnection) {
+    int sock = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (sock < 0) return false;
+
+    // Receive the handshake with the memfd and eventfd attached
+    shm::Hello hello{};
+    iovec iov{&hello, sizeof(hello)};
+    char control[CMSG_SPACE(2 * sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    int fds[2] = {-1, -1};
+    ssize_t n = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (n == sizeof(hello) && cmsg && cmsg->cmsg_type == SCM_RIGHTS &&
+        cmsg->cmsg_len == CMSG_LEN(2 * sizeof(int))) {
+        std::memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+    }
+    if (fds[0] < 0 || hello.magic != shm::MAGIC || hello.version != shm::VERSION) {
+        std::cerr << "[SHM] Rejected connection with invalid handshake" << std::endl;
+        if (fds[0] >= 0) ::close(fds[0]);
+        if (fds[1] >= 0) ::close(fds[1]);
+        ::close(sock);
+        return false;
+    }
+
+    // Touching pages past the end of the memfd would fault, so it must be
+    // at least as large as the mapping it claims
+    struct stat st{};
+    if (hello.mappingSize <= shm::HEADER_AREA || ::fstat(fds[0], &st) != 0 ||
+        static_cast<uint64_t>(st.st_size) < hello.mappingSize) {
+        std::cerr << "[SHM] Rejected connection: ring of " << hello.mappingSize
+                  << " bytes does not match its memfd" << std::endl;
+        ::close(fds[0]);
+        ::close(fds[1]);
+        ::close(sock);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, hello.mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+    ::close(fds[0]);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "[SHM] Cannot map ring: " << std::strerror(errno) << std::endl;
+        ::close(fds[1]);
+        ::close(sock);
+        return false;
+    }
+
+    // The data area must be a power of two filling the rest of the mapping
+    auto* header = static_cast<shm::RingHeader*>(mapping);
+    uint64_t capacity = header->capacity;
+    if (header->magic != shm::MAGIC || header->version != shm::VERSION || capacity == 0 ||
+        (capacity & (capacity - 1)) != 0 || hello.mappingSize != shm::HEADER_AREA + capacity) {
+        std::cerr << "[SHM] Rejected connection: malformed ring header" << std::endl;
+        munmap(mapping, hello.mappingSize);
+        ::close(fds[1]);
+        ::close(sock);
+        return false;
+    }
+
+    Connection conn;
+    conn.id = nextId_++;
+    conn.socketFd = sock;
+    conn.eventFd = fds[1];
+    conn.mapping = mapping;
+    conn.mappingSize = hello.mappingSize;
+    conn.capacity = capacity;
+    conn.header = header;
+    conn.data = static_cast<const char*>(mapping) + shm::HEADER_AREA;
+    conn.corrupt = false;
+    connections_.push_back(conn);
+    if (onConnection) onConnection(conn.id, true);
+    return true;
+}
+
+size_t ShmReader::drain(Connection& conn, const FrameHandler& onFrame) {
+    if (conn.corrupt) return 0;
+    auto* header = conn.header;
+    const uint64_t capacity = conn.capacity;
+    const uint64_t mask = capacity - 1;
+    uint64_t r = header->readPos.load(std::memory_order_relaxed);
+    uint64_t w = header->writePos.load(std::memory_order_acquire);
+    size_t delivered = 0;
+
+    // Positions and lengths come from the other process; anything that
+    // would read outside the ring ends the connection
+    auto reject = [&](const char* what) {
+        std::cerr << "[SHM] Bot " << conn.id << " " << what << " at position " << r
+                  << ", disconnecting" << std::endl;
+        conn.corrupt = true;
+    };
+    if (w - r > capacity) {
+        reject("moved its write position outside the ring");
+        return 0;
+    }
+
+    while (r < w) {
+        uint64_t offset = r & mask;
+        if (w - r < sizeof(shm::RecordHeader) || offset + sizeof(shm::RecordHeader) > capacity) {
+            reject("wrote a truncated record header");
+            break;
+        }
+        const auto* rec = reinterpret_cast<const shm::RecordHeader*>(conn.data + offset);
+        uint32_t length = rec->length;  // read once; the writer could change it
+        uint64_t size = shm::recordSize(length);
+        if (size > w - r || offset + size > capacity) {
+            reject("wrote a record longer than the ring holds");
+            break;
+        }
+        auto type = static_cast<shm::RecordType>(rec->type);
+        if (type != shm::RecordType::Padding && onFrame) {
+            onFrame({conn.id, type, reinterpret_cast<const char*>(rec + 1), length, rec->timestampNs});
+            delivered++;
+        }
+        r += size;
+    }
+
+    header->readPos.store(r, std::memory_order_release);
+    return delivered;
+}
+
+void ShmReader::dropCorrupt(const ConnectionHandler& onConnection) {
+    for (size_t i = 0; i < connections_.size();) {
+        if (!connections_[i].corrupt) {
+            i++;
+            continue;
+        }
+        if (onConnection) onConnection(connections_[i].id, false);
+        close(connections_[i]);
+        connections_.erase(connections_.begin() + i);
+    }
+}
+
+void ShmReader::close(Connection& conn) {
+    munmap(conn.mapping, conn.mappingSize);
+    ::close(conn.eventFd);
+    ::close(conn.socketFd);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "shm_ring.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Reader side of the shm:// gateway transport, for a process on the same
+// host as one or more bots. Listens on a Unix socket; each bot that connects
+// hands over its ring, and frames are delivered in place from shared memory
+// (the payload pointer is only valid during the callback). Commands for a
+// bot (rewind_request, transcription_state, ...) go back over its socket.
+// A bot whose ring is malformed or whose records run outside it is
+// disconnected rather than trusted.
+class ShmReader {
+public:
+    struct Frame {
+        uint32_t connectionId;
+        shm::RecordType type;
+        const char* data;
+        size_t length;
+        uint64_t timestampNs;  // steady clock at write time
+    };
+
+    using FrameHandler = std::function<void(const Frame&)>;
+    using ConnectionHandler = std::function<void(uint32_t connectionId, bool connected)>;
+
+    ~ShmReader();
+
+    bool listen(const std::string& socketPath);
+
+    // Deliver frames until stop is set. Blocks on the eventfds when all rings are empty.
+    void run(const FrameHandler& onFrame, const ConnectionHandler& onConnection,
+             const std::atomic<bool>& stop);
+
+    // Records dropped by the writer because this reader fell behind
+    uint64_t dropped(uint32_t connectionId) const;
+
+    // Send a JSON command to a bot, as the gateway would in a WebSocket text
+    // frame. Call from the handlers passed to run(); false if the bot is
+    // gone or its socket is full.
+    bool sendCommand(uint32_t connectionId, const std::string& json);
+
+private:
+    struct Connection {
+        uint32_t id;
+        int socketFd;
+        int eventFd;
+        void* mapping;
+        size_t mappingSize;
+        uint64_t capacity;  // checked at accept; the bot cannot change it later
+        shm::RingHeader* header;
+        const char* data;
+        bool corrupt;
+    };
+
+    std::string socketPath_;
+    int listenFd_ = -1;
+    uint32_t nextId_ = 1;
+    std::vector<Connection> connections_;
+
+    bool accept(const ConnectionHandler& onConnection);
+    size_t drain(Connection& conn, const FrameHandler& onFrame);
+    void dropCorrupt(const ConnectionHandler& onConnection);
+    void close(Connection& conn);
+};
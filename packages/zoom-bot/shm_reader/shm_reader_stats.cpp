@@ -0,0 +1,285 @@
+// shm-reader-stats: minimal consumer for the shm:// transport. Accepts bots
+// on a Unix socket and prints per-second throughput and write-to-read
+// latency. Commands given with --send go to every bot as it connects, as
+// the gateway would send them (e.g. to start a direct transcriber).
+//
+// With --compare-ws it instead measures both transports itself, in one
+// process: 10ms audio frames written at the bot's pace through a
+// ShmTransport ring, then as masked WebSocket binary frames over loopback
+// TCP, reporting write-to-read latency and CPU for each.
+//
+//   shm-reader-stats /tmp/zoom-bot.sock
+//   shm-reader-stats /tmp/zoom-bot.sock --send '{"type":"transcription_state","paused":false}'
+//   zoom-bot --gateway-url shm:///tmp/zoom-bot.sock ...
+//   shm-reader-stats --compare-ws 20
+
+#include "shm_reader.h"
+#include "shm_transport.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static std::atomic<bool> g_stop{false};
+
+static void signalHandler(int) {
+    g_stop = true;
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double cpuSeconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+static constexpr size_t COMPARE_FRAME_BYTES = 320;  // 10ms of 16 kHz mono PCM
+
+struct Latency {
+    std::vector<uint64_t> ns;
+
+    void print(const char* label, double seconds, double cpu) {
+        double p50 = 0, p99 = 0, max = 0;
+        if (!ns.empty()) {
+            std::sort(ns.begin(), ns.end());
+            p50 = ns[ns.size() / 2] / 1000.0;
+            p99 = ns[ns.size() * 99 / 100] / 1000.0;
+            max = ns.back() / 1000.0;
+        }
+        std::printf("%-17s %zu frames, latency p50 %.1fus p99 %.1fus max %.1fus, cpu %.2f%%\n", label, ns.size(),
+                    p50, p99, max, 100 * cpu / seconds);
+    }
+};
+
+// Write one frame every 10ms until seconds have passed; write() is given
+// the frame with the current steady-clock time in its first 8 bytes
+template <typename Write>
+static void writePaced(double seconds, Write write) {
+    std::vector<char> frame(COMPARE_FRAME_BYTES, 0);
+    auto next = std::chrono::steady_clock::now();
+    auto frames = static_cast<uint64_t>(seconds * 100);
+    for (uint64_t i = 0; i < frames && !g_stop; i++) {
+        next += std::chrono::milliseconds(10);
+        std::this_thread::sleep_until(next);
+        uint64_t stamp = nowNs();
+        std::memcpy(frame.data(), &stamp, sizeof(stamp));
+        write(frame.data(), frame.size());
+    }
+}
+
+static void compareShm(double seconds) {
+    std::string path = "/tmp/shm-reader-stats-" + std::to_string(getpid()) + ".sock";
+    ShmReader reader;
+    if (!reader.listen(path)) return;
+
+    Latency latency;
+    std::atomic<bool> stop{false};
+    std::thread readerThread([&] {
+        reader.run([&](const ShmReader::Frame& frame) {
+                       if (frame.type == shm::RecordType::Audio) latency.ns.push_back(nowNs() - frame.timestampNs);
+                   },
+                   nullptr, stop);
+    });
+
+    ShmTransport writer(64 * 1024);
+    writer.connect(path);
+    for (int i = 0; i < 100 && !writer.isConnected(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    double cpu0 = cpuSeconds();
+    auto start = std::chrono::steady_clock::now();
+    writePaced(seconds, [&](const char* data, size_t len) { writer.sendAudio(data, len); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double cpu = cpuSeconds() - cpu0;
+
+    writer.disconnect();
+    stop = true;
+    readerThread.join();
+    latency.print("shm ring", wall, cpu);
+}
+
+static void compareWebSocket(double seconds) {
+    int listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listenFd, 1) < 0 || ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &addrLen) < 0) {
+        std::cerr << "[SHM] Cannot listen on loopback: " << std::strerror(errno) << std::endl;
+        if (listenFd >= 0) ::close(listenFd);
+        return;
+    }
+
+    int client = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (::connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "[SHM] Cannot connect over loopback: " << std::strerror(errno) << std::endl;
+        ::close(client);
+        ::close(listenFd);
+        return;
+    }
+    int one = 1;
+    ::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    int server = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+    ::close(listenFd);
+
+    // The gateway side: parse frames, unmask, take the timestamp
+    Latency latency;
+    std::thread readerThread([&] {
+        std::vector<uint8_t> in;
+        std::vector<uint8_t> buffer(64 * 1024);
+        for (;;) {
+            ssize_t n = ::read(server, buffer.data(), buffer.size());
+            if (n <= 0) break;
+            uint64_t now = nowNs();
+            in.insert(in.end(), buffer.begin(), buffer.begin() + n);
+            size_t pos = 0;
+            for (;;) {
+                if (in.size() - pos < 2) break;
+                size_t length = in[pos + 1] & 0x7f;
+                size_t header = 2;
+                if (length == 126) {
+                    if (in.size() - pos < 4) break;
+                    length = (static_cast<size_t>(in[pos + 2]) << 8) | in[pos + 3];
+                    header = 4;
+                }
+                if (in.size() - pos < header + 4 + length) break;
+                const uint8_t* mask = &in[pos + header];
+                uint8_t* payload = &in[pos + header + 4];
+                for (size_t i = 0; i < length; i++) payload[i] ^= mask[i & 3];
+                uint64_t stamp = 0;
+                if (length >= sizeof(stamp)) {
+                    std::memcpy(&stamp, payload, sizeof(stamp));
+                    latency.ns.push_back(now - stamp);
+                }
+                pos += header + 4 + length;
+            }
+            in.erase(in.begin(), in.begin() + pos);
+        }
+    });
+
+    // The bot side: frame and mask as a WebSocket client does
+    std::vector<uint8_t> frame;
+    double cpu0 = cpuSeconds();
+    auto start = std::chrono::steady_clock::now();
+    writePaced(seconds, [&](const char* data, size_t len) {
+        frame.clear();
+        frame.push_back(0x82);  // FIN, binary
+        frame.push_back(0x80 | 126);
+        frame.push_back(static_cast<uint8_t>(len >> 8));
+        frame.push_back(static_cast<uint8_t>(len));
+        const uint8_t mask[4] = {0x3a, 0x5c, 0x7e, 0x91};
+        frame.insert(frame.end(), mask, mask + 4);
+        for (size_t i = 0; i < len; i++) frame.push_back(static_cast<uint8_t>(data[i]) ^ mask[i & 3]);
+        ssize_t n = ::send(client, frame.data(), frame.size(), MSG_NOSIGNAL);
+        (void)n;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double cpu = cpuSeconds() - cpu0;
+
+    ::shutdown(client, SHUT_RDWR);
+    readerThread.join();
+    ::close(client);
+    ::close(server);
+    latency.print("loopback ws", wall, cpu);
+}
+
+int main(int argc, char* argv[]) {
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    if (argc >= 2 && std::string(argv[1]) == "--compare-ws") {
+        double seconds = argc >= 3 ? std::atof(argv[2]) : 10.0;
+        if (seconds <= 0) seconds = 10.0;
+        std::printf("setup             %.0fs of %zu-byte frames every 10ms, writer and reader in this process\n",
+                    seconds, COMPARE_FRAME_BYTES);
+        compareShm(seconds);
+        compareWebSocket(seconds);
+        return 0;
+    }
+
+    std::vector<std::string> commands;
+    for (int i = 2; i < argc; i++) {
+        if (std::string(argv[i]) == "--send" && i + 1 < argc) {
+            commands.push_back(argv[++i]);
+        } else {
+            argc = 1;
+            break;
+        }
+    }
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <socket-path> [--send JSON]...\n"
+                  << "       " << argv[0] << " --compare-ws [seconds]" << std::endl;
+        return 1;
+    }
+
+    ShmReader reader;
+    if (!reader.listen(argv[1])) return 1;
+    std::cout << "[SHM] Listening on " << argv[1] << std::endl;
+
+    uint64_t audioFrames = 0, metadataFrames = 0, bytes = 0;
+    std::vector<uint64_t> latencies;
+    uint64_t windowStart = nowNs();
+
+    auto report = [&](uint64_t now) {
+        double seconds = (now - windowStart) / 1e9;
+        double p50 = 0, p99 = 0, max = 0;
+        if (!latencies.empty()) {
+            std::sort(latencies.begin(), latencies.end());
+            p50 = latencies[latencies.size() / 2] / 1000.0;
+            p99 = latencies[latencies.size() * 99 / 100] / 1000.0;
+            max = latencies.back() / 1000.0;
+        }
+        std::printf("[SHM] audio %.1f/s  metadata %.1f/s  %.1f KB/s  latency p50 %.1fus p99 %.1fus max %.1fus\n",
+                    audioFrames / seconds, metadataFrames / seconds, bytes / 1024.0 / seconds, p50, p99, max);
+        std::fflush(stdout);
+        audioFrames = metadataFrames = bytes = 0;
+        latencies.clear();
+        windowStart = now;
+    };
+
+    reader.run(
+        [&](const ShmReader::Frame& frame) {
+            uint64_t now = nowNs();
+            if (frame.type == shm::RecordType::Audio) audioFrames++;
+            else metadataFrames++;
+            bytes += frame.length;
+            latencies.push_back(now - frame.timestampNs);
+            if (now - windowStart >= 5000000000ULL) report(now);
+        },
+        [&](uint32_t id, bool connected) {
+            if (!connected) {
+                std::cout << "[SHM] Bot " << id << " disconnected (dropped " << reader.dropped(id) << ")" << std::endl;
+                return;
+            }
+            std::cout << "[SHM] Bot " << id << " connected" << std::endl;
+            for (const auto& command : commands) {
+                if (!reader.sendCommand(id, command)) {
+                    std::cerr << "[SHM] Could not send command to bot " << id << std::endl;
+                }
+            }
+        },
+        g_stop);
+
+    return 0;
+}
@@ -1,10 +1,67 @@
 #include "audio_raw_data_handler.h"
+#include "tracer.h"
 #include <cmath>
 #include <iostream>
 #include <nlohmann/json.hpp>
 
-AudioRawDataHandler::AudioRawDataHandler(ParticipantTracker& tracker, WSClient& wsClient)
-    : tracker_(tracker), wsClient_(wsClient) {}
+AudioRawDataHandler::AudioRawDataHandler(const Config& config, ParticipantTracker& tracker,
+                                         WSClient& wsClient, Metrics& metrics, RewindBuffer& rewind,
+                                         StateSnapshot& state, ParticipantArena& arena)
+    : tracker_(tracker), wsClient_(wsClient), metrics_(metrics),
+      workers_(config.streamWorkers, &arena),
+      election_(SPEECH_THRESHOLD),
+      detectChanges_(config.speakerChange),
+      changeDetector_(SPEECH_THRESHOLD),
+      statsIntervalMs_(config.statsIntervalMs),
+      channelMode_(AudioResampler::parseChannelMode(config.channelMode)),
+      driftEstimator_(AudioResampler::OUTPUT_SAMPLE_RATE),
+      driftCorrection_(config.driftCorrection),
+      driftResampler_(AudioResampler::OUTPUT_SAMPLE_RATE),
+      concealer_(AudioResampler::OUTPUT_SAMPLE_RATE, config.concealToleranceMs,
+                 config.discontinuityMs),
+      aggregator_(AudioResampler::OUTPUT_SAMPLE_RATE, config.frameMs, config.frameMaxLatencyMs,
+                  [this](const int16_t* samples, size_t count) {
+                      wsClient_.sendAudio(reinterpret_cast<const char*>(samples),
+                                          count * sizeof(int16_t));
+                  }),
+      rewind_(rewind),
+      state_(state),
+      resumeAnnounced_(!state.resumed()),
+      audioProfile_(ThreadProfile::parse(config.audioCpus, config.realtimePolicy,
+                                         config.realtimePriority)),
+      shedder_(config.cpuBudgetUs) {
+    // Size the per-callback buffers up front so the locked pages are the
+    // ones actually used (100ms resampled, 1s of concealment)
+    resampled_.reserve(AudioResampler::OUTPUT_SAMPLE_RATE / 10);
+    driftBuffer_.reserve(AudioResampler::OUTPUT_SAMPLE_RATE / 10);
+    concealBuffer_.reserve(AudioResampler::OUTPUT_SAMPLE_RATE);
+    changes_.reserve(4);
+    energies_.reserve(1024);
+    if (config.lockAudioMemory) {
+        lockMemory(resampled_.data(), resampled_.capacity() * sizeof(int16_t), "resample buffer");
+        lockMemory(driftBuffer_.data(), driftBuffer_.capacity() * sizeof(int16_t), "drift buffer");
+        lockMemory(concealBuffer_.data(), concealBuffer_.capacity() * sizeof(int16_t), "conceal buffer");
+        aggregator_.lockBuffer();
+    }
+    if (state.resumed()) concealer_.resumeAt(state.restoredPosition());
+}
+
+void AudioRawDataHandler::applyThreadProfile() {
+    // The SDK owns its callback threads; apply the profile the first time
+    // each one calls in
+    thread_local bool applied = false;
+    if (applied) return;
+    applied = true;
+    audioProfile_.applyToCurrentThread("audio");
+    Tracer::nameThread("sdk-audio");
+}
+
+void AudioRawDataHandler::recordCallback(AudioStats::Clock::time_point entry, bool mixed) {
+    uint64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        AudioStats::Clock::now() - entry).count();
+    if (mixed) callbackLatency_.record(micros);
+    shedder_.record(micros, mixed);
+}
 
 uint64_t AudioRawDataHandler::nowMs() const {
     return std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -12,76 +69,410 @@ uint64_t AudioRawDataHandler::nowMs() const {
     ).count();
 }
 
-double AudioRawDataHandler::computeRMS(const char* buffer, unsigned int bufferLen) {
-    const int16_t* samples = reinterpret_cast<const int16_t*>(buffer);
-    unsigned int sampleCount = bufferLen / sizeof(int16_t);
-    if (sampleCount == 0) return 0.0;
+void AudioRawDataHandler::onMixedAudioRawDataReceived(AudioRawData* data_) {
+    if (!data_) return;
+    TRACE_SCOPE("mixed_callback");
+    auto entry = AudioStats::Clock::now();
+    applyThreadProfile();
 
-    double sumSquares = 0.0;
-    for (unsigned int i = 0; i < sampleCount; i++) {
-        double s = static_cast<double>(samples[i]);
-        sumSquares += s * s;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        mixedStats_.addFrame(reinterpret_cast<const int16_t*>(data_->GetBuffer()),
+                             data_->GetBufferLen() / sizeof(int16_t),
+                             data_->GetSampleRate(), data_->GetChannelNum(),
+                             AudioStats::Clock::now());
+        driftReady_ = driftEstimator_.ready();
+        driftPpm_ = driftEstimator_.ppm();
+        correctionPpm_ = driftResampler_.correctionPpm();
+        streamPosition_ = concealer_.position();
     }
-    return std::sqrt(sumSquares / sampleCount);
-}
 
-void AudioRawDataHandler::onMixedAudioRawDataReceived(AudioRawData* data_) {
-    if (!data_ || !wsClient_.isConnected()) return;
+    uint64_t now = nowMs();
+    LoadShedder::Change change;
+    if (shedder_.evaluate(now, change)) reportLoadChange(change);
 
-    // Resample from SDK rate to 16kHz for Deepgram
-    auto resampled = AudioResampler::resample(
-        data_->GetBuffer(), data_->GetBufferLen(), data_->GetSampleRate());
+    // Keep processing while the gateway is unreachable: WSClient holds the
+    // most recent audio and replays it on reconnect
 
-    if (!resampled.empty()) {
-        wsClient_.sendAudio(
-            reinterpret_cast<const char*>(resampled.data()),
-            resampled.size() * sizeof(int16_t));
+    // Resample from SDK rate and channel layout to 16kHz mono for Deepgram
+    {
+        TRACE_SCOPE("resample");
+        resampler_.resample(data_->GetBuffer(), data_->GetBufferLen(), data_->GetSampleRate(),
+                            data_->GetChannelNum(), channelMode_, resampled_);
     }
+    correctDrift(entry);
+    if (resampled_.empty()) return;
+
+    // Fill any shortfall against the wall clock before the real frame
+    concealBuffer_.clear();
+    GapConcealer::Result gap;
+    {
+        TRACE_SCOPE("conceal");
+        gap = concealer_.conceal(AudioStats::Clock::now(), resampled_.size(), concealBuffer_);
+    }
+    if (gap.discontinuity) {
+        sendDiscontinuity(gap);
+    }
+    if (gap.trimmed > 0) {
+        // Late audio for a span that was already concealed
+        TRACE_COUNTER("audio.trimmed_samples", gap.trimmed);
+        trimmedWindowSamples_.fetch_add(gap.trimmed, std::memory_order_relaxed);
+        resampled_.erase(resampled_.begin(), resampled_.begin() + gap.trimmed);
+        if (resampled_.empty()) {
+            recordCallback(entry, true);
+            return;
+        }
+    }
+    // The frame ends now; the fill sits just before it
+    uint64_t frameStartMs = now - resampled_.size() * 1000 / AudioResampler::OUTPUT_SAMPLE_RATE;
+    if (!concealBuffer_.empty()) {
+        TRACE_COUNTER("audio.concealed_samples", concealBuffer_.size());
+        concealedWindowSamples_.fetch_add(concealBuffer_.size(), std::memory_order_relaxed);
+        aggregator_.push(concealBuffer_.data(), concealBuffer_.size());
+        rewind_.write(concealBuffer_.data(), concealBuffer_.size(),
+                      frameStartMs - concealBuffer_.size() * 1000 / AudioResampler::OUTPUT_SAMPLE_RATE);
+    }
+
+    concealer_.commit(resampled_.data(), resampled_.size());
+    {
+        TRACE_SCOPE("aggregate");
+        aggregator_.push(resampled_.data(), resampled_.size());
+    }
+    rewind_.write(resampled_.data(), resampled_.size(), frameStartMs);
+    if (detectChanges_) detectSpeakerChanges(now);
+    state_.setStreamPosition(concealer_.position(), now);
+    if (!resumeAnnounced_) sendStreamResumed();
+
+    recordCallback(entry, true);
 }
 
 void AudioRawDataHandler::onOneWayAudioRawDataReceived(AudioRawData* data_, uint32_t user_id) {
     if (!data_) return;
+    TRACE_SCOPE("one_way_callback");
+    auto entry = AudioStats::Clock::now();
+    applyThreadProfile();
 
-    // Compute RMS to detect if this participant is speaking
-    double rms = computeRMS(data_->GetBuffer(), data_->GetBufferLen());
-
-    if (rms > SPEECH_THRESHOLD) {
-        tracker_.markActive(user_id, nowMs());
+    // Stats and energy are computed by the stream workers (quality stats
+    // are skipped when shedding); energies finished so far join the election
+    bool reduced = shedder_.atLeast(LoadShedder::Level::ReduceVad);
+    uint64_t now = nowMs();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        workers_.dispatch(user_id, reinterpret_cast<const int16_t*>(data_->GetBuffer()),
+                          data_->GetBufferLen() / sizeof(int16_t), data_->GetSampleRate(),
+                          data_->GetChannelNum(), now, reduced);
+        electionStreams_ = election_.streams();
     }
+    energies_.clear();
+    workers_.drain(energies_);
+    for (const auto& e : energies_) election_.addEnergy(e.userId, e.sumSquares, e.samples, e.nowMs);
 
-    // Periodically decay inactive speakers and send updates
-    uint64_t now = nowMs();
-    if (now - lastSpeakerUpdateMs_ >= SPEAKER_UPDATE_INTERVAL_MS) {
+    // Periodically elect the current speakers, decay the rest and send updates
+    uint64_t interval = SPEAKER_UPDATE_INTERVAL_MS * (reduced ? REDUCED_VAD_FACTOR : 1);
+    if (now - lastSpeakerUpdateMs_ >= interval) {
+        TRACE_SCOPE("election");
+        auto start = std::chrono::steady_clock::now();
+        auto speakers = election_.elect(now);
+        electionLatency_.record(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        TRACE_COUNTER("audio.election.streams", election_.streams());
+
+        for (const auto& s : speakers) tracker_.markActive(s.userId, now);
         tracker_.decayActivity(now);
-        sendActiveSpeakerUpdate();
+        sendActiveSpeakerUpdate(speakers);
         lastSpeakerUpdateMs_ = now;
     }
+
+    recordCallback(entry, false);
 }
 
 void AudioRawDataHandler::onShareAudioRawDataReceived(AudioRawData* data_, uint32_t user_id) {
-    // Ignore screen share audio for now
+    // Share audio is not transcribed; only its quality is tracked, and it is
+    // the first thing dropped under load
+    if (!data_ || shedder_.atLeast(LoadShedder::Level::ShedShare)) return;
+    TRACE_SCOPE("share_callback");
+    auto entry = AudioStats::Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        shareStats_.addFrame(reinterpret_cast<const int16_t*>(data_->GetBuffer()),
+                             data_->GetBufferLen() / sizeof(int16_t),
+                             data_->GetSampleRate(), data_->GetChannelNum(),
+                             AudioStats::Clock::now());
+    }
+    recordCallback(entry, false);
 }
 
 void AudioRawDataHandler::onOneWayInterpreterAudioRawDataReceived(AudioRawData* data_, const zchar_t* pLanguageName) {
-    // Ignore interpreter audio for now
+    // Ignore interpreter audio for now (anything added here belongs to the
+    // ShedShare level)
+}
+
+void AudioRawDataHandler::correctDrift(AudioStats::Clock::time_point arrival) {
+    // Measured on what the SDK delivered, before any correction, so the
+    // estimate does not chase its own adjustments
+    TRACE_SCOPE("drift");
+    driftEstimator_.add(arrival, resampled_.size());
+    if (!driftCorrection_) return;
+
+    if (driftEstimator_.ready()) {
+        double ppm = driftEstimator_.ppm();
+        if (std::abs(ppm) > DriftResampler::MAX_PPM && !driftClampLogged_) {
+            std::cout << "[Audio] SDK audio clock is off by " << ppm << "ppm, correcting only "
+                      << DriftResampler::MAX_PPM << "ppm of it" << std::endl;
+            driftClampLogged_ = true;
+        }
+        driftResampler_.setTarget(ppm);
+    }
+    driftResampler_.process(resampled_.data(), resampled_.size(), driftBuffer_);
+    resampled_.swap(driftBuffer_);
+}
+
+void AudioRawDataHandler::detectSpeakerChanges(uint64_t now) {
+    // Fed exactly what was sent (fill included) so boundaries map onto
+    // stream positions; shed along with the speaker election
+    if (shedder_.atLeast(LoadShedder::Level::ReduceVad)) {
+        changeDetector_.skip(concealBuffer_.size() + resampled_.size());
+        return;
+    }
+
+    TRACE_SCOPE("speaker_change");
+    auto start = std::chrono::steady_clock::now();
+    changes_.clear();
+    if (!concealBuffer_.empty()) changeDetector_.push(concealBuffer_.data(), concealBuffer_.size(), changes_);
+    changeDetector_.push(resampled_.data(), resampled_.size(), changes_);
+    uint64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    changeLatency_.record(micros);
+    changeBusyUs_.fetch_add(micros, std::memory_order_relaxed);
+
+    for (const auto& change : changes_) sendSpeakerChange(change, now);
+}
+
+void AudioRawDataHandler::sendSpeakerChange(const SpeakerChangeDetector::Change& change, uint64_t now) {
+    changesReported_.fetch_add(1, std::memory_order_relaxed);
+
+    // position is in samples at the output rate, like audio_discontinuity;
+    // the boundary is samplesAgo before the end of the frame just sent
+    uint64_t agoMs = change.samplesAgo * 1000 / AudioResampler::OUTPUT_SAMPLE_RATE;
+    nlohmann::json msg;
+    msg["type"] = "speaker_change";
+    msg["timestamp"] = now - agoMs;
+    msg["position"] = concealer_.position() - change.samplesAgo;
+    msg["sampleRate"] = AudioResampler::OUTPUT_SAMPLE_RATE;
+    msg["latencyMs"] = agoMs;
+    msg["distance"] = std::round(change.distance * 10) / 10;
+    wsClient_.sendMetadata(msg);
 }
 
-void AudioRawDataHandler::sendActiveSpeakerUpdate() {
-    auto speakers = tracker_.getActiveSpeakers();
+void AudioRawDataHandler::sendActiveSpeakerUpdate(const std::vector<SpeakerElection::Candidate>& speakers) {
     if (speakers.empty()) return;
 
+    // Under metadata shedding, only send when the ranking changed
+    std::vector<uint32_t> ids;
+    for (const auto& s : speakers) ids.push_back(s.userId);
+    if (shedder_.atLeast(LoadShedder::Level::ReduceMetadata) && ids == lastSpeakerIds_) return;
+    lastSpeakerIds_ = std::move(ids);
+
     nlohmann::json msg;
     msg["type"] = "speaker_update";
     msg["timestamp"] = nowMs();
 
+    // Ranked, dominant speaker first
     nlohmann::json speakerArray = nlohmann::json::array();
     for (const auto& s : speakers) {
         speakerArray.push_back({
             {"userId", s.userId},
-            {"name", s.name}
+            {"name", tracker_.getName(s.userId)},
+            {"confidence", std::round(s.confidence * 100) / 100},
+            {"dominance", std::round(s.dominance * 100) / 100}
         });
     }
     msg["activeSpeakers"] = speakerArray;
 
     wsClient_.sendMetadata(msg);
 }
+
+void AudioRawDataHandler::publishAudioStats() {
+    TRACE_SCOPE("publishAudioStats");
+
+    // Take the windows under the lock and build the summary outside it, so
+    // the audio thread waits no longer than the copy
+    AudioStats::Summary mixed;
+    double stalledMs;
+    bool hasShare;
+    AudioStats::Summary share;
+    StreamWorkers::Counters workers;
+    bool driftReady;
+    double driftPpm;
+    double correctionPpm;
+    uint64_t streamPosition;
+    size_t electionStreams;
+    userSummaries_.clear();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        mixed = mixedStats_.summarize();
+        stalledMs = mixedStats_.stalledMs(AudioStats::Clock::now());
+        hasShare = shareStats_.hasFrames();
+        if (hasShare) share = shareStats_.summarize();
+        mixedStats_.resetWindow();
+        shareStats_.resetWindow();
+        workers_.takeStats(userSummaries_);
+        workers = workers_.takeCounters(statsIntervalMs_);
+        driftReady = driftReady_;
+        driftPpm = driftPpm_;
+        correctionPpm = correctionPpm_;
+        streamPosition = streamPosition_;
+        electionStreams = electionStreams_;
+    }
+    uint64_t concealedMs = concealedWindowSamples_.exchange(0, std::memory_order_relaxed) * 1000 /
+                           AudioResampler::OUTPUT_SAMPLE_RATE;
+    uint64_t trimmedMs = trimmedWindowSamples_.exchange(0, std::memory_order_relaxed) * 1000 /
+                         AudioResampler::OUTPUT_SAMPLE_RATE;
+
+    nlohmann::json msg;
+    msg["type"] = "audio_stats";
+    msg["timestamp"] = nowMs();
+    msg["intervalMs"] = statsIntervalMs_;
+    msg["mixed"] = mixed.toJson();
+    msg["mixed"]["concealedMs"] = concealedMs;
+    msg["mixed"]["trimmedMs"] = trimmedMs;
+    // Still waiting on the SDK for the next mixed frame; counted in gaps
+    // once it arrives
+    msg["mixed"]["stalledMs"] = static_cast<uint64_t>(stalledMs);
+    if (driftReady) msg["mixed"]["driftPpm"] = driftPpm;
+    msg["streamPosition"] = streamPosition;
+
+    if (hasShare) {
+        msg["share"] = share.toJson();
+    }
+
+    // Only users heard from in this window are reported
+    nlohmann::json users = nlohmann::json::array();
+    uint64_t userClipped = 0;
+    uint64_t userGaps = 0;
+    for (const auto& [userId, summary] : userSummaries_) {
+        auto entry = summary.toJson();
+        entry["userId"] = userId;
+        users.push_back(std::move(entry));
+        userClipped += summary.clippedSamples;
+        userGaps += summary.gaps;
+    }
+    msg["users"] = users;
+
+    metrics_.setGauge("audio.mixed.peak_dbfs", mixed.peakDbfs);
+    metrics_.setGauge("audio.mixed.rms_dbfs", mixed.rmsDbfs);
+    metrics_.setGauge("audio.mixed.noise_dbfs", mixed.noiseFloorDbfs);
+    metrics_.setGauge("audio.mixed.jitter_ms", mixed.jitterMs);
+    metrics_.setGauge("audio.mixed.max_interarrival_ms", mixed.maxInterArrivalMs);
+    metrics_.setGauge("audio.mixed.stalled_ms", stalledMs);
+    metrics_.addCounter("audio.mixed.clipped", mixed.clippedSamples);
+    metrics_.addCounter("audio.mixed.gaps", mixed.gaps);
+    metrics_.addCounter("audio.mixed.concealed_ms", concealedMs);
+    metrics_.addCounter("audio.mixed.trimmed_ms", trimmedMs);
+    if (driftReady) metrics_.setGauge("audio.drift.ppm", driftPpm);
+    if (driftCorrection_) metrics_.setGauge("audio.drift.correction_ppm", correctionPpm);
+    metrics_.setGauge("audio.users.streams", static_cast<double>(users.size()));
+    metrics_.addCounter("audio.users.clipped", userClipped);
+    metrics_.addCounter("audio.users.gaps", userGaps);
+
+    auto framing = aggregator_.takeStats();
+    double intervalSec = statsIntervalMs_ / 1000.0;
+    metrics_.setGauge("ws.audio_frames_per_s", framing.frames / intervalSec);
+    metrics_.setGauge("ws.frame_latency_mean_ms", framing.meanLatencyMs);
+    metrics_.setGauge("ws.frame_latency_max_ms", framing.maxLatencyMs);
+    metrics_.addCounter("ws.partial_frames", framing.partialFrames);
+
+    auto callback = callbackLatency_.take();
+    metrics_.setGauge("audio.callback_us_p50", callback.p50Us);
+    metrics_.setGauge("audio.callback_us_p99", callback.p99Us);
+    metrics_.setGauge("audio.callback_us_max", callback.maxUs);
+
+    if (workers_.size() > 0) {
+        metrics_.setGauge("audio.workers.busy_pct", workers.busyPct);
+        metrics_.addCounter("audio.workers.steals", workers.steals);
+    }
+    metrics_.addCounter("audio.users.frames", workers.frames);
+    metrics_.addCounter("audio.users.dropped", workers.dropped);
+
+    auto election = electionLatency_.take();
+    metrics_.setGauge("audio.election.streams", static_cast<double>(electionStreams));
+    metrics_.setGauge("audio.election.us_p50", election.p50Us);
+    metrics_.setGauge("audio.election.us_max", election.maxUs);
+
+    if (detectChanges_) {
+        auto change = changeLatency_.take();
+        metrics_.setGauge("audio.speaker_change.us_p50", change.p50Us);
+        metrics_.setGauge("audio.speaker_change.us_max", change.maxUs);
+        metrics_.setGauge("audio.speaker_change.cpu_pct",
+                          changeBusyUs_.exchange(0, std::memory_order_relaxed) / (statsIntervalMs_ * 10.0));
+        metrics_.addCounter("audio.speaker_changes", changesReported_.exchange(0, std::memory_order_relaxed));
+    }
+
+    if (rewind_.enabled()) metrics_.setGauge("rewind.held_s", rewind_.heldSeconds());
+
+    metrics_.setGauge("load.level", static_cast<double>(shedder_.level()));
+    metrics_.setGauge("load.cycle_us", shedder_.lastCycleUs());
+
+    // Metrics keep their cadence; the gateway gets fewer summaries
+    if (shedder_.atLeast(LoadShedder::Level::ReduceMetadata) &&
+        ++statsReportsSkipped_ < REDUCED_STATS_EVERY) {
+        return;
+    }
+    statsReportsSkipped_ = 0;
+    wsClient_.sendMetadata(msg);
+}
+
+void AudioRawDataHandler::reportLoadChange(const LoadShedder::Change& change) {
+    bool shedding = change.level > change.previous;
+    std::cout << "[Load] " << (shedding ? "Shedding to " : "Restoring to ")
+              << LoadShedder::name(change.level) << ": " << static_cast<int>(change.cycleUs)
+              << "us per mixed callback, budget " << shedder_.budgetUs() << "us" << std::endl;
+    metrics_.addCounter(shedding ? "load.sheds" : "load.restores");
+
+    nlohmann::json msg;
+    msg["type"] = "load_shedding";
+    msg["timestamp"] = nowMs();
+    msg["level"] = static_cast<int>(change.level);
+    msg["name"] = LoadShedder::name(change.level);
+    msg["cycleUs"] = static_cast<uint64_t>(change.cycleUs);
+    msg["budgetUs"] = shedder_.budgetUs();
+    wsClient_.sendMetadata(msg);
+}
+
+void AudioRawDataHandler::sendStreamResumed() {
+    resumeAnnounced_ = true;
+    std::cout << "[Audio] Stream resumed at sample " << state_.restoredPosition() << " after a "
+              << state_.downtimeMs() << "ms restart" << std::endl;
+
+    // The restart's downtime is a gap in the meeting timeline that nothing
+    // filled; positions before and after it belong to one stream
+    nlohmann::json msg;
+    msg["type"] = "stream_resumed";
+    msg["timestamp"] = nowMs();
+    msg["position"] = state_.restoredPosition();
+    msg["sampleRate"] = AudioResampler::OUTPUT_SAMPLE_RATE;
+    msg["downMs"] = state_.downtimeMs();
+    msg["participants"] = state_.restoredParticipants().size();
+    wsClient_.sendMetadata(msg);
+}
+
+void AudioRawDataHandler::sendDiscontinuity(const GapConcealer::Result& gap) {
+    std::cout << "[Audio] " << (gap.ahead ? "Stream ahead by " : "Discontinuity of ") << gap.gapMs
+              << "ms at sample " << gap.position
+              << (gap.resynced ? " (timeline re-anchored)" : gap.ahead ? " (trimmed)" : " (concealed)")
+              << std::endl;
+    metrics_.addCounter("audio.mixed.discontinuities");
+
+    // position is in samples at the output rate; concealed=false means the
+    // gap was NOT filled (or, ahead, not trimmed) and downstream timestamps
+    // must be shifted by gapMs: later, or earlier when ahead
+    nlohmann::json msg;
+    msg["type"] = "audio_discontinuity";
+    msg["timestamp"] = nowMs();
+    msg["position"] = gap.position;
+    msg["sampleRate"] = AudioResampler::OUTPUT_SAMPLE_RATE;
+    msg["gapMs"] = static_cast<uint64_t>(gap.gapMs);
+    msg["ahead"] = gap.ahead;
+    msg["concealed"] = !gap.resynced;
+    wsClient_.sendMetadata(msg);
+}
@@ -5,12 +5,32 @@
 #include "participant_tracker.h"
 #include "ws_client.h"
 #include "audio_resampler.h"
+#include "audio_stats.h"
+#include "gap_concealer.h"
+#include "drift_estimator.h"
+#include "drift_resampler.h"
+#include "frame_aggregator.h"
+#include "config.h"
+#include "metrics.h"
+#include "thread_profile.h"
+#include "latency_recorder.h"
+#include "speaker_election.h"
+#include "speaker_change_detector.h"
+#include "load_shedder.h"
+#include "rewind_buffer.h"
+#include "state_snapshot.h"
+#include "participant_arena.h"
+#include "stream_workers.h"
 #include <chrono>
 #include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 class AudioRawDataHandler : public ZOOMSDK::IZoomSDKAudioRawDataDelegate {
 public:
-    AudioRawDataHandler(ParticipantTracker& tracker, WSClient& wsClient);
+    AudioRawDataHandler(const Config& config, ParticipantTracker& tracker, WSClient& wsClient,
+                        Metrics& metrics, RewindBuffer& rewind, StateSnapshot& state,
+                        ParticipantArena& arena);
 
     // IZoomSDKAudioRawDataDelegate callbacks
     void onMixedAudioRawDataReceived(AudioRawData* data_) override;
@@ -18,16 +38,107 @@ public:
     void onShareAudioRawDataReceived(AudioRawData* data_, uint32_t user_id) override;
     void onOneWayInterpreterAudioRawDataReceived(AudioRawData* data_, const zchar_t* pLanguageName) override;
 
+    // Called from the main loop so partial frames do not wait indefinitely
+    void flushStaleAudio() { aggregator_.flushStale(); }
+
+    // Called from the main loop every statsIntervalMs, so the summary goes
+    // out even while the SDK has stopped calling back
+    void publishAudioStats();
+
 private:
     ParticipantTracker& tracker_;
     WSClient& wsClient_;
+    Metrics& metrics_;
     uint64_t lastSpeakerUpdateMs_ = 0;
     static constexpr uint64_t SPEAKER_UPDATE_INTERVAL_MS = 300;
+    static constexpr uint64_t REDUCED_VAD_FACTOR = 4;   // elections every 1.2s when shedding
 
-    // Compute RMS energy of audio buffer to detect speech
-    static double computeRMS(const char* buffer, unsigned int bufferLen);
+    // Per-participant one-way processing, spread over worker threads; the
+    // energies it hands back feed the election here
+    StreamWorkers workers_;
+    std::vector<StreamWorkers::Energy> energies_;
+    std::vector<std::pair<uint32_t, AudioStats::Summary>> userSummaries_;
+
+    // Dominant-speaker election over the one-way streams
+    SpeakerElection election_;
+    LatencyRecorder electionLatency_;
     static constexpr double SPEECH_THRESHOLD = 200.0; // RMS threshold for speech detection
 
+    // Turn boundaries in the outgoing mixed stream, independent of user ids
+    bool detectChanges_;
+    SpeakerChangeDetector changeDetector_;
+    std::vector<SpeakerChangeDetector::Change> changes_;
+    LatencyRecorder changeLatency_;
+    std::atomic<uint64_t> changeBusyUs_{0};     // in the current stats window
+    std::atomic<uint64_t> changesReported_{0};  // likewise
+
+    // Per-stream audio quality and callback timing telemetry, fed on the SDK
+    // audio thread and published from the main loop. statsMutex_ also keeps
+    // workers_' dispatch() apart from its takeStats() and takeCounters().
+    std::mutex statsMutex_;
+    AudioStats mixedStats_;
+    AudioStats shareStats_;
+    uint64_t statsIntervalMs_;
+
+    // Audio-thread state for the summary, copied under statsMutex_ on each
+    // callback, so as of the one before
+    bool driftReady_ = false;
+    double driftPpm_ = 0.0;
+    double correctionPpm_ = 0.0;
+    uint64_t streamPosition_ = 0;
+    size_t electionStreams_ = 0;
+
+    // Mixed stream input handling; the resampler carries state between
+    // callbacks and its buffer is reused per callback
+    AudioResampler::ChannelMode channelMode_;
+    AudioResampler resampler_;
+    std::vector<int16_t> resampled_;
+
+    // SDK audio clock measured against ours; with correction on, the mixed
+    // stream is resampled to match, so sample counts track the wall clock
+    DriftEstimator driftEstimator_;
+    bool driftCorrection_;
+    DriftResampler driftResampler_;
+    std::vector<int16_t> driftBuffer_;
+    bool driftClampLogged_ = false;
+
+    // Keeps the mixed stream continuous when callbacks are late or skipped
+    GapConcealer concealer_;
+    std::vector<int16_t> concealBuffer_;
+    std::atomic<uint64_t> concealedWindowSamples_{0};
+    std::atomic<uint64_t> trimmedWindowSamples_{0};
+
+    // Coalesces outgoing audio into fixed-duration WebSocket frames
+    FrameAggregator aggregator_;
+
+    // Keeps a copy of the outgoing stream for re-transcription
+    RewindBuffer& rewind_;
+
+    // Stream position saved for a warm restart; after one, positions carry
+    // on from the saved one and the gateway is told once audio flows
+    StateSnapshot& state_;
+    bool resumeAnnounced_;
+
+    // Scheduling profile applied to whichever thread the SDK calls us on,
+    // and the time from mixed-audio callback entry to hand-off to WSClient
+    ThreadProfile audioProfile_;
+    LatencyRecorder callbackLatency_;
+
+    // Sheds optional work when the callbacks overrun their CPU budget
+    LoadShedder shedder_;
+    std::vector<uint32_t> lastSpeakerIds_;    // last speaker_update sent, in rank order
+    unsigned int statsReportsSkipped_ = 0;
+    static constexpr unsigned int REDUCED_STATS_EVERY = 4;
+
+    void applyThreadProfile();
+    void recordCallback(AudioStats::Clock::time_point entry, bool mixed);
+    void reportLoadChange(const LoadShedder::Change& change);
+
     uint64_t nowMs() const;
-    void sendActiveSpeakerUpdate();
+    void sendActiveSpeakerUpdate(const std::vector<SpeakerElection::Candidate>& speakers);
+    void sendDiscontinuity(const GapConcealer::Result& gap);
+    void detectSpeakerChanges(uint64_t now);
+    void correctDrift(AudioStats::Clock::time_point arrival);
+    void sendSpeakerChange(const SpeakerChangeDetector::Change& change, uint64_t now);
+    void sendStreamResumed();
 };
@@ -1,29 +1,237 @@
 #include "audio_resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <climits>
 
-std::vector<int16_t> AudioResampler::resample(const char* buffer, unsigned int bufferLen,
-                                               unsigned int inputSampleRate) {
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Mono value of one interleaved frame, before scaling
+inline int32_t frameValue(const int16_t* frame, unsigned int channels,
+                          AudioResampler::ChannelMode mode) {
+    switch (mode) {
+        case AudioResampler::ChannelMode::Left:
+            return frame[0];
+        case AudioResampler::ChannelMode::Right:
+            return frame[channels > 1 ? 1 : 0];
+        case AudioResampler::ChannelMode::Mix:
+        default: {
+            int32_t sum = 0;
+            for (unsigned int c = 0; c < channels; c++) sum += frame[c];
+            return sum;
+        }
+    }
+}
+
+inline int16_t scaleToSample(int32_t sum, float scale) {
+    long v = std::lrintf(static_cast<float>(sum) * scale);
+    return static_cast<int16_t>(std::clamp<long>(v, INT16_MIN, INT16_MAX));
+}
+
+#if defined(__SSE2__)
+// Scale four int32 sums and store them as four int16 samples
+inline void storeScaled4(int16_t* out, __m128i sums, __m128 scale) {
+    __m128i scaled = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(sums), scale));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packs_epi32(scaled, scaled));
+}
+
+// Sum adjacent int32 lanes of a and b: [a0+a1, a2+a3, b0+b1, b2+b3]
+inline __m128i pairwiseAdd(__m128i a, __m128i b) {
+    __m128 fa = _mm_castsi128_ps(a);
+    __m128 fb = _mm_castsi128_ps(b);
+    __m128i even = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0)));
+    __m128i odd = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1)));
+    return _mm_add_epi32(even, odd);
+}
+
+// _mm_madd_epi16 coefficients that reduce an (L, R) pair to one int32
+inline __m128i stereoCoefficients(AudioResampler::ChannelMode mode) {
+    switch (mode) {
+        case AudioResampler::ChannelMode::Left:  return _mm_set1_epi32(0x00000001);
+        case AudioResampler::ChannelMode::Right: return _mm_set1_epi32(0x00010000);
+        case AudioResampler::ChannelMode::Mix:
+        default:                                 return _mm_set1_epi16(1);
+    }
+}
+#endif
+
+} // namespace
+
+AudioResampler::ChannelMode AudioResampler::parseChannelMode(const std::string& name) {
+    if (name == "left") return ChannelMode::Left;
+    if (name == "right") return ChannelMode::Right;
+    return ChannelMode::Mix;
+}
+
+void AudioResampler::reset() {
+    rate_ = 0;
+    channels_ = 0;
+    mode_ = ChannelMode::Mix;
+    carrySum_ = 0;
+    carryFrames_ = 0;
+    outputs_ = 0;
+    inputs_ = 0;
+    lastFrame_ = 0;
+}
+
+void AudioResampler::resample(const char* buffer, unsigned int bufferLen,
+                              unsigned int inputSampleRate, unsigned int channels,
+                              ChannelMode mode, std::vector<int16_t>& out) {
+    out.clear();
     const int16_t* samples = reinterpret_cast<const int16_t*>(buffer);
-    unsigned int sampleCount = bufferLen / sizeof(int16_t);
+    if (channels == 0) channels = 1;
+    size_t frames = bufferLen / sizeof(int16_t) / channels;
+    if (frames == 0 || inputSampleRate == 0) return;
+
+    if (inputSampleRate != rate_ || channels != channels_ || mode != mode_) {
+        // Nothing carried over applies to a different format
+        reset();
+        rate_ = inputSampleRate;
+        channels_ = channels;
+        mode_ = mode;
+    }
 
-    if (inputSampleRate == 16000) {
+    if (inputSampleRate == OUTPUT_SAMPLE_RATE && channels == 1) {
         // No resampling needed
-        return std::vector<int16_t>(samples, samples + sampleCount);
+        out.assign(samples, samples + frames);
+        return;
+    }
+
+    if (inputSampleRate % OUTPUT_SAMPLE_RATE == 0) {
+        decimate(samples, frames, inputSampleRate / OUTPUT_SAMPLE_RATE, out);
+    } else {
+        // 44.1 kHz family, or rates below 16 kHz
+        interpolate(samples, frames, out);
     }
+}
+
+void AudioResampler::decimate(const int16_t* in, size_t frames, unsigned int ratio,
+                              std::vector<int16_t>& out) {
+    unsigned int perFrame = (mode_ == ChannelMode::Mix) ? channels_ : 1;
+    float scale = 1.0f / static_cast<float>(ratio * perFrame);
 
-    unsigned int ratio = inputSampleRate / 16000;
-    if (ratio == 0) ratio = 1;
+    size_t first = 0;
+    if (carryFrames_ > 0) {
+        // Finish the output sample the last call started
+        first = std::min<size_t>(ratio - carryFrames_, frames);
+        for (size_t i = 0; i < first; i++) carrySum_ += frameValue(in + i * channels_, channels_, mode_);
+        carryFrames_ += static_cast<unsigned int>(first);
+        if (carryFrames_ < ratio) return;
+        out.push_back(scaleToSample(carrySum_, scale));
+        carrySum_ = 0;
+        carryFrames_ = 0;
+    }
 
-    std::vector<int16_t> output;
-    output.reserve(sampleCount / ratio);
+    size_t outCount = (frames - first) / ratio;
+    size_t o = out.size();
+    out.resize(o + outCount);
+    decimateAligned(in + first * channels_, channels_, mode_, ratio, out.data() + o, outCount);
 
-    // Simple averaging decimation filter
-    for (unsigned int i = 0; i + ratio <= sampleCount; i += ratio) {
+    // Frames short of a whole output sample wait for the next call
+    for (size_t i = first + outCount * ratio; i < frames; i++) {
+        carrySum_ += frameValue(in + i * channels_, channels_, mode_);
+        carryFrames_++;
+    }
+}
+
+void AudioResampler::decimateAligned(const int16_t* in, unsigned int channels, ChannelMode mode,
+                                     unsigned int ratio, int16_t* out, size_t outCount) const {
+    // Averaging decimation filter over ratio frames, with the channel
+    // reduction folded into the same sum
+    unsigned int perFrame = (mode == ChannelMode::Mix) ? channels : 1;
+    float scale = 1.0f / static_cast<float>(ratio * perFrame);
+    size_t o = 0;
+
+#if defined(__SSE2__)
+    __m128 vscale = _mm_set1_ps(scale);
+    if (vectorized_ && channels == 2 && (ratio == 1 || ratio == 2)) {
+        __m128i coef = stereoCoefficients(mode);
+        if (ratio == 1) {
+            // 4 frames (8 samples) -> 4 outputs
+            for (; o + 4 <= outCount; o += 4) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + o * 2));
+                storeScaled4(out + o, _mm_madd_epi16(v, coef), vscale);
+            }
+        } else {
+            // 8 frames (16 samples) -> 4 outputs
+            for (; o + 4 <= outCount; o += 4) {
+                const int16_t* p = in + o * 4;
+                __m128i a = _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), coef);
+                __m128i b = _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8)), coef);
+                storeScaled4(out + o, pairwiseAdd(a, b), vscale);
+            }
+        }
+    } else if (vectorized_ && channels == 1 && ratio == 2) {
+        // 8 samples -> 4 outputs
+        __m128i ones = _mm_set1_epi16(1);
+        for (; o + 4 <= outCount; o += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + o * 2));
+            storeScaled4(out + o, _mm_madd_epi16(v, ones), vscale);
+        }
+    }
+#endif
+
+    // Scalar path: remaining outputs, ratios/channel counts without a kernel,
+    // and everything when not vectorized
+    for (; o < outCount; o++) {
+        const int16_t* frame = in + o * ratio * channels;
         int32_t sum = 0;
         for (unsigned int j = 0; j < ratio; j++) {
-            sum += samples[i + j];
+            sum += frameValue(frame + j * channels, channels, mode);
+        }
+        out[o] = scaleToSample(sum, scale);
+    }
+}
+
+void AudioResampler::interpolate(const int16_t* in, size_t frames, std::vector<int16_t>& out) {
+    unsigned int perFrame = (mode_ == ChannelMode::Mix) ? channels_ : 1;
+    const uint64_t endFrame = inputs_ + frames;  // one past this call's last frame
+    auto value = [&](uint64_t frame) {
+        return frame < inputs_ ? lastFrame_ : frameValue(in + (frame - inputs_) * channels_, channels_, mode_);
+    };
+
+    if (rate_ > OUTPUT_SAMPLE_RATE) {
+        // Box filter over the input span covered by each output sample; a
+        // span that runs past this call is summed so far and finished by the
+        // next one
+        for (;;) {
+            uint64_t begin = outputs_ * rate_ / OUTPUT_SAMPLE_RATE;
+            uint64_t end = (outputs_ + 1) * rate_ / OUTPUT_SAMPLE_RATE;
+            int32_t sum = carrySum_;
+            for (uint64_t i = std::max(begin, inputs_); i < std::min(end, endFrame); i++) sum += value(i);
+            if (end > endFrame) {
+                carrySum_ = sum;
+                break;
+            }
+            carrySum_ = 0;
+            out.push_back(scaleToSample(sum, 1.0f / static_cast<float>((end - begin) * perFrame)));
+            outputs_++;
         }
-        output.push_back(static_cast<int16_t>(sum / static_cast<int32_t>(ratio)));
+    } else {
+        // Linear interpolation when upsampling; an output between this
+        // call's last frame and the next call's first waits for that call
+        float scale = 1.0f / static_cast<float>(perFrame);
+        for (;;) {
+            uint64_t position = outputs_ * rate_;
+            uint64_t i = position / OUTPUT_SAMPLE_RATE;
+            if (i + 1 >= endFrame) break;
+            double frac = static_cast<double>(position % OUTPUT_SAMPLE_RATE) / OUTPUT_SAMPLE_RATE;
+            double a = value(i);
+            double b = value(i + 1);
+            out.push_back(scaleToSample(static_cast<int32_t>(std::lround(a + (b - a) * frac)), scale));
+            outputs_++;
+        }
+        lastFrame_ = value(endFrame - 1);
     }
 
-    return output;
+    // Count from the start of the stream less whole seconds, which shifts
+    // both indexes by exactly one second's worth
+    inputs_ = endFrame;
+    while (outputs_ >= OUTPUT_SAMPLE_RATE && inputs_ >= rate_) {
+        outputs_ -= OUTPUT_SAMPLE_RATE;
+        inputs_ -= rate_;
+    }
 }
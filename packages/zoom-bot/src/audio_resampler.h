@@ -1,13 +1,61 @@
 #pragma once
 
 #include <vector>
+#include <string>
 #include <cstdint>
+#include <cstddef>
 
+// Converts SDK raw audio to 16000 Hz mono, one callback at a time. The
+// conversion continues across calls: input frames that do not make up a
+// whole output sample, and the position between input frames when the
+// ratio is not an integer, are carried into the next call, so callback
+// boundaries neither drop nor repeat samples and the output count never
+// drifts from the input rate. A change of rate, channel count or mode
+// starts over. Not thread-safe: one instance per stream.
 class AudioResampler {
 public:
-    // Downsample from inputRate to 16000 Hz
-    // Input: 16-bit signed PCM mono samples
-    // Returns: resampled 16-bit signed PCM at 16kHz
-    static std::vector<int16_t> resample(const char* buffer, unsigned int bufferLen,
-                                          unsigned int inputSampleRate);
+    static constexpr unsigned int OUTPUT_SAMPLE_RATE = 16000;
+
+    // How multi-channel input is reduced to mono
+    enum class ChannelMode { Mix, Left, Right };
+    static ChannelMode parseChannelMode(const std::string& name);
+
+    // vectorized=false keeps to the scalar loops even where an SSE2 kernel
+    // exists, to check the kernels against them
+    explicit AudioResampler(bool vectorized = true) : vectorized_(vectorized) {}
+
+    // Resample to 16000 Hz mono into out, replacing its contents, so callers
+    // can reuse its capacity. Input: interleaved 16-bit signed PCM with 1 or
+    // 2 channels. Downmix or channel selection is fused into the decimation
+    // loop, so stereo input costs no extra pass over memory.
+    void resample(const char* buffer, unsigned int bufferLen,
+                  unsigned int inputSampleRate, unsigned int channels,
+                  ChannelMode mode, std::vector<int16_t>& out);
+
+    // Forget what was carried over from earlier calls
+    void reset();
+
+private:
+    bool vectorized_;
+
+    // Input format of the last call
+    unsigned int rate_ = 0;
+    unsigned int channels_ = 0;
+    ChannelMode mode_ = ChannelMode::Mix;
+
+    // Integer ratios: frames of an output sample not yet complete
+    int32_t carrySum_ = 0;
+    unsigned int carryFrames_ = 0;
+
+    // Other ratios: output o reads input frames from o * rate / 16000 on,
+    // counted from the start of the stream (less whole seconds), and the
+    // last input frame is kept for outputs that straddle two calls
+    uint64_t outputs_ = 0;   // index of the next output sample
+    uint64_t inputs_ = 0;    // index of this call's first input frame
+    int32_t lastFrame_ = 0;  // mono value of the previous call's last frame
+
+    void decimate(const int16_t* in, size_t frames, unsigned int ratio, std::vector<int16_t>& out);
+    void decimateAligned(const int16_t* in, unsigned int channels, ChannelMode mode,
+                         unsigned int ratio, int16_t* out, size_t outCount) const;
+    void interpolate(const int16_t* in, size_t frames, std::vector<int16_t>& out);
 };
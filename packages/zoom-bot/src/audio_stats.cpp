@@ -0,0 +1,107 @@
+#include "audio_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+double toDbfs(double amplitude) {
+    if (amplitude <= 0.0) return -120.0;
+    return std::max(-120.0, 20.0 * std::log10(amplitude / 32768.0));
+}
+
+static double round1(double v) {
+    return std::round(v * 10.0) / 10.0;
+}
+
+void AudioStats::addFrame(const int16_t* samples, size_t count, unsigned int sampleRate,
+                          unsigned int channels, Clock::time_point arrival) {
+    if (count == 0) return;
+
+    // Single pass: sum of squares, peak and clipping
+    int64_t sumSquares = 0;
+    int32_t peak = 0;
+    uint64_t clipped = 0;
+    for (size_t i = 0; i < count; i++) {
+        int32_t s = samples[i];
+        int32_t a = s < 0 ? -s : s;
+        sumSquares += static_cast<int64_t>(s) * s;
+        peak = std::max(peak, a);
+        clipped += (a >= CLIP_LEVEL) ? 1 : 0;
+    }
+
+    frames_++;
+    samples_ += count;
+    clipped_ += clipped;
+    peak_ = std::max(peak_, peak);
+    sumSquares_ += static_cast<double>(sumSquares);
+
+    // Noise floor: follow quiet frames immediately, rise slowly on loud ones
+    double frameRms = std::sqrt(static_cast<double>(sumSquares) / count);
+    if (noiseFloorRms_ < 0.0 || frameRms < noiseFloorRms_) {
+        noiseFloorRms_ = frameRms;
+    } else {
+        noiseFloorRms_ += (frameRms - noiseFloorRms_) * NOISE_FLOOR_RISE;
+    }
+
+    // Callback timing, relative to the duration of the previous frame
+    if (hasLastArrival_) {
+        double deltaMs = std::chrono::duration<double, std::milli>(arrival - lastArrival_).count();
+        double deviation = std::abs(deltaMs - lastFrameMs_);
+        jitterMs_ += (deviation - jitterMs_) / 16.0;
+        maxInterArrivalMs_ = std::max(maxInterArrivalMs_, deltaMs);
+        if (deltaMs - lastFrameMs_ >= GAP_MIN_MS && deltaMs > 2.0 * lastFrameMs_) {
+            gaps_++;
+            gapMs_ += deltaMs - lastFrameMs_;
+        }
+    }
+    hasLastArrival_ = true;
+    lastArrival_ = arrival;
+    unsigned int ch = channels ? channels : 1;
+    lastFrameMs_ = sampleRate ? (1000.0 * (count / ch)) / sampleRate : 0.0;
+}
+
+AudioStats::Summary AudioStats::summarize() const {
+    Summary s;
+    s.frames = frames_;
+    s.samples = samples_;
+    s.clippedSamples = clipped_;
+    s.peakDbfs = toDbfs(peak_);
+    s.rmsDbfs = samples_ ? toDbfs(std::sqrt(sumSquares_ / samples_)) : -120.0;
+    s.noiseFloorDbfs = toDbfs(noiseFloorRms_);
+    s.jitterMs = jitterMs_;
+    s.maxInterArrivalMs = maxInterArrivalMs_;
+    s.gaps = gaps_;
+    s.gapMs = gapMs_;
+    return s;
+}
+
+double AudioStats::stalledMs(Clock::time_point now) const {
+    if (!hasLastArrival_) return 0.0;
+    double sinceMs = std::chrono::duration<double, std::milli>(now - lastArrival_).count();
+    double overdueMs = sinceMs - lastFrameMs_;
+    return overdueMs >= GAP_MIN_MS && sinceMs > 2.0 * lastFrameMs_ ? overdueMs : 0.0;
+}
+
+void AudioStats::resetWindow() {
+    frames_ = 0;
+    samples_ = 0;
+    clipped_ = 0;
+    peak_ = 0;
+    sumSquares_ = 0.0;
+    maxInterArrivalMs_ = 0.0;
+    gaps_ = 0;
+    gapMs_ = 0.0;
+}
+
+nlohmann::json AudioStats::Summary::toJson() const {
+    return {
+        {"frames", frames},
+        {"clipped", clippedSamples},
+        {"peakDbfs", round1(peakDbfs)},
+        {"rmsDbfs", round1(rmsDbfs)},
+        {"noiseDbfs", round1(noiseFloorDbfs)},
+        {"jitterMs", round1(jitterMs)},
+        {"maxGapMs", round1(maxInterArrivalMs)},
+        {"gaps", gaps},
+        {"gapMs", round1(gapMs)}
+    };
+}
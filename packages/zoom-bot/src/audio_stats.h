@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+
+// Incremental audio quality and callback timing statistics for one stream.
+// addFrame() does a single pass over the samples, so it is cheap enough to
+// run on every SDK callback. Not thread-safe: the mixed and share streams
+// are fed on the SDK audio thread and summarised on the main loop, both
+// holding AudioRawDataHandler's statsMutex_; one-way streams are fed by a
+// stream worker and summarised on the main loop, both holding that
+// participant's Mailbox::statsMutex (see StreamWorkers).
+class AudioStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Summary {
+        uint64_t frames = 0;
+        uint64_t samples = 0;
+        uint64_t clippedSamples = 0;
+        double peakDbfs = -120.0;
+        double rmsDbfs = -120.0;
+        double noiseFloorDbfs = -120.0;
+        double jitterMs = 0.0;         // smoothed inter-arrival deviation (RFC 3550 style)
+        double maxInterArrivalMs = 0.0;
+        uint64_t gaps = 0;             // callbacks that arrived well after the previous frame ended
+        double gapMs = 0.0;
+
+        nlohmann::json toJson() const;
+    };
+
+    // Interleaved 16-bit PCM as delivered by the SDK
+    void addFrame(const int16_t* samples, size_t count, unsigned int sampleRate,
+                  unsigned int channels, Clock::time_point arrival);
+
+    // Statistics accumulated since the last resetWindow()
+    Summary summarize() const;
+
+    // Start a new reporting window. Noise floor, jitter and arrival history
+    // carry over so they stay continuous across windows.
+    void resetWindow();
+
+    bool hasFrames() const { return frames_ > 0; }
+
+    // How long the next frame is overdue at now, if by enough to count as a
+    // gap once it arrives; 0 while frames are on time or before the first
+    double stalledMs(Clock::time_point now) const;
+
+private:
+    // Window accumulators
+    uint64_t frames_ = 0;
+    uint64_t samples_ = 0;
+    uint64_t clipped_ = 0;
+    int32_t peak_ = 0;
+    double sumSquares_ = 0.0;
+    double maxInterArrivalMs_ = 0.0;
+    uint64_t gaps_ = 0;
+    double gapMs_ = 0.0;
+
+    // Continuous state
+    double noiseFloorRms_ = -1.0;  // < 0 until the first frame
+    double jitterMs_ = 0.0;
+    bool hasLastArrival_ = false;
+    Clock::time_point lastArrival_;
+    double lastFrameMs_ = 0.0;
+
+    static constexpr int16_t CLIP_LEVEL = 32767;
+    static constexpr double NOISE_FLOOR_RISE = 0.002; // per-frame rise rate towards louder frames
+    static constexpr double GAP_MIN_MS = 20.0;        // lateness beyond frame duration counted as a gap
+};
+
+// Convert a linear 16-bit amplitude to dBFS (clamped at -120)
+double toDbfs(double amplitude);
@@ -4,6 +4,7 @@
 #include <cstdlib>
 #include <algorithm>
 #include <filesystem>
+#include <thread>
 #include <vector>
 
 static std::string trim(const std::string& s) {
@@ -50,6 +51,17 @@ std::string Config::getEnv(const std::string& key, const std::string& defaultVal
     return val ? std::string(val) : defaultVal;
 }
 
+uint64_t Config::getEnvUInt(const std::string& key, uint64_t defaultVal) {
+    std::string val = getEnv(key);
+    if (val.empty()) return defaultVal;
+    try {
+        return std::stoull(val);
+    } catch (const std::exception&) {
+        std::cerr << "[Config] Ignoring invalid " << key << "=" << val << std::endl;
+        return defaultVal;
+    }
+}
+
 Config Config::load(int argc, char* argv[]) {
     // Try to find .env file
     std::vector<std::string> envPaths = {
@@ -72,6 +84,42 @@ Config Config::load(int argc, char* argv[]) {
     config.sdkSecret = getEnv("ZOOM_SDK_SECRET");
     config.displayName = getEnv("ZOOM_BOT_NAME", "Transcription Bot");
     config.gatewayUrl = "ws://localhost:" + getEnv("GATEWAY_WS_PORT", "8080");
+    config.audioStereo = getEnv("ZOOM_BOT_STEREO", "0") == "1";
+    config.channelMode = getEnv("ZOOM_BOT_CHANNEL_MODE", config.channelMode);
+    config.gatewayCaFile = getEnv("ZOOM_BOT_GATEWAY_CA_FILE");
+    config.transcribeUrl = getEnv("ZOOM_BOT_TRANSCRIBE_URL");
+    config.transcribeAuth = getEnv("ZOOM_BOT_TRANSCRIBE_AUTH");
+    if (config.transcribeAuth.empty() && !getEnv("DEEPGRAM_API_KEY").empty()) {
+        config.transcribeAuth = "Token " + getEnv("DEEPGRAM_API_KEY");
+    }
+    config.transcribeParams = getEnv("ZOOM_BOT_TRANSCRIBE_PARAMS", config.transcribeParams);
+    config.journalPath = getEnv("ZOOM_BOT_JOURNAL");
+    config.statePath = getEnv("ZOOM_BOT_STATE_FILE");
+    config.tracePath = getEnv("ZOOM_BOT_TRACE");
+    config.audioCpus = getEnv("ZOOM_BOT_AUDIO_CPUS");
+    config.networkCpus = getEnv("ZOOM_BOT_NETWORK_CPUS");
+    config.realtimePolicy = getEnv("ZOOM_BOT_RT_POLICY", config.realtimePolicy);
+    config.realtimePriority = getEnvUInt("ZOOM_BOT_RT_PRIORITY", config.realtimePriority);
+    config.lockAudioMemory = getEnv("ZOOM_BOT_MLOCK", "0") == "1";
+    config.reconnectMaxMs = getEnvUInt("ZOOM_BOT_RECONNECT_MAX_MS", config.reconnectMaxMs);
+    config.reconnectBacklogMs = getEnvUInt("ZOOM_BOT_RECONNECT_BACKLOG_MS", config.reconnectBacklogMs);
+    config.gatewayDnsTtlMs = getEnvUInt("ZOOM_BOT_GATEWAY_DNS_TTL_MS", config.gatewayDnsTtlMs);
+    config.rewindMinutes = getEnvUInt("ZOOM_BOT_REWIND_MINUTES", config.rewindMinutes);
+    config.rewindSpeed = getEnvUInt("ZOOM_BOT_REWIND_SPEED", config.rewindSpeed);
+    config.frameMs = getEnvUInt("ZOOM_BOT_FRAME_MS", config.frameMs);
+    config.frameMaxLatencyMs = getEnvUInt("ZOOM_BOT_FRAME_MAX_LATENCY_MS", config.frameMaxLatencyMs);
+    unsigned int cores = std::thread::hardware_concurrency();
+    config.streamWorkers = getEnvUInt("ZOOM_BOT_STREAM_WORKERS", std::min(8u, cores > 1 ? cores - 1 : 0));
+    config.cpuBudgetUs = getEnvUInt("ZOOM_BOT_CPU_BUDGET_US", config.cpuBudgetUs);
+    config.statsIntervalMs = getEnvUInt("ZOOM_BOT_STATS_INTERVAL_MS", config.statsIntervalMs);
+    config.speakerChange = getEnv("ZOOM_BOT_SPEAKER_CHANGE", "0") == "1";
+    config.participantArenaMb = getEnvUInt("ZOOM_BOT_PARTICIPANT_ARENA_MB", config.participantArenaMb);
+    config.rosterBatchMs = getEnvUInt("ZOOM_BOT_ROSTER_BATCH_MS", config.rosterBatchMs);
+    config.rosterBatchMax = getEnvUInt("ZOOM_BOT_ROSTER_BATCH_MAX", config.rosterBatchMax);
+    config.talkStatsIntervalMs = getEnvUInt("ZOOM_BOT_TALK_STATS_INTERVAL_MS", config.talkStatsIntervalMs);
+    config.concealToleranceMs = getEnvUInt("ZOOM_BOT_CONCEAL_TOLERANCE_MS", config.concealToleranceMs);
+    config.discontinuityMs = getEnvUInt("ZOOM_BOT_DISCONTINUITY_MS", config.discontinuityMs);
+    config.driftCorrection = getEnv("ZOOM_BOT_DRIFT_CORRECTION", "1") != "0";
 
     // Parse CLI args: --meeting-id, --password, --name, --gateway-url
     for (int i = 1; i < argc; i++) {
@@ -89,7 +137,7 @@ Config Config::load(int argc, char* argv[]) {
             std::cout << "  --meeting-id   Zoom meeting number (required)" << std::endl;
             std::cout << "  --password     Meeting password" << std::endl;
             std::cout << "  --name         Bot display name (default: from ZOOM_BOT_NAME env)" << std::endl;
-            std::cout << "  --gateway-url  Gateway WebSocket URL (default: ws://localhost:8080)" << std::endl;
+            std::cout << "  --gateway-url  Gateway WebSocket URL, or shm:///path.sock for a local reader (default: ws://localhost:8080)" << std::endl;
             exit(0);
         }
     }
@@ -109,6 +157,16 @@ Config Config::load(int argc, char* argv[]) {
     std::cout << "[Config] Meeting: " << config.meetingNumber << std::endl;
     std::cout << "[Config] Bot name: " << config.displayName << std::endl;
     std::cout << "[Config] Gateway: " << config.gatewayUrl << std::endl;
+    if (!config.transcribeUrl.empty()) {
+        std::cout << "[Config] Direct transcription: " << config.transcribeUrl << std::endl;
+        if (config.transcribeParams.find("sample_rate=16000") == std::string::npos) {
+            std::cerr << "[Config] Warning: ZOOM_BOT_TRANSCRIBE_PARAMS should declare sample_rate=16000 "
+                      << "(the bot always sends 16kHz linear16)" << std::endl;
+        }
+    }
+    if (config.audioStereo) {
+        std::cout << "[Config] Stereo raw audio, channel mode: " << config.channelMode << std::endl;
+    }
 
     return config;
 }
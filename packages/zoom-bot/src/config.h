@@ -16,10 +16,107 @@ struct Config {
     // Gateway connection
     std::string gatewayUrl = "ws://localhost:8080";
 
+    // Gateway reconnects: longest backoff between attempts, and how much of
+    // the most recent audio is held for replay while disconnected (0: none)
+    unsigned int reconnectMaxMs = 10000;
+    unsigned int reconnectBacklogMs = 0;
+
+    // How long a ws:// gateway's resolved addresses are reused for
+    // reconnects. Opt-in: it connects by address, so the Host header carries
+    // the address instead of the configured name (0: connect by name)
+    unsigned int gatewayDnsTtlMs = 0;
+
+    // CA bundle for wss:// gateways with a private certificate (empty: system store)
+    std::string gatewayCaFile;
+
+    // Direct transcription: a Deepgram-compatible live endpoint the bot
+    // streams to itself (empty: audio goes to the gateway), the
+    // Authorization header, and query parameters appended to the URL. The
+    // audio is always 16kHz mono linear16, so encoding and sample_rate in
+    // the parameters must say so.
+    std::string transcribeUrl;
+    std::string transcribeAuth;
+    std::string transcribeParams = "encoding=linear16&sample_rate=16000&channels=1&model=nova-2&language=en"
+                                   "&diarize=true&punctuate=true&smart_format=true&interim_results=true";
+
+    // Raw audio layout: request stereo from the SDK, and how the resampler
+    // reduces it to mono ("mix", "left" or "right")
+    bool audioStereo = false;
+    std::string channelMode = "mix";
+
+    // Outgoing audio framing: frame duration, and the longest a partial
+    // frame may wait before it is sent anyway
+    unsigned int frameMs = 50;
+    unsigned int frameMaxLatencyMs = 100;
+
+    // Rewind buffer: minutes of outgoing audio held for re-transcription
+    // (0 disables), and how much faster than real time a rewind is sent
+    // (0: as fast as the connection allows)
+    unsigned int rewindMinutes = 5;
+    unsigned int rewindSpeed = 4;
+
+    // Binary journal of roster and speaker events (empty disables)
+    std::string journalPath;
+
+    // Memory-mapped roster and stream state for warm restarts (empty disables)
+    std::string statePath;
+
+    // Threading profile for the SDK audio thread and the gateway network
+    // thread: CPU lists ("2,3" or "4-7", empty for no pinning), real-time
+    // policy ("none", "fifo" or "rr") and priority, and whether the audio
+    // buffers are locked in RAM
+    std::string audioCpus;
+    std::string networkCpus;
+    std::string realtimePolicy = "none";
+    unsigned int realtimePriority = 10;
+    bool lockAudioMemory = false;
+
+    // Pipeline trace output (empty disables tracing); written on SIGUSR1
+    // and at exit
+    std::string tracePath;
+
+    // Threads for per-participant one-way audio processing (0: all on the
+    // SDK audio thread); the default is one per core beyond the audio
+    // thread, up to 8, and none on a single core
+    unsigned int streamWorkers = 0;
+
+    // Audio-thread processing allowed per 10ms mixed callback before
+    // optional work is shed (0 disables the watchdog)
+    unsigned int cpuBudgetUs = 3000;
+
+    // Audio quality telemetry: summary interval (0 disables)
+    uint64_t statsIntervalMs = 5000;
+
+    // Turn boundaries found in the mixed stream itself (speaker_change).
+    // Off by default: recall is still about 54% on synthetic voices
+    bool speakerChange = false;
+
+    // Per-participant state (tracker entries, names, stream buffers) comes
+    // from an arena of this size; past it, from the heap (0: heap only)
+    unsigned int participantArenaMb = 16;
+
+    // Roster changes are applied and sent in batches: at most this often,
+    // or as soon as this many are queued (interval 0: one at a time)
+    unsigned int rosterBatchMs = 100;
+    unsigned int rosterBatchMax = 200;
+
+    // Talk-time statistics sent to the gateway (0: only on request)
+    uint64_t talkStatsIntervalMs = 60000;
+
+    // Mixed stream gap handling: shortfall tolerated before concealment,
+    // and gap size that is also signalled to the gateway
+    unsigned int concealToleranceMs = 60;
+    unsigned int discontinuityMs = 500;
+
+    // Mixed stream resampled to keep pace with the wall clock when the SDK's
+    // audio clock drifts (the drift is measured and reported either way)
+    bool driftCorrection = true;
+
     // Load from .env file and CLI args
     static Config load(int argc, char* argv[]);
 
 private:
     static void loadEnvFile(const std::string& path);
     static std::string getEnv(const std::string& key, const std::string& defaultVal = "");
+    static uint64_t getEnvUInt(const std::string& key, uint64_t defaultVal);
 };
@@ -0,0 +1,120 @@
+#include "drift_estimator.h"
+#include <algorithm>
+#include <cmath>
+
+DriftEstimator::DriftEstimator(unsigned int sampleRate) : sampleRate_(sampleRate) {}
+
+void DriftEstimator::add(Clock::time_point arrival, size_t count) {
+    if (count == 0) return;
+    frameSamples_ = count;
+
+    if (!started_) {
+        // The first callback defines the timeline: its last sample is "now"
+        started_ = true;
+        anchor_ = arrival;
+        bucket_ = 0;
+        bucketT_ = 0.0;
+        bucketOffset_ = 0.0;
+        return;
+    }
+
+    received_ += count;
+    double t = std::chrono::duration<double>(arrival - anchor_).count();
+    double offset = t * sampleRate_ - static_cast<double>(received_);
+
+    auto bucket = static_cast<int64_t>(t / BUCKET_S);
+    if (bucket != bucket_) {
+        closeBucket();
+        bucket_ = bucket;
+        bucketT_ = t;
+        bucketOffset_ = offset;
+    } else if (offset < bucketOffset_) {
+        bucketT_ = t;
+        bucketOffset_ = offset;
+    }
+}
+
+void DriftEstimator::closeBucket() {
+    Point point{bucketT_, bucketOffset_ - shift_, points_.empty()};
+    if (!points_.empty()) {
+        // Measured from where the drift found so far puts this point, so
+        // the test below does not favour steps against the drift
+        const Point& last = points_.back();
+        double step = point.offset - last.offset - slope_ * (point.t - last.t);
+        double tolerance = MAX_RESIDUAL * frameSamples_;
+        if (point.t - last.t > 2 * BUCKET_S) {
+            // Too long without audio to tell drift from lost frames
+            point.newSegment = true;
+        } else if (std::abs(step) >= tolerance) {
+            double frames = std::round(step / frameSamples_);
+            if (frames != 0.0 && std::abs(step - frames * frameSamples_) < tolerance) {
+                shift_ += frames * frameSamples_;
+                point.offset -= frames * frameSamples_;
+            } else {
+                point.newSegment = true;
+            }
+        }
+    }
+
+    points_.push_back(point);
+    while (points_.size() > WINDOW_BUCKETS) points_.pop_front();
+    fit();
+}
+
+void DriftEstimator::fit() {
+    // Pooled least squares: one slope shared by all segments, each with its
+    // own intercept. Times are taken from the oldest point to keep the sums
+    // small.
+    double t0 = points_.front().t;
+    double sxx = 0.0;
+    double sxy = 0.0;
+    double syy = 0.0;
+    double span = 0.0;
+    size_t used = 0;
+    size_t segments = 0;
+
+    size_t n = 0;
+    double st = 0.0, so = 0.0, stt = 0.0, sto = 0.0, soo = 0.0, first = 0.0, last = 0.0;
+    auto endSegment = [&] {
+        if (n >= 2) {
+            sxx += stt - st * st / n;
+            sxy += sto - st * so / n;
+            syy += soo - so * so / n;
+            span += last - first;
+            used += n;
+            segments++;
+        }
+        n = 0;
+        st = so = stt = sto = soo = 0.0;
+    };
+
+    for (size_t i = 0; i < points_.size(); i++) {
+        const Point& point = points_[i];
+        if (i > 0 && point.newSegment) endSegment();
+        double t = point.t - t0;
+        if (n == 0) first = t;
+        last = t;
+        n++;
+        st += t;
+        so += point.offset;
+        stt += t * t;
+        sto += t * point.offset;
+        soo += point.offset * point.offset;
+    }
+    endSegment();
+
+    if (sxx <= 0.0 || used <= segments + 1) {
+        ready_ = false;
+        return;
+    }
+    double slope = sxy / sxx;
+    slope_ = slope;
+    // A fast SDK clock delivers more samples than expected, so the offset falls
+    ppm_ = -slope / sampleRate_ * 1e6;
+
+    // Standard error of the slope; points scattered by late callbacks and
+    // short segments broken up by skips make it large
+    double residual = std::max(0.0, syy - slope * sxy) / (used - segments - 1);
+    double errorPpm = std::sqrt(residual / sxx) / sampleRate_ * 1e6;
+    ready_ = span >= MIN_SPAN_S && errorPpm <= MAX_ERROR_PPM;
+}
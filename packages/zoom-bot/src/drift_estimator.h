@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+// Measures how fast the SDK's audio clock runs against the monotonic clock,
+// from nothing but when mixed callbacks arrive and how many samples they
+// carry. Over hours a difference of 100ppm adds up to more than a second
+// between sample-count and wall-clock timestamps.
+//
+// Each callback gives an offset: samples the wall clock says should have
+// arrived by now, minus samples that did. A late callback only ever raises
+// it, so the lowest offset in each second is kept as that second's point,
+// and the drift is the slope of a least-squares line through the points of
+// the last WINDOW_BUCKETS seconds.
+//
+// Skipped callbacks raise every later offset by a whole frame; a step
+// between consecutive points (beyond what the drift so far predicts) that
+// is close to a whole number of frames is taken out, so the line continues
+// across it. Anything else (a long pause,
+// a step between frame multiples) starts a new segment, and only the slope
+// within segments is used. The estimate is only ready once the segments
+// span MIN_SPAN_S and the slope's standard error is within MAX_ERROR_PPM.
+// Not thread-safe: fed from the mixed callback.
+class DriftEstimator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit DriftEstimator(unsigned int sampleRate);
+
+    // A callback carrying count samples arrived at arrival
+    void add(Clock::time_point arrival, size_t count);
+
+    // Enough history, and close enough to a line, for the estimate to be trusted
+    bool ready() const { return ready_; }
+
+    // How much faster (positive) or slower than the monotonic clock the SDK
+    // clock runs, in parts per million
+    double ppm() const { return ppm_; }
+
+private:
+    struct Point {
+        double t;          // seconds since the first callback
+        double offset;     // samples, lowest in its bucket, skips taken out
+        bool newSegment;
+    };
+
+    unsigned int sampleRate_;
+
+    bool started_ = false;
+    Clock::time_point anchor_;
+    uint64_t received_ = 0;
+    size_t frameSamples_ = 0;  // size of the last callback
+    double shift_ = 0.0;       // skipped frames taken out so far, in samples
+
+    // The bucket being filled
+    int64_t bucket_ = -1;
+    double bucketT_ = 0.0;
+    double bucketOffset_ = 0.0;
+
+    std::deque<Point> points_;
+    bool ready_ = false;
+    double slope_ = 0.0;  // of the last fit, in samples per second
+    double ppm_ = 0.0;
+
+    void closeBucket();
+    void fit();
+
+    static constexpr double BUCKET_S = 1.0;
+    static constexpr size_t WINDOW_BUCKETS = 600;  // 10 minutes
+    static constexpr double MIN_SPAN_S = 60.0;     // of segments, before the estimate is ready
+    static constexpr double MAX_ERROR_PPM = 2.0;   // standard error of the slope, before it is ready
+    static constexpr double MAX_RESIDUAL = 0.25;   // of a frame, for a step to count as skips
+};
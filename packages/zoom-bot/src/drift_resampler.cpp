@@ -0,0 +1,47 @@
+#include "drift_resampler.h"
+#include <algorithm>
+#include <cmath>
+
+DriftResampler::DriftResampler(unsigned int sampleRate) : sampleRate_(sampleRate) {
+    buffer_.reserve(HISTORY + sampleRate / 10);
+}
+
+void DriftResampler::setTarget(double ppm) {
+    targetPpm_ = std::clamp(ppm, -MAX_PPM, MAX_PPM);
+}
+
+void DriftResampler::process(const int16_t* in, size_t count, std::vector<int16_t>& out) {
+    out.clear();
+    if (count == 0) return;
+
+    // Move towards the target by what this much audio allows
+    double slew = SLEW_PPM_PER_S * count / sampleRate_;
+    ppm_ += std::clamp(targetPpm_ - ppm_, -slew, slew);
+    double step = 1.0 + ppm_ * 1e-6;
+
+    if (!primed_) {
+        // Start as if the stream had always been at its first sample
+        buffer_.assign(HISTORY, static_cast<float>(in[0]));
+        primed_ = true;
+    }
+    buffer_.resize(HISTORY);
+    buffer_.insert(buffer_.end(), in, in + count);
+
+    // Each output needs the sample before its position and two after
+    const float* x = buffer_.data();
+    size_t end = buffer_.size() - 2;
+    while (position_ < end) {
+        auto i = static_cast<size_t>(position_);
+        auto t = static_cast<float>(position_ - i);
+        float c1 = 0.5f * (x[i + 1] - x[i - 1]);
+        float c2 = x[i - 1] - 2.5f * x[i] + 2.0f * x[i + 1] - 0.5f * x[i + 2];
+        float c3 = 0.5f * (x[i + 2] - x[i - 1]) + 1.5f * (x[i] - x[i + 1]);
+        float y = ((c3 * t + c2) * t + c1) * t + x[i];
+        out.push_back(static_cast<int16_t>(std::clamp(std::lround(y), -32768L, 32767L)));
+        position_ += step;
+    }
+
+    // Keep the tail for the next call's first outputs
+    std::copy(buffer_.end() - HISTORY, buffer_.end(), buffer_.begin());
+    position_ -= static_cast<double>(buffer_.size() - HISTORY);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stretches or squeezes a mono stream by a few hundred ppm so that the
+// samples sent keep pace with the wall clock when the SDK's audio clock
+// does not. Output samples are read from the input at a fractional step
+// of 1 + ppm/1e6, with 4-point cubic Hermite interpolation; the last input
+// samples are carried over, so frame boundaries leave no trace.
+//
+// The applied correction follows the target at no more than SLEW_PPM_PER_S
+// per second of audio, so a new estimate never shows up as a jump in pitch
+// or timing. At zero correction the input passes through unchanged, two
+// samples late. Not thread-safe: driven from the mixed callback.
+class DriftResampler {
+public:
+    explicit DriftResampler(unsigned int sampleRate);
+
+    // The input runs ppm fast (positive, so it is squeezed) or slow;
+    // clamped to MAX_PPM
+    void setTarget(double ppm);
+
+    // Correction currently applied, in ppm
+    double correctionPpm() const { return ppm_; }
+
+    // Resamples count samples into out, replacing its contents
+    void process(const int16_t* in, size_t count, std::vector<int16_t>& out);
+
+    static constexpr double MAX_PPM = 1000.0;
+
+private:
+    static constexpr size_t HISTORY = 3;  // input samples carried into the next call
+    static constexpr double SLEW_PPM_PER_S = 20.0;
+
+    unsigned int sampleRate_;
+    double targetPpm_ = 0.0;
+    double ppm_ = 0.0;
+
+    bool primed_ = false;
+    double position_ = HISTORY;  // of the next output sample, in buffer_
+    std::vector<float> buffer_;  // carried-over samples, then this call's input
+};
@@ -0,0 +1,78 @@
+#include "endpoint_cache.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <iostream>
+#include <netdb.h>
+#include <sys/socket.h>
+
+EndpointCache::EndpointCache(uint32_t ttlMs) : ttlMs_(ttlMs) {}
+
+std::string EndpointCache::resolve(const std::string& url) {
+    lookupMs_ = -1;
+    const std::string scheme = "ws://";
+    if (ttlMs_ == 0 || url.compare(0, scheme.size(), scheme) != 0) return url;
+
+    size_t hostStart = scheme.size();
+    if (url.size() > hostStart && url[hostStart] == '[') return url;  // already an IPv6 address
+    size_t hostEnd = url.find_first_of(":/?", hostStart);
+    if (hostEnd == std::string::npos) hostEnd = url.size();
+    std::string host = url.substr(hostStart, hostEnd - hostStart);
+    in_addr v4{};
+    if (host.empty() || inet_pton(AF_INET, host.c_str(), &v4) == 1) return url;
+
+    bool fresh = host == host_ && next_ < addresses_.size() &&
+                 Clock::now() - resolvedAt_ < std::chrono::milliseconds(ttlMs_);
+    if (!fresh && !lookup(host)) {
+        // Keep using what the resolver said last time, if anything
+        if (host != host_ || addresses_.empty()) return url;
+        if (next_ >= addresses_.size()) next_ = 0;
+    }
+    return url.substr(0, hostStart) + addresses_[next_] + url.substr(hostEnd);
+}
+
+void EndpointCache::failed() {
+    if (next_ < addresses_.size()) next_++;
+}
+
+bool EndpointCache::lookup(const std::string& host) {
+    auto start = Clock::now();
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    int rc = getaddrinfo(host.c_str(), nullptr, &hints, &result);
+    lookupMs_ = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    if (rc != 0) {
+        if (!addresses_.empty() && host == host_) {
+            std::cerr << "[WS] DNS lookup for " << host << " failed (" << gai_strerror(rc)
+                      << "), using the last known address" << std::endl;
+        }
+        return false;
+    }
+
+    // In the resolver's order of preference, as ixwebsocket would try them
+    std::vector<std::string> addresses;
+    for (addrinfo* ai = result; ai; ai = ai->ai_next) {
+        char text[INET6_ADDRSTRLEN];
+        std::string address;
+        if (ai->ai_family == AF_INET &&
+            inet_ntop(AF_INET, &reinterpret_cast<sockaddr_in*>(ai->ai_addr)->sin_addr, text, sizeof(text))) {
+            address = text;
+        } else if (ai->ai_family == AF_INET6 &&
+                   inet_ntop(AF_INET6, &reinterpret_cast<sockaddr_in6*>(ai->ai_addr)->sin6_addr, text,
+                             sizeof(text))) {
+            address = std::string("[") + text + "]";
+        }
+        if (!address.empty() && std::find(addresses.begin(), addresses.end(), address) == addresses.end()) {
+            addresses.push_back(address);
+        }
+    }
+    freeaddrinfo(result);
+    if (addresses.empty()) return false;
+
+    host_ = host;
+    addresses_ = std::move(addresses);
+    next_ = 0;
+    resolvedAt_ = Clock::now();
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Remembers the addresses the gateway's host name resolved to, so a
+// reconnect does not wait on DNS and still works while the resolver is
+// down. Only plain ws:// URLs are rewritten to connect by address: for
+// wss:// ixwebsocket takes the name for SNI and certificate verification
+// from the URL, so those pass through unchanged and it resolves them
+// itself. Since the Host header is taken from the URL too, a rewritten URL
+// sends the address instead of the configured name, which a reverse proxy
+// or name-based virtual host would misroute; hence off unless configured.
+// Used from the connection supervisor only.
+class EndpointCache {
+public:
+    // ttlMs: how long a lookup is trusted (0: never rewrite URLs)
+    explicit EndpointCache(uint32_t ttlMs);
+
+    // URL to connect to: url with its host replaced by a cached or freshly
+    // resolved address, or url itself when it cannot or need not be
+    std::string resolve(const std::string& url);
+
+    // The last connect to the resolved address failed: try the next one the
+    // name resolved to, and look the name up again once none are left
+    void failed();
+
+    // Time the last resolve() spent in DNS, in ms, or -1 if it did not look
+    // anything up
+    double lookupMs() const { return lookupMs_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    uint32_t ttlMs_;
+    std::string host_;
+    std::vector<std::string> addresses_;  // as they go in a URL: IPv6 in brackets
+    size_t next_ = 0;
+    Clock::time_point resolvedAt_;
+    double lookupMs_ = -1;
+
+    bool lookup(const std::string& host);
+};
@@ -0,0 +1,254 @@
+#include "event_journal.h"
+#include "tracer.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdio_ext.h>
+#include <unistd.h>
+
+static uint64_t wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+EventJournal::~EventJournal() {
+    close();
+}
+
+bool EventJournal::open(const std::string& path, uint64_t meetingNumber) {
+    data_ = fopen(path.c_str(), "a+b");
+    if (!data_) {
+        std::cerr << "[Journal] Cannot open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Continue an existing journal (bot restarted mid-meeting) or start one.
+    // A file cut short inside its header never got a record, so it is
+    // started over.
+    fseek(data_, 0, SEEK_END);
+    fileOffset_ = ftell(data_);
+    if (fileOffset_ < sizeof(journal::FileHeader)) {
+        journal::FileHeader header{journal::MAGIC, journal::VERSION, meetingNumber, wallClockMs()};
+        if (!truncateTo(data_, 0) || fwrite(&header, sizeof(header), 1, data_) != 1 || fflush(data_) != 0) {
+            std::cerr << "[Journal] Cannot write " << path << ": " << std::strerror(errno) << std::endl;
+            fclose(data_);
+            data_ = nullptr;
+            return false;
+        }
+        fileOffset_ = sizeof(header);
+    } else {
+        journal::FileHeader header{};
+        fseek(data_, 0, SEEK_SET);
+        if (fread(&header, sizeof(header), 1, data_) != 1 ||
+            header.magic != journal::MAGIC || header.version != journal::VERSION) {
+            std::cerr << "[Journal] " << path << " is not a journal, not writing to it" << std::endl;
+            fclose(data_);
+            data_ = nullptr;
+            return false;
+        }
+        if (header.meetingNumber != meetingNumber) {
+            // Another meeting's journal: move it aside with its index rather
+            // than mixing the two meetings' events in one file
+            fclose(data_);
+            data_ = nullptr;
+            std::string aside = path + "." + std::to_string(header.meetingNumber) + "." +
+                                std::to_string(header.createdMs);
+            if (std::rename(path.c_str(), aside.c_str()) != 0) {
+                std::cerr << "[Journal] " << path << " belongs to meeting " << header.meetingNumber
+                          << " and cannot be moved aside (" << std::strerror(errno) << "), not writing to it"
+                          << std::endl;
+                return false;
+            }
+            std::rename((path + ".idx").c_str(), (aside + ".idx").c_str());
+            std::cout << "[Journal] Moved meeting " << header.meetingNumber << "'s journal to " << aside
+                      << std::endl;
+            return open(path, meetingNumber);
+        }
+        if (!recover(path)) {
+            fclose(data_);
+            data_ = nullptr;
+            return false;
+        }
+    }
+
+    index_ = fopen((path + ".idx").c_str(), "a+b");
+    if (!index_ || !recoverIndex()) {
+        std::cerr << "[Journal] Cannot open index: " << std::strerror(errno) << std::endl;
+        if (index_) fclose(index_);
+        fclose(data_);
+        data_ = index_ = nullptr;
+        return false;
+    }
+
+    std::cout << "[Journal] Writing events to " << path << std::endl;
+    running_ = true;
+    writer_ = std::thread([this] { writerLoop(); });
+    return true;
+}
+
+void EventJournal::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    wakeup_.notify_all();
+    writer_.join();
+
+    fclose(data_);
+    fclose(index_);
+    data_ = index_ = nullptr;
+    std::cout << "[Journal] Closed after " << records_ << " records" << std::endl;
+}
+
+void EventJournal::participantJoined(uint32_t userId, std::string_view name) {
+    append(journal::EventType::Join, userId, name.data(), name.size());
+}
+
+void EventJournal::participantLeft(uint32_t userId) {
+    append(journal::EventType::Leave, userId, nullptr, 0);
+}
+
+void EventJournal::participantRenamed(uint32_t userId, std::string_view name) {
+    append(journal::EventType::Rename, userId, name.data(), name.size());
+}
+
+void EventJournal::speakerRun(uint32_t userId, uint64_t startMs, uint64_t endMs) {
+    uint64_t now = wallClockMs();
+    journal::SpeakerRun run;
+    run.leadMs = static_cast<uint32_t>(now > startMs ? now - startMs : 0);
+    run.durationMs = static_cast<uint32_t>(endMs > startMs ? endMs - startMs : 0);
+    append(journal::EventType::SpeakerRun, userId, &run, sizeof(run));
+}
+
+void EventJournal::append(journal::EventType type, uint32_t userId, const void* payload, size_t length) {
+    length = std::min<size_t>(length, UINT16_MAX);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return;
+
+    // Keep timestamps non-decreasing even if the wall clock steps back
+    uint64_t now = std::max(wallClockMs(), lastTimestampMs_);
+    lastTimestampMs_ = now;
+
+    if (now >= nextIndexMs_) {
+        pendingIndex_.push_back({now, pending_.size()});
+        nextIndexMs_ = now - now % journal::INDEX_INTERVAL_MS + journal::INDEX_INTERVAL_MS;
+    }
+
+    journal::RecordHeader header{now, static_cast<uint16_t>(type), static_cast<uint16_t>(length), userId};
+    pending_.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (length > 0) pending_.append(static_cast<const char*>(payload), length);
+    records_++;
+
+    if (pending_.size() >= FLUSH_BYTES) wakeup_.notify_one();
+}
+
+void EventJournal::writerLoop() {
+    std::string batch;
+    std::vector<journal::IndexEntry> index;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wakeup_.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS),
+                         [this] { return !running_ || pending_.size() >= FLUSH_BYTES; });
+        bool stopping = !running_;
+
+        batch.swap(pending_);
+        index.swap(pendingIndex_);
+        lock.unlock();
+
+        if (!batch.empty()) writeBatch(batch, index);
+        batch.clear();
+        index.clear();
+
+        if (stopping) break;
+        lock.lock();
+    }
+}
+
+void EventJournal::writeBatch(const std::string& batch, const std::vector<journal::IndexEntry>& index) {
+    TRACE_SCOPE("journal.write");
+    if (fwrite(batch.data(), 1, batch.size(), data_) != batch.size() || fflush(data_) != 0) {
+        // Cut off whatever part made it, so the next batch starts on a
+        // record boundary where its index entries expect it
+        std::cerr << "[Journal] Write failed, dropping " << batch.size() << " bytes of events: "
+                  << std::strerror(errno) << std::endl;
+        truncateTo(data_, fileOffset_);
+        return;
+    }
+
+    // Index entries only after their records are on disk. If they cannot
+    // all be written none are kept: readers then seek from an earlier entry.
+    bool indexed = true;
+    for (const auto& entry : index) {
+        journal::IndexEntry absolute{entry.timestampMs, fileOffset_ + entry.offset};
+        indexed = indexed && fwrite(&absolute, sizeof(absolute), 1, index_) == 1;
+    }
+    if (indexed && fflush(index_) == 0) {
+        indexOffset_ += index.size() * sizeof(journal::IndexEntry);
+    } else {
+        std::cerr << "[Journal] Index write failed: " << std::strerror(errno) << std::endl;
+        truncateTo(index_, indexOffset_);
+    }
+    fileOffset_ += batch.size();
+}
+
+bool EventJournal::truncateTo(FILE* file, uint64_t size) {
+    // Drop anything still buffered from a failed write, or a later flush
+    // would put it after the cut
+    __fpurge(file);
+    clearerr(file);
+    if (ftruncate(fileno(file), static_cast<off_t>(size)) != 0) return false;
+    return fseek(file, 0, SEEK_END) == 0;
+}
+
+bool EventJournal::recover(const std::string& path) {
+    // Walk the records; a crash mid-write leaves a torn record at the end
+    fseek(data_, 0, SEEK_END);
+    uint64_t size = ftell(data_);
+    uint64_t offset = sizeof(journal::FileHeader);
+    fseek(data_, static_cast<long>(offset), SEEK_SET);
+
+    journal::RecordHeader rec;
+    while (offset + sizeof(rec) <= size && fread(&rec, sizeof(rec), 1, data_) == 1) {
+        bool valid = rec.type >= static_cast<uint16_t>(journal::EventType::Join) &&
+                     rec.type <= static_cast<uint16_t>(journal::EventType::SpeakerRun) &&
+                     rec.timestampMs >= lastTimestampMs_ && offset + sizeof(rec) + rec.length <= size;
+        if (!valid) break;
+        offset += sizeof(rec) + rec.length;
+        lastTimestampMs_ = rec.timestampMs;
+        fseek(data_, static_cast<long>(offset), SEEK_SET);
+    }
+
+    if (offset < size) {
+        std::cerr << "[Journal] Dropping " << size - offset << " bytes of torn records at the end of " << path
+                  << std::endl;
+        if (!truncateTo(data_, offset)) {
+            std::cerr << "[Journal] Cannot truncate " << path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+    fseek(data_, 0, SEEK_END);
+    fileOffset_ = offset;
+    return true;
+}
+
+bool EventJournal::recoverIndex() {
+    // Keep whole entries that point into the recovered data
+    fseek(index_, 0, SEEK_END);
+    uint64_t size = ftell(index_);
+    uint64_t keep = 0;
+    fseek(index_, 0, SEEK_SET);
+    journal::IndexEntry entry;
+    while (keep + sizeof(entry) <= size && fread(&entry, sizeof(entry), 1, index_) == 1 &&
+           entry.offset < fileOffset_) {
+        keep += sizeof(entry);
+    }
+    indexOffset_ = keep;
+    if (keep < size) return truncateTo(index_, keep);
+    return fseek(index_, 0, SEEK_END) == 0;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "journal_format.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Append-only binary journal of participant and speaker events (see
+// journal_format.h). Callers only encode into an in-memory batch; a
+// background thread writes batches and index entries to disk about once a
+// second, so SDK and audio callbacks never wait on the filesystem.
+class EventJournal {
+public:
+    ~EventJournal();
+
+    // Opens or continues the journal at path (index at path + ".idx")
+    bool open(const std::string& path, uint64_t meetingNumber);
+    void close();
+
+    void participantJoined(uint32_t userId, std::string_view name);
+    void participantLeft(uint32_t userId);
+    void participantRenamed(uint32_t userId, std::string_view name);
+
+    // A continuous stretch of speech, wall clock ms
+    void speakerRun(uint32_t userId, uint64_t startMs, uint64_t endMs);
+
+private:
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    bool running_ = false;
+    std::thread writer_;
+
+    // Batch being filled by callers; index offsets are relative to it
+    std::string pending_;
+    std::vector<journal::IndexEntry> pendingIndex_;
+    uint64_t lastTimestampMs_ = 0;
+    uint64_t nextIndexMs_ = 0;
+    uint64_t records_ = 0;
+
+    // Owned by the writer thread
+    FILE* data_ = nullptr;
+    FILE* index_ = nullptr;
+    uint64_t fileOffset_ = 0;
+    uint64_t indexOffset_ = 0;
+
+    void append(journal::EventType type, uint32_t userId, const void* payload, size_t length);
+    void writerLoop();
+    void writeBatch(const std::string& batch, const std::vector<journal::IndexEntry>& index);
+
+    // Reopening: cut a torn record off the data file, and index entries
+    // that are partial or point past it off the index
+    bool recover(const std::string& path);
+    bool recoverIndex();
+    static bool truncateTo(FILE* file, uint64_t size);
+
+    static constexpr int FLUSH_INTERVAL_MS = 1000;
+    static constexpr size_t FLUSH_BYTES = 64 * 1024;
+};
@@ -0,0 +1,111 @@
+#include "frame_aggregator.h"
+#include "thread_profile.h"
+#include <algorithm>
+
+FrameAggregator::FrameAggregator(unsigned int sampleRate, unsigned int frameMs,
+                                 unsigned int maxLatencyMs, Sink sink)
+    : frameSamples_(std::max<size_t>(1, static_cast<size_t>(sampleRate) * frameMs / 1000)),
+      maxLatencyMs_(maxLatencyMs), sink_(std::move(sink)) {
+    buffer_.reserve(frameSamples_);
+    ready_.reserve(SPARE_FRAMES + 1);
+    spare_.reserve(SPARE_FRAMES + 1);
+    for (size_t i = 0; i < SPARE_FRAMES; i++) {
+        spare_.emplace_back();
+        spare_.back().reserve(frameSamples_);
+    }
+}
+
+void FrameAggregator::lockBuffer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lockMemory(buffer_.data(), buffer_.capacity() * sizeof(int16_t), "frame buffer");
+    for (auto& spare : spare_) lockMemory(spare.data(), spare.capacity() * sizeof(int16_t), "frame buffer");
+}
+
+void FrameAggregator::push(const int16_t* samples, size_t count) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+
+        while (count > 0) {
+            if (buffer_.empty()) oldest_ = now;
+            size_t take = std::min(count, frameSamples_ - buffer_.size());
+            buffer_.insert(buffer_.end(), samples, samples + take);
+            samples += take;
+            count -= take;
+            if (buffer_.size() == frameSamples_) emitLocked(now, false);
+        }
+        if (ready_.empty()) return;
+    }
+    drain();
+}
+
+void FrameAggregator::flushStale() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (buffer_.empty()) return;
+        auto now = Clock::now();
+        if (now - oldest_ < std::chrono::milliseconds(maxLatencyMs_)) return;
+        emitLocked(now, true);
+    }
+    drain();
+}
+
+FrameAggregator::Stats FrameAggregator::takeStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s;
+    s.frames = frames_;
+    s.partialFrames = partialFrames_;
+    s.meanLatencyMs = frames_ ? latencySumMs_ / frames_ : 0.0;
+    s.maxLatencyMs = latencyMaxMs_;
+    frames_ = 0;
+    partialFrames_ = 0;
+    latencySumMs_ = 0.0;
+    latencyMaxMs_ = 0.0;
+    return s;
+}
+
+void FrameAggregator::emitLocked(Clock::time_point now, bool partial) {
+    double latencyMs = std::chrono::duration<double, std::milli>(now - oldest_).count();
+    frames_++;
+    if (partial) partialFrames_++;
+    latencySumMs_ += latencyMs;
+    latencyMaxMs_ = std::max(latencyMaxMs_, latencyMs);
+
+    // Queue the frame and carry on filling an empty buffer
+    ready_.push_back(std::move(buffer_));
+    if (spare_.empty()) {
+        buffer_ = std::vector<int16_t>();
+        buffer_.reserve(frameSamples_);
+    } else {
+        buffer_ = std::move(spare_.back());
+        spare_.pop_back();
+    }
+}
+
+void FrameAggregator::drain() {
+    std::vector<int16_t> frame;
+    for (;;) {
+        {
+            // Whoever holds the sink sends what is queued, this frame included
+            std::unique_lock<std::mutex> sending(sinkMutex_, std::try_to_lock);
+            if (!sending.owns_lock()) return;
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (frame.capacity() > 0) {
+                        frame.clear();
+                        spare_.push_back(std::move(frame));
+                    }
+                    if (ready_.empty()) break;
+                    frame = std::move(ready_.front());
+                    ready_.erase(ready_.begin());
+                }
+                sink_(frame.data(), frame.size());
+            }
+        }
+        // A frame queued while the sink was being released would otherwise
+        // wait for the next one
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ready_.empty()) return;
+    }
+}
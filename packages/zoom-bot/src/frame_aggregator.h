@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Coalesces the small SDK audio chunks into fixed-duration frames, aligned
+// to sample boundaries, so each WebSocket frame carries frameMs of audio.
+// A partially filled frame is flushed once its oldest sample has waited
+// maxLatencyMs, so quiet periods or stalled callbacks do not hold audio back.
+// push() runs on the SDK audio thread and flushStale() on the main loop.
+// Completed frames are queued under the buffer lock and handed to the sink
+// outside it, in order, by whichever of the two threads gets there first,
+// so neither waits on a send the other is making.
+class FrameAggregator {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Sink = std::function<void(const int16_t* samples, size_t count)>;
+
+    struct Stats {
+        uint64_t frames = 0;         // frames emitted
+        uint64_t partialFrames = 0;  // of which flushed early by the latency timer
+        double meanLatencyMs = 0.0;  // time the first sample of a frame waited
+        double maxLatencyMs = 0.0;
+    };
+
+    FrameAggregator(unsigned int sampleRate, unsigned int frameMs, unsigned int maxLatencyMs, Sink sink);
+
+    void push(const int16_t* samples, size_t count);
+
+    // Emit the buffered partial frame if it has waited too long
+    void flushStale();
+
+    // Statistics since the previous call
+    Stats takeStats();
+
+    unsigned int maxLatencyMs() const { return maxLatencyMs_; }
+
+    // Lock the frame buffers in RAM (see ThreadProfile)
+    void lockBuffer();
+
+private:
+    static constexpr size_t SPARE_FRAMES = 2;  // one being sent, one queued behind it
+
+    size_t frameSamples_;
+    unsigned int maxLatencyMs_;
+    Sink sink_;
+
+    std::mutex mutex_;
+    std::vector<int16_t> buffer_;
+    Clock::time_point oldest_;  // arrival of the first buffered sample
+    std::vector<std::vector<int16_t>> ready_;  // completed frames, oldest first
+    std::vector<std::vector<int16_t>> spare_;  // emptied frame buffers for reuse
+
+    std::mutex sinkMutex_;  // held while sending, so frames go out in order
+
+    uint64_t frames_ = 0;
+    uint64_t partialFrames_ = 0;
+    double latencySumMs_ = 0.0;
+    double latencyMaxMs_ = 0.0;
+
+    void emitLocked(Clock::time_point now, bool partial);
+    void drain();
+};
@@ -0,0 +1,121 @@
+#include "gap_concealer.h"
+#include <algorithm>
+#include <cmath>
+
+GapConcealer::GapConcealer(unsigned int sampleRate, unsigned int toleranceMs, unsigned int discontinuityMs)
+    : sampleRate_(sampleRate),
+      toleranceSamples_(static_cast<uint64_t>(sampleRate) * toleranceMs / 1000),
+      discontinuitySamples_(static_cast<uint64_t>(sampleRate) * discontinuityMs / 1000),
+      maxConcealSamples_(static_cast<uint64_t>(sampleRate) * MAX_CONCEAL_MS / 1000) {}
+
+GapConcealer::Result GapConcealer::conceal(Clock::time_point arrival, size_t frameSamples,
+                                           std::vector<int16_t>& fill) {
+    Result result;
+    result.position = emitted_;
+
+    if (!started_) {
+        // The first frame defines the timeline: its last sample is "now"
+        started_ = true;
+        anchor_ = arrival;
+        anchorPosition_ = emitted_ + frameSamples;
+        return result;
+    }
+
+    // Where the end of this frame should be on the timeline vs where it will be
+    double elapsed = std::chrono::duration<double>(arrival - anchor_).count();
+    int64_t expected = static_cast<int64_t>(anchorPosition_) +
+                       static_cast<int64_t>(elapsed * sampleRate_);
+    int64_t deficit = expected - static_cast<int64_t>(emitted_ + frameSamples);
+    if (deficit < -static_cast<int64_t>(toleranceSamples_)) {
+        return runAhead(arrival, frameSamples, static_cast<uint64_t>(-deficit), result);
+    }
+    if (deficit <= static_cast<int64_t>(toleranceSamples_)) return result;
+
+    uint64_t missing = static_cast<uint64_t>(deficit);
+    result.gapMs = 1000.0 * missing / sampleRate_;
+    result.discontinuity = missing >= discontinuitySamples_;
+
+    if (missing > maxConcealSamples_) {
+        // Too long to paper over: restart the timeline here and let the
+        // discontinuity message carry the gap instead
+        anchor_ = arrival;
+        anchorPosition_ = emitted_ + frameSamples;
+        owed_ = 0;
+        result.resynced = true;
+        result.discontinuity = true;
+        return result;
+    }
+
+    size_t repeatSamples = std::min<size_t>(missing, sampleRate_ * REPEAT_MS / 1000);
+    appendRepeat(fill, repeatSamples);
+    appendComfortNoise(fill, missing - repeatSamples);
+    emitted_ += missing;
+    owed_ += missing;
+    result.concealed = missing;
+    return result;
+}
+
+GapConcealer::Result& GapConcealer::runAhead(Clock::time_point arrival, size_t frameSamples,
+                                             uint64_t surplus, Result& result) {
+    result.ahead = true;
+    result.gapMs = 1000.0 * surplus / sampleRate_;
+
+    // Real audio for a span that was concealed: drop it, as much as was
+    // invented and this frame holds
+    uint64_t trim = std::min<uint64_t>({surplus, owed_, frameSamples});
+    owed_ -= trim;
+    result.trimmed = static_cast<size_t>(trim);
+    result.discontinuity = trim >= discontinuitySamples_;
+    if (surplus - trim <= toleranceSamples_ || owed_ > 0) return result;
+
+    // Ahead for another reason; keep the audio and move the timeline so
+    // this frame ends now, and let the discontinuity message carry the shift
+    anchor_ = arrival;
+    anchorPosition_ = emitted_ + frameSamples - trim;
+    result.resynced = true;
+    result.discontinuity = true;
+    return result;
+}
+
+void GapConcealer::commit(const int16_t* samples, size_t count) {
+    if (count == 0) return;
+    emitted_ += count;
+    lastFrame_.assign(samples, samples + count);
+
+    double sumSquares = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        double s = samples[i];
+        sumSquares += s * s;
+    }
+    double rms = std::sqrt(sumSquares / count);
+    if (noiseRms_ < 0.0 || rms < noiseRms_) {
+        noiseRms_ = rms;
+    } else {
+        noiseRms_ += (rms - noiseRms_) * NOISE_FLOOR_RISE;
+    }
+}
+
+void GapConcealer::appendRepeat(std::vector<int16_t>& fill, size_t count) {
+    if (lastFrame_.empty()) {
+        appendComfortNoise(fill, count);
+        return;
+    }
+    // Replay the last frame with a linear fade-out to avoid a hard edge
+    for (size_t i = 0; i < count; i++) {
+        double gain = 1.0 - static_cast<double>(i + 1) / (count + 1);
+        int16_t s = lastFrame_[i % lastFrame_.size()];
+        fill.push_back(static_cast<int16_t>(s * gain));
+    }
+}
+
+void GapConcealer::appendComfortNoise(std::vector<int16_t>& fill, size_t count) {
+    // Uniform white noise with the same RMS as the noise floor
+    double amplitude = noiseRms_ > 0.0 ? noiseRms_ * std::sqrt(3.0) : 0.0;
+    for (size_t i = 0; i < count; i++) {
+        noiseState_ ^= noiseState_ << 13;
+        noiseState_ ^= noiseState_ >> 17;
+        noiseState_ ^= noiseState_ << 5;
+        double u = static_cast<double>(noiseState_) / 4294967295.0 * 2.0 - 1.0;
+        fill.push_back(static_cast<int16_t>(u * amplitude));
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Keeps the outgoing mixed stream sample-accurate to the meeting timeline.
+// Counts samples emitted against a monotonic clock and, when SDK callbacks
+// arrive late or are skipped, synthesizes concealment audio for the missing
+// span: a short faded repeat of the last frame followed by comfort noise at
+// the observed noise floor.
+//
+// The stream can also run ahead of the clock, typically when the frames of
+// a stall that was just concealed turn up late in a burst. Concealment not
+// yet paid back that way is trimmed from the front of the arriving frames,
+// so their span is not counted twice. A surplus beyond that (a late first
+// frame, a fast SDK clock) re-anchors the timeline instead of dropping real
+// audio. Not thread-safe: driven from the mixed audio callback only.
+class GapConcealer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Result {
+        size_t concealed = 0;         // samples appended to the fill buffer
+        size_t trimmed = 0;           // samples to drop from the front of this frame
+        double gapMs = 0.0;           // size of the detected shortfall (or surplus)
+        uint64_t position = 0;        // stream position (samples) where the gap starts
+        bool ahead = false;           // the stream ran ahead of the clock, not behind
+        bool discontinuity = false;   // gap exceeded the signalling threshold
+        bool resynced = false;        // not filled or trimmed; timeline re-anchored instead
+    };
+
+    GapConcealer(unsigned int sampleRate, unsigned int toleranceMs, unsigned int discontinuityMs);
+
+    // Called on arrival of a frame of frameSamples before it is sent.
+    // Appends concealment audio to fill if the stream has fallen behind;
+    // the caller drops result.trimmed samples from the frame if it is ahead.
+    Result conceal(Clock::time_point arrival, size_t frameSamples, std::vector<int16_t>& fill);
+
+    // Record the real frame that was just sent after conceal(), trimmed
+    void commit(const int16_t* samples, size_t count);
+
+    // Samples emitted since the stream started, concealment included
+    uint64_t position() const { return emitted_; }
+
+    // Continue a previous run's numbering (warm restart); before the first frame
+    void resumeAt(uint64_t position) { emitted_ = position; }
+
+private:
+    unsigned int sampleRate_;
+    uint64_t toleranceSamples_;
+    uint64_t discontinuitySamples_;
+    uint64_t maxConcealSamples_;
+
+    bool started_ = false;
+    Clock::time_point anchor_;
+    uint64_t anchorPosition_ = 0;
+    uint64_t emitted_ = 0;
+    uint64_t owed_ = 0;  // concealed samples not yet offset by trimming
+
+    std::vector<int16_t> lastFrame_;
+    double noiseRms_ = -1.0;
+    uint32_t noiseState_ = 0x9e3779b9u;
+
+    Result& runAhead(Clock::time_point arrival, size_t frameSamples, uint64_t surplus, Result& result);
+    void appendRepeat(std::vector<int16_t>& fill, size_t count);
+    void appendComfortNoise(std::vector<int16_t>& fill, size_t count);
+
+    static constexpr unsigned int REPEAT_MS = 20;        // faded repeat before switching to noise
+    static constexpr unsigned int MAX_CONCEAL_MS = 10000; // longer gaps are re-anchored, not filled
+    static constexpr double NOISE_FLOOR_RISE = 0.002;
+};
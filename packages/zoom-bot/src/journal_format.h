@@ -0,0 +1,62 @@
+#pragma once
+
+// On-disk layout of the meeting event journal. Shared by the bot
+// (EventJournal, writer) and the journal-export tool (reader).
+//
+// <path>      FileHeader, then records in timestamp order
+// <path>.idx  IndexEntry per INDEX_INTERVAL_MS of journal time, pointing at
+//             the first record at or after that time; binary-searched to
+//             seek without scanning the data file
+//
+// Speaker activity is stored as runs (start + duration) rather than per
+// audio frame. A run is written once it has ended, so its record timestamp
+// is at or after its end; runs longer than MAX_RUN_MS are split so a reader
+// exporting up to time t only needs to read MAX_RUN_SLACK_MS past it.
+
+#include <cstdint>
+
+namespace journal {
+
+constexpr uint32_t MAGIC = 0x4a4a425a;  // "ZBJJ"
+constexpr uint32_t VERSION = 1;
+
+constexpr uint64_t INDEX_INTERVAL_MS = 5000;
+constexpr uint64_t MAX_RUN_MS = 60000;
+constexpr uint64_t MAX_RUN_SLACK_MS = MAX_RUN_MS + 5000;  // run length + write delay
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t meetingNumber;
+    uint64_t createdMs;     // wall clock, ms since epoch
+};
+static_assert(sizeof(FileHeader) == 24, "FileHeader must stay 24 bytes");
+
+enum class EventType : uint16_t {
+    Join = 1,        // userId, name
+    Leave = 2,       // userId
+    Rename = 3,      // userId, name
+    SpeakerRun = 4,  // userId, leadMs, durationMs
+};
+
+struct RecordHeader {
+    uint64_t timestampMs;   // wall clock, non-decreasing through the file
+    uint16_t type;          // EventType
+    uint16_t length;        // payload bytes following this header
+    uint32_t userId;        // every event concerns one participant
+};
+static_assert(sizeof(RecordHeader) == 16, "RecordHeader must stay 16 bytes");
+
+// Join/Rename payload: the name (UTF-8, not terminated)
+// SpeakerRun payload:
+struct SpeakerRun {
+    uint32_t leadMs;        // run start = timestampMs - leadMs
+    uint32_t durationMs;
+};
+
+struct IndexEntry {
+    uint64_t timestampMs;
+    uint64_t offset;        // byte offset of a record in the data file
+};
+
+} // namespace journal
@@ -0,0 +1,35 @@
+#include "latency_recorder.h"
+#include <algorithm>
+
+void LatencyRecorder::record(uint64_t micros) {
+    size_t bucket = std::min<uint64_t>(micros / BUCKET_US, BUCKETS - 1);
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    if (micros > maxUs_.load(std::memory_order_relaxed)) {
+        maxUs_.store(micros, std::memory_order_relaxed);
+    }
+}
+
+LatencyRecorder::Summary LatencyRecorder::take() {
+    uint32_t counts[BUCKETS];
+    Summary summary;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        counts[i] = buckets_[i].exchange(0, std::memory_order_relaxed);
+        summary.count += counts[i];
+    }
+    summary.maxUs = static_cast<double>(maxUs_.exchange(0, std::memory_order_relaxed));
+    if (summary.count == 0) return summary;
+
+    // Report the upper edge of the bucket holding each percentile
+    auto percentile = [&](double q) {
+        uint64_t target = static_cast<uint64_t>(q * (summary.count - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= target) return std::min(static_cast<double>((i + 1) * BUCKET_US), summary.maxUs);
+        }
+        return summary.maxUs;
+    };
+    summary.p50Us = percentile(0.50);
+    summary.p99Us = percentile(0.99);
+    return summary;
+}
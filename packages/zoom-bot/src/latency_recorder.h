@@ -0,0 +1,29 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-bucket latency histogram for one hot path. record() is lock-free and
+// meant for a single writer (the SDK audio thread); take() is called at
+// summary cadence from the main loop and starts a new window.
+class LatencyRecorder {
+public:
+    struct Summary {
+        uint64_t count = 0;
+        double p50Us = 0.0;
+        double p99Us = 0.0;
+        double maxUs = 0.0;
+    };
+
+    void record(uint64_t micros);
+    Summary take();
+
+private:
+    // 10us buckets up to 20ms, then one overflow bucket
+    static constexpr uint64_t BUCKET_US = 10;
+    static constexpr size_t BUCKETS = 2001;
+
+    std::atomic<uint32_t> buckets_[BUCKETS] = {};
+    std::atomic<uint64_t> maxUs_{0};
+};
@@ -0,0 +1,65 @@
+#include "load_shedder.h"
+#include <algorithm>
+
+LoadShedder::LoadShedder(uint64_t budgetUs) : budgetUs_(budgetUs) {}
+
+void LoadShedder::record(uint64_t micros, bool mixed) {
+    if (budgetUs_ == 0) return;
+    busyUs_.fetch_add(micros, std::memory_order_relaxed);
+    if (mixed) mixedCallbacks_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool LoadShedder::evaluate(uint64_t nowMs, Change& change) {
+    if (budgetUs_ == 0) return false;
+    if (windowStartMs_ == 0) {
+        windowStartMs_ = nowMs;
+        return false;
+    }
+    if (nowMs - windowStartMs_ < WINDOW_MS) return false;
+    windowStartMs_ = nowMs;
+
+    uint64_t busy = busyUs_.exchange(0, std::memory_order_relaxed);
+    uint64_t callbacks = mixedCallbacks_.exchange(0, std::memory_order_relaxed);
+    if (callbacks == 0) return false;
+    double cycleUs = static_cast<double>(busy) / callbacks;
+    lastCycleUs_.store(cycleUs, std::memory_order_relaxed);
+
+    int current = level_.load(std::memory_order_relaxed);
+    int next = current;
+
+    if (cycleUs > budgetUs_) {
+        cleanWindows_ = 0;
+        if (current < static_cast<int>(Level::ReduceMetadata)) {
+            next = current + 1;
+            if (lastRecoverMs_ != 0 && nowMs - lastRecoverMs_ < FLAP_MS) {
+                recoverWindows_ = std::min(recoverWindows_ * 2, MAX_RECOVER_WINDOWS);
+            }
+        }
+        lastShedMs_ = nowMs;
+    } else if (cycleUs < budgetUs_ * RECOVER_RATIO) {
+        if (current > 0 && ++cleanWindows_ >= recoverWindows_) {
+            next = current - 1;
+            cleanWindows_ = 0;
+            lastRecoverMs_ = nowMs;
+        }
+    } else {
+        cleanWindows_ = 0;
+    }
+
+    if (current == 0 && nowMs - lastShedMs_ >= STABLE_MS) recoverWindows_ = RECOVER_WINDOWS;
+
+    if (next == current) return false;
+    level_.store(next, std::memory_order_relaxed);
+    change = {static_cast<Level>(next), static_cast<Level>(current), cycleUs};
+    return true;
+}
+
+const char* LoadShedder::name(Level level) {
+    switch (level) {
+        case Level::Full: return "full";
+        case Level::ShedShare: return "shed-share";
+        case Level::ReduceVad: return "reduce-vad";
+        case Level::ReduceMetadata: return "reduce-metadata";
+    }
+    return "unknown";
+}
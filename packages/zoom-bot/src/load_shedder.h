@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// CPU-budget watchdog for the SDK audio callbacks. Every callback reports
+// how long it took; once per window the total is spread over the mixed
+// callbacks in that window, giving the processing time spent per 10ms of
+// mixed audio. Over budget, one more level of optional work is shed; after
+// enough consecutive windows comfortably under budget, one level returns.
+// Levels are ordered by what to give up first; the mixed stream itself is
+// never shed.
+//
+// Shedding lowers the measured load, so a level that returns too early is
+// soon shed again. Each such flap doubles the clean windows needed before
+// the next recovery, until load has been stable for a while.
+class LoadShedder {
+public:
+    enum class Level : int {
+        Full = 0,
+        ShedShare = 1,       // share and interpreter audio ignored
+        ReduceVad = 2,       // per-user stats off, speaker election slowed
+        ReduceMetadata = 3,  // speaker updates only on change, fewer audio_stats
+    };
+
+    struct Change {
+        Level level;
+        Level previous;
+        double cycleUs;      // processing per mixed callback in the last window
+    };
+
+    // budgetUs: processing time allowed per mixed callback (0 disables)
+    explicit LoadShedder(uint64_t budgetUs);
+
+    // Any callback, from any SDK thread
+    void record(uint64_t micros, bool mixed);
+
+    // From the mixed callback; true when the level changed, with the details
+    bool evaluate(uint64_t nowMs, Change& change);
+
+    Level level() const { return static_cast<Level>(level_.load(std::memory_order_relaxed)); }
+    bool atLeast(Level level) const { return this->level() >= level; }
+    uint64_t budgetUs() const { return budgetUs_; }
+    double lastCycleUs() const { return lastCycleUs_.load(std::memory_order_relaxed); }
+
+    static const char* name(Level level);
+
+private:
+    static constexpr uint64_t WINDOW_MS = 1000;
+    static constexpr double RECOVER_RATIO = 0.6;
+    static constexpr unsigned int RECOVER_WINDOWS = 3;
+    static constexpr unsigned int MAX_RECOVER_WINDOWS = 96;
+    static constexpr uint64_t FLAP_MS = 30000;      // re-shed this soon after a recovery is a flap
+    static constexpr uint64_t STABLE_MS = 120000;   // no shedding this long resets the backoff
+
+    uint64_t budgetUs_;
+    std::atomic<int> level_{0};
+    std::atomic<uint64_t> busyUs_{0};
+    std::atomic<uint64_t> mixedCallbacks_{0};
+    std::atomic<double> lastCycleUs_{0.0};  // read for metrics from the main loop
+
+    // Touched by evaluate() only
+    uint64_t windowStartMs_ = 0;
+    unsigned int cleanWindows_ = 0;
+    unsigned int recoverWindows_ = RECOVER_WINDOWS;
+    uint64_t lastShedMs_ = 0;
+    uint64_t lastRecoverMs_ = 0;
+};
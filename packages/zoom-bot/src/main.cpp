@@ -1,13 +1,30 @@
 #include "config.h"
 #include "zoom_sdk_manager.h"
 #include "participant_tracker.h"
+#include "roster_batcher.h"
 #include "ws_client.h"
+#include "metrics.h"
+#include "participant_arena.h"
+#include "event_journal.h"
+#include "state_snapshot.h"
+#include "rewind_buffer.h"
+#include "rewind_streamer.h"
+#include "transcription_client.h"
+#include "audio_resampler.h"
+#include "tracer.h"
 #include <glib.h>
 #include <iostream>
 #include <csignal>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sys/resource.h>
+#include <unistd.h>
 
 static GMainLoop* g_loop = nullptr;
 static ZoomSDKManager* g_sdkManager = nullptr;
+static std::string g_tracePath;
+static volatile std::sig_atomic_t g_traceDumpRequested = 0;
 
 void signalHandler(int sig) {
     std::cout << "\n[Main] Received signal " << sig << ", shutting down..." << std::endl;
@@ -20,10 +37,21 @@ void signalHandler(int sig) {
     }
 }
 
+// Only flags the request; the dump itself runs on the main loop
+void traceSignalHandler(int) {
+    g_traceDumpRequested = 1;
+}
+
 // Called periodically by GLib to check if we should exit
 static gboolean checkStatus(gpointer data) {
+    TRACE_SCOPE("checkStatus");
     auto* mgr = static_cast<ZoomSDKManager*>(data);
 
+    if (g_traceDumpRequested) {
+        g_traceDumpRequested = 0;
+        Tracer::dump(g_tracePath);
+    }
+
     if (mgr->hasFailed()) {
         std::cerr << "[Main] SDK operation failed, exiting..." << std::endl;
         g_main_loop_quit(g_loop);
@@ -33,6 +61,114 @@ static gboolean checkStatus(gpointer data) {
     return TRUE;  // Keep calling
 }
 
+// Process CPU time in seconds (user + system)
+static double processCpuSeconds() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+           usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+// Resident set size in MB (0 if /proc is unavailable)
+static double residentMb() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t sizePages = 0;
+    uint64_t residentPages = 0;
+    if (!(statm >> sizePages >> residentPages)) return 0.0;
+    return residentPages * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024 * 1024);
+}
+
+struct MetricsReporter {
+    Metrics* metrics;
+    ParticipantArena* arena;
+    ParticipantTracker* tracker;
+};
+
+// Called periodically by GLib to log the metrics registry
+static gboolean reportMetrics(gpointer data) {
+    TRACE_SCOPE("reportMetrics");
+    auto* reporter = static_cast<MetricsReporter*>(data);
+    Metrics* metrics = reporter->metrics;
+
+    // CPU use of the whole process since the previous report
+    static auto lastWall = std::chrono::steady_clock::now();
+    static double lastCpu = processCpuSeconds();
+    auto wall = std::chrono::steady_clock::now();
+    double cpu = processCpuSeconds();
+    double wallSec = std::chrono::duration<double>(wall - lastWall).count();
+    if (wallSec > 0) metrics->setGauge("process.cpu_pct", 100.0 * (cpu - lastCpu) / wallSec);
+    lastWall = wall;
+    lastCpu = cpu;
+    metrics->setGauge("process.rss_mb", residentMb());
+
+    // Per-participant memory: what the arena holds now and at most, how
+    // much of its block has been carved up, and anything that spilled
+    auto arena = reporter->arena->stats();
+    metrics->setGauge("arena.in_use_kb", arena.inUseBytes / 1024.0);
+    metrics->setGauge("arena.peak_kb", arena.peakBytes / 1024.0);
+    metrics->setGauge("arena.reserved_kb", arena.reservedBytes / 1024.0);
+    metrics->setGauge("arena.overflow_kb", arena.overflowBytes / 1024.0);
+    metrics->setGauge("arena.large_kb", arena.largeBytes / 1024.0);
+    metrics->addCounter("arena.allocations", arena.allocations);
+    metrics->setGauge("participants.names", static_cast<double>(reporter->tracker->names().size()));
+
+    std::string line = metrics->format();
+    if (!line.empty()) {
+        std::cout << "[Metrics] " << line << std::endl;
+    }
+    return TRUE;
+}
+
+// Talk time per participant for the gateway, sent periodically and in
+// answer to a talk_stats_request
+static void sendTalkStats(const ParticipantTracker& tracker, WSClient& wsClient, bool requested) {
+    uint64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    TalkSummary summary = tracker.getTalkStats(nowMs);
+    if (summary.participants.empty() && !requested) return;
+
+    nlohmann::json msg;
+    msg["type"] = "talk_stats";
+    msg["timestamp"] = nowMs;
+    msg["requested"] = requested;
+    msg["speechMs"] = summary.speechMs;
+    msg["overlapMs"] = summary.overlapMs;
+    msg["overlaps"] = summary.overlaps;
+    nlohmann::json participants = nlohmann::json::array();
+    for (const auto& p : summary.participants) {
+        participants.push_back({
+            {"userId", p.userId},
+            {"name", p.name},
+            {"talkMs", p.talkMs},
+            {"turns", p.turns},
+            {"interruptions", p.interruptions},
+            {"overlapMs", p.overlapMs},
+            {"speaking", p.speaking},
+            {"present", p.present}
+        });
+    }
+    msg["participants"] = participants;
+    wsClient.sendMetadata(msg);
+}
+
+struct TalkStatsReporter {
+    ParticipantTracker* tracker;
+    WSClient* wsClient;
+};
+
+static gboolean reportTalkStats(gpointer data) {
+    TRACE_SCOPE("reportTalkStats");
+    auto* reporter = static_cast<TalkStatsReporter*>(data);
+    sendTalkStats(*reporter->tracker, *reporter->wsClient, false);
+    return TRUE;
+}
+
+// Called periodically by GLib to apply and send queued roster changes
+static gboolean flushRoster(gpointer data) {
+    static_cast<RosterBatcher*>(data)->flush();
+    return TRUE;
+}
+
 int main(int argc, char* argv[]) {
     std::cout << "=== Zoom Meeting Transcription Bot ===" << std::endl;
 
@@ -43,15 +179,65 @@ int main(int argc, char* argv[]) {
     // Load configuration
     Config config = Config::load(argc, argv);
 
+    if (!config.tracePath.empty()) {
+        g_tracePath = config.tracePath;
+        Tracer::enable();
+        Tracer::nameThread("main");
+        std::signal(SIGUSR1, traceSignalHandler);
+        std::cout << "[Trace] Recording; kill -USR1 " << getpid() << " writes " << g_tracePath << std::endl;
+    }
+
     // Create components
-    ParticipantTracker tracker;
-    WSClient wsClient;
+    EventJournal journal;
+    // Per-participant state is allocated from one preallocated arena
+    ParticipantArena arena(config.participantArenaMb);
+    ParticipantTracker tracker(&arena);
+    if (!config.journalPath.empty() && journal.open(config.journalPath, config.meetingNumber)) {
+        tracker.setJournal(&journal);
+    }
+
+    // Roster, talk stats and stream position from before a restart, so
+    // names resolve before the SDK has re-enumerated the meeting
+    StateSnapshot state;
+    if (!config.statePath.empty() && state.open(config.statePath, config.meetingNumber)) {
+        if (state.resumed()) tracker.restore(state);
+        tracker.setSnapshot(&state);
+    }
+    Metrics metrics;
+    WSClient wsClient(config, metrics);
+    RosterBatcher roster(config, tracker, wsClient, metrics);
+
+    // Preallocated copy of the last few minutes of outgoing audio, replayed
+    // to the gateway on request over a separate channel
+    RewindBuffer rewind(AudioResampler::OUTPUT_SAMPLE_RATE, config.rewindMinutes);
+    if (config.lockAudioMemory) rewind.lockInMemory();
+    RewindStreamer rewindStreamer(config, rewind, wsClient, metrics);
+
+    // Optionally stream audio to the transcription service directly; the
+    // gateway then gets metadata and the service's results
+    std::unique_ptr<TranscriptionClient> transcriber;
+    if (!config.transcribeUrl.empty()) {
+        transcriber = std::make_unique<TranscriptionClient>(config, metrics);
+        transcriber->onResult([&wsClient](const nlohmann::json& result) { wsClient.sendResult(result); });
+        wsClient.routeAudioTo(transcriber.get());
+    }
+
+    wsClient.onCommand([&](const nlohmann::json& command) {
+        if (command["type"] == "rewind_request" && rewind.enabled()) {
+            rewindStreamer.handleRequest(command);
+        } else if (command["type"] == "transcription_state" && transcriber) {
+            transcriber->setPaused(command.value("paused", true));
+        } else if (command["type"] == "talk_stats_request") {
+            sendTalkStats(tracker, wsClient, true);
+        }
+    });
 
     // Connect to gateway (non-blocking, auto-reconnects)
     wsClient.connect(config.gatewayUrl);
+    if (transcriber) transcriber->connect();
 
     // Initialize SDK
-    ZoomSDKManager sdkManager(config, tracker, wsClient);
+    ZoomSDKManager sdkManager(config, tracker, roster, wsClient, metrics, rewind, state, arena);
     g_sdkManager = &sdkManager;
 
     if (!sdkManager.initialize()) {
@@ -71,6 +257,19 @@ int main(int argc, char* argv[]) {
     // Periodic status check (every 1 second)
     g_timeout_add(1000, checkStatus, &sdkManager);
 
+    // Periodic metrics report, on the same cadence as audio stats
+    MetricsReporter metricsReporter{&metrics, &arena, &tracker};
+    if (config.statsIntervalMs > 0) {
+        g_timeout_add(config.statsIntervalMs, reportMetrics, &metricsReporter);
+    }
+    if (roster.intervalMs() > 0) {
+        g_timeout_add(roster.intervalMs(), flushRoster, &roster);
+    }
+    TalkStatsReporter talkStatsReporter{&tracker, &wsClient};
+    if (config.talkStatsIntervalMs > 0) {
+        g_timeout_add(config.talkStatsIntervalMs, reportTalkStats, &talkStatsReporter);
+    }
+
     std::cout << "[Main] Running event loop (Ctrl+C to exit)..." << std::endl;
 
     // Run the GLib event loop - this drives all SDK callbacks
@@ -79,7 +278,20 @@ int main(int argc, char* argv[]) {
     // Cleanup
     std::cout << "[Main] Shutting down..." << std::endl;
     sdkManager.cleanup();
+    roster.flush();
+    rewindStreamer.stop();
+    if (transcriber) transcriber->disconnect();  // its last results still reach the gateway
     wsClient.disconnect();
+
+    // Close any speech runs still open so they reach the journal
+    auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    tracker.decayActivity(nowMs, 0);
+    tracker.setJournal(nullptr);
+    tracker.setSnapshot(nullptr);
+    journal.close();
+    state.close();
+    if (!g_tracePath.empty()) Tracer::dump(g_tracePath);
     g_main_loop_unref(g_loop);
     g_loop = nullptr;
     g_sdkManager = nullptr;
@@ -4,18 +4,17 @@
 #include "meeting_service_components/meeting_audio_interface.h"
 #include "meeting_service_components/meeting_participants_ctrl_interface.h"
 #include "participant_tracker.h"
-#include "ws_client.h"
+#include "roster_batcher.h"
 #include <functional>
 #include <iostream>
-#include <nlohmann/json.hpp>
 
 class MeetingEventHandler : public ZOOMSDK::IMeetingServiceEvent,
                              public ZOOMSDK::IMeetingParticipantsCtrlEvent {
 public:
     using StatusCallback = std::function<void(ZOOMSDK::MeetingStatus, int)>;
 
-    MeetingEventHandler(ParticipantTracker& tracker, WSClient& wsClient)
-        : tracker_(tracker), wsClient_(wsClient) {}
+    MeetingEventHandler(ParticipantTracker& tracker, RosterBatcher& roster)
+        : tracker_(tracker), roster_(roster) {}
 
     void setStatusCallback(StatusCallback cb) { statusCallback_ = std::move(cb); }
     void setParticipantsController(ZOOMSDK::IMeetingParticipantsController* ctrl) {
@@ -44,24 +43,14 @@ public:
     void onMeetingFullToWatchLiveStream(const zchar_t* sLiveStreamUrl) override {}
     void onUserNetworkStatusChanged(ZOOMSDK::MeetingComponentType type, ZOOMSDK::ConnectionQuality level, unsigned int userId, bool uplink) override {}
 
-    // IMeetingParticipantsCtrlEvent
+    // IMeetingParticipantsCtrlEvent: queued, and applied and sent in batches
     void onUserJoin(ZOOMSDK::IList<unsigned int>* lstUserID, const zchar_t* strUserList = nullptr) override {
         if (!lstUserID || !participantsCtrl_) return;
         for (int i = 0; i < lstUserID->GetCount(); i++) {
             unsigned int userId = lstUserID->GetItem(i);
             auto* userInfo = participantsCtrl_->GetUserByUserID(userId);
             if (userInfo) {
-                std::string name = userInfo->GetUserName() ? userInfo->GetUserName() : "Unknown";
-                tracker_.addParticipant(userId, name);
-
-                // Notify gateway
-                nlohmann::json msg;
-                msg["type"] = "participant_joined";
-                msg["userId"] = userId;
-                msg["name"] = name;
-                msg["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::system_clock::now().time_since_epoch()).count();
-                wsClient_.sendMetadata(msg);
+                roster_.joined(userId, userInfo->GetUserName() ? userInfo->GetUserName() : "Unknown");
             }
         }
     }
@@ -69,17 +58,7 @@ public:
     void onUserLeft(ZOOMSDK::IList<unsigned int>* lstUserID, const zchar_t* strUserList = nullptr) override {
         if (!lstUserID) return;
         for (int i = 0; i < lstUserID->GetCount(); i++) {
-            unsigned int userId = lstUserID->GetItem(i);
-            std::string name = tracker_.getName(userId);
-            tracker_.removeParticipant(userId);
-
-            nlohmann::json msg;
-            msg["type"] = "participant_left";
-            msg["userId"] = userId;
-            msg["name"] = name;
-            msg["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch()).count();
-            wsClient_.sendMetadata(msg);
+            roster_.left(lstUserID->GetItem(i));
         }
     }
 
@@ -94,7 +73,7 @@ public:
             unsigned int userId = lstUserID->GetItem(i);
             auto* userInfo = participantsCtrl_->GetUserByUserID(userId);
             if (userInfo && userInfo->GetUserName()) {
-                tracker_.updateName(userId, userInfo->GetUserName());
+                roster_.renamed(userId, userInfo->GetUserName());
             }
         }
     }
@@ -120,7 +99,7 @@ public:
 
 private:
     ParticipantTracker& tracker_;
-    WSClient& wsClient_;
+    RosterBatcher& roster_;
     StatusCallback statusCallback_;
     ZOOMSDK::IMeetingParticipantsController* participantsCtrl_ = nullptr;
 
@@ -130,13 +109,25 @@ private:
         if (!list) return;
 
         std::cout << "[Meeting] " << list->GetCount() << " participants in meeting" << std::endl;
+        std::vector<ActiveSpeaker> roster;
         for (int i = 0; i < list->GetCount(); i++) {
             unsigned int userId = list->GetItem(i);
             auto* userInfo = participantsCtrl_->GetUserByUserID(userId);
             if (userInfo) {
-                std::string name = userInfo->GetUserName() ? userInfo->GetUserName() : "Unknown";
-                tracker_.addParticipant(userId, name);
+                roster.push_back({userId, userInfo->GetUserName() ? userInfo->GetUserName() : "Unknown"});
             }
         }
+
+        // After a warm restart the tracker already holds the saved roster;
+        // only the differences reach the gateway. Anything still queued
+        // predates the list, so it is applied first.
+        roster_.flush();
+        RosterDiff diff = tracker_.reconcile(roster);
+        roster_.send(diff);
+        if (diff.confirmed > 0 || !diff.left.empty()) {
+            std::cout << "[Meeting] Roster reconciled with the restored state: " << diff.confirmed
+                      << " still here, " << diff.joined.size() << " joined, " << diff.left.size()
+                      << " left, " << diff.renamed.size() << " renamed" << std::endl;
+        }
     }
 };
@@ -0,0 +1,37 @@
+#include "metrics.h"
+#include <sstream>
+#include <iomanip>
+
+void Metrics::setGauge(const std::string& name, double value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gauges_[name] = value;
+}
+
+void Metrics::addCounter(const std::string& name, uint64_t delta) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_[name] += delta;
+}
+
+nlohmann::json Metrics::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nlohmann::json out = nlohmann::json::object();
+    for (const auto& [name, value] : counters_) out[name] = value;
+    for (const auto& [name, value] : gauges_) out[name] = value;
+    return out;
+}
+
+std::string Metrics::format() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1);
+    bool first = true;
+    for (const auto& [name, value] : counters_) {
+        os << (first ? "" : " ") << name << "=" << value;
+        first = false;
+    }
+    for (const auto& [name, value] : gauges_) {
+        os << (first ? "" : " ") << name << "=" << value;
+        first = false;
+    }
+    return os.str();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+// Named gauges and counters reported periodically by the main loop.
+// Subsystems publish here at summary cadence, never per audio frame.
+class Metrics {
+public:
+    void setGauge(const std::string& name, double value);
+    void addCounter(const std::string& name, uint64_t delta = 1);
+
+    nlohmann::json snapshot() const;
+
+    // Single-line "name=value ..." rendering for the log
+    std::string format() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, double> gauges_;
+    std::map<std::string, uint64_t> counters_;
+};
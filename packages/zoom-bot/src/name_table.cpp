@@ -0,0 +1,34 @@
+#include "name_table.h"
+
+NameTable::NameTable(std::pmr::memory_resource* memory) : names_(memory) {}
+
+const std::pmr::string* NameTable::intern(std::string_view name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = names_.find(name);
+    if (it == names_.end()) {
+        // Inserted under the caller's view, then re-keyed to view the stored
+        // copy; map nodes never move, so the key stays valid
+        auto node = names_.extract(names_.try_emplace(name, name).first);
+        node.key() = node.mapped().name;
+        it = names_.insert(std::move(node)).position;
+    }
+    it->second.references++;
+    return &it->second.name;
+}
+
+void NameTable::retain(const std::pmr::string* name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    names_.find(*name)->second.references++;
+}
+
+void NameTable::release(const std::pmr::string* name) {
+    if (!name) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = names_.find(*name);
+    if (--it->second.references == 0) names_.erase(it);
+}
+
+size_t NameTable::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_.size();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Interned participant names. Every distinct name is stored once and
+// handed out as a pointer that stays valid while it is referenced, so
+// roster batches and the tracker pass names around without copying them,
+// and a rejoin or a rename back reuses the stored string. Holders count
+// their references; a name nobody holds any more is freed, so churn does
+// not grow the table.
+//
+// The table is keyed by views of the stored strings, so looking up a name
+// that is already held allocates nothing; a string is only built for a new
+// name.
+class NameTable {
+public:
+    explicit NameTable(std::pmr::memory_resource* memory);
+
+    // The stored copy of name, with one more reference
+    const std::pmr::string* intern(std::string_view name);
+
+    void retain(const std::pmr::string* name);
+    void release(const std::pmr::string* name);
+
+    size_t size() const;
+
+private:
+    // Built by the map with its allocator, so the name shares the table's memory
+    struct Entry {
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+        Entry(std::string_view text, const allocator_type& allocator) : name(text, allocator) {}
+
+        std::pmr::string name;
+        size_t references = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::pmr::unordered_map<std::string_view, Entry> names_;  // keys view Entry::name
+};
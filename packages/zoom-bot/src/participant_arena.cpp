@@ -0,0 +1,99 @@
+#include "participant_arena.h"
+#include <iostream>
+#include <new>
+
+void* ParticipantArena::Carver::do_allocate(size_t bytes, size_t alignment) {
+    void* p = upstream_->allocate(bytes, alignment);
+    carved += bytes;
+    return p;
+}
+
+void ParticipantArena::Carver::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    upstream_->deallocate(p, bytes, alignment);
+}
+
+bool ParticipantArena::Carver::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+ParticipantArena::ParticipantArena(size_t budgetMb)
+    : budget_(budgetMb * 1024 * 1024),
+      // new[] leaves the pages untouched, so they cost nothing until used
+      block_(budget_ > 0 ? new std::byte[budget_] : nullptr),
+      // Without a block only the pools' own bookkeeping lands here
+      carve_(block_.get(), budget_,
+             block_ ? std::pmr::null_memory_resource() : std::pmr::new_delete_resource()),
+      carver_(&carve_),
+      pool_(std::pmr::pool_options{MAX_BLOCKS_PER_CHUNK, MAX_POOLED_BYTES}, &carver_) {}
+
+ParticipantArena::~ParticipantArena() {
+    // The pools hand their chunks back to carve_, which owns nothing
+    pool_.release();
+}
+
+bool ParticipantArena::owns(const void* p) const {
+    auto* byte = static_cast<const std::byte*>(p);
+    return block_ && byte >= block_.get() && byte < block_.get() + budget_;
+}
+
+void* ParticipantArena::do_allocate(size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    void* p = nullptr;
+    if (block_ && bytes <= MAX_POOLED_BYTES) {
+        try {
+            p = pool_.allocate(bytes, alignment);
+        } catch (const std::bad_alloc&) {
+            if (!overflowLogged_) {
+                std::cerr << "[Arena] Participant memory budget of " << budget_ / (1024 * 1024)
+                          << "MB used up, continuing on the heap" << std::endl;
+                overflowLogged_ = true;
+            }
+        }
+    }
+    if (!p) {
+        p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        if (bytes > MAX_POOLED_BYTES) {
+            large_ += bytes;
+        } else if (block_) {
+            overflow_ += bytes;
+        }
+    }
+
+    inUse_ += bytes;
+    if (inUse_ > peak_) peak_ = inUse_;
+    allocations_++;
+    return p;
+}
+
+void ParticipantArena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (owns(p)) {
+        pool_.deallocate(p, bytes, alignment);
+    } else {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        if (bytes > MAX_POOLED_BYTES) {
+            large_ -= bytes;
+        } else if (block_) {
+            overflow_ -= bytes;
+        }
+    }
+    inUse_ -= bytes;
+}
+
+bool ParticipantArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+ParticipantArena::Stats ParticipantArena::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.budgetBytes = budget_;
+    stats.reservedBytes = carver_.carved;
+    stats.inUseBytes = inUse_;
+    stats.peakBytes = peak_;
+    stats.overflowBytes = overflow_;
+    stats.largeBytes = large_;
+    stats.allocations = allocations_;
+    allocations_ = 0;
+    return stats;
+}
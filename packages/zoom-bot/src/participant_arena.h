@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+// Memory for per-participant state: tracker entries, interned names and
+// stream-worker mailboxes with their frame buffers. It all comes from one
+// block reserved up front (ZOOM_BOT_PARTICIPANT_ARENA_MB), carved into
+// size-class pools. What a participant frees on leaving goes back to its
+// pool and is handed to the next one, so hours of churn reuse the same
+// pages instead of fragmenting the heap. Pages of the block are only
+// committed as they are first used.
+//
+// Past the budget, allocations fall back to the heap so a bigger meeting
+// than planned still works; that overflow is counted and logged once.
+// Blocks larger than MAX_POOLED_BYTES (the bucket arrays of tables holding
+// thousands of participants) come straight from the heap and are counted
+// separately. Thread-safe.
+class ParticipantArena : public std::pmr::memory_resource {
+public:
+    struct Stats {
+        size_t budgetBytes = 0;
+        size_t reservedBytes = 0;   // carved out of the block by the pools
+        size_t inUseBytes = 0;      // held by live allocations
+        size_t peakBytes = 0;
+        size_t overflowBytes = 0;   // live allocations past the budget, from the heap
+        size_t largeBytes = 0;      // live allocations over MAX_POOLED_BYTES, from the heap
+        uint64_t allocations = 0;   // since the last stats() call
+    };
+
+    // budgetMb 0: no arena, everything comes from the heap (still counted)
+    explicit ParticipantArena(size_t budgetMb);
+    ~ParticipantArena() override;
+
+    Stats stats();
+
+    static constexpr size_t MAX_POOLED_BYTES = 128 * 1024;
+
+private:
+    // Pools grow a chunk at a time, doubling up to this many blocks; kept
+    // small so the last chunks still fit in what is left of the block
+    static constexpr size_t MAX_BLOCKS_PER_CHUNK = 16;
+
+    // Counts what the pools take out of the block
+    class Carver : public std::pmr::memory_resource {
+    public:
+        explicit Carver(std::pmr::memory_resource* upstream) : upstream_(upstream) {}
+        size_t carved = 0;
+
+    private:
+        std::pmr::memory_resource* upstream_;
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    std::mutex mutex_;
+    size_t budget_;
+    std::unique_ptr<std::byte[]> block_;
+    std::pmr::monotonic_buffer_resource carve_;
+    Carver carver_;
+    std::pmr::unsynchronized_pool_resource pool_;
+
+    size_t inUse_ = 0;
+    size_t peak_ = 0;
+    size_t overflow_ = 0;
+    size_t large_ = 0;
+    uint64_t allocations_ = 0;
+    bool overflowLogged_ = false;
+
+    bool owns(const void* p) const;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
@@ -1,35 +1,179 @@
 #include "participant_tracker.h"
+#include <algorithm>
 #include <iostream>
+#include <unordered_set>
 
-void ParticipantTracker::addParticipant(uint32_t userId, const std::string& name) {
+ParticipantTracker::ParticipantTracker(std::pmr::memory_resource* memory)
+    : participants_(memory), names_(memory) {}
+
+void ParticipantTracker::setJournal(EventJournal* journal) {
     std::lock_guard<std::mutex> lock(mutex_);
-    participants_[userId] = {userId, name, 0, false};
-    std::cout << "[Participants] Added: " << name << " (ID: " << userId << ")" << std::endl;
+    journal_ = journal;
 }
 
-void ParticipantTracker::removeParticipant(uint32_t userId) {
+void ParticipantTracker::setSnapshot(StateSnapshot* snapshot) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = participants_.find(userId);
-    if (it != participants_.end()) {
-        std::cout << "[Participants] Removed: " << it->second.name << " (ID: " << userId << ")" << std::endl;
-        participants_.erase(it);
+    snapshot_ = snapshot;
+
+    // Overwrite what was restored, so runs closed by restore() are not
+    // closed a second time after another restart
+    for (const auto& [id, info] : participants_) save(info);
+    saveTotals();
+}
+
+void ParticipantTracker::restore(const StateSnapshot& snapshot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto& totals = snapshot.restoredTotals();
+    std::vector<uint64_t> cutShort;  // last activity of runs open at the restart
+    for (const auto& p : snapshot.restoredParticipants()) {
+        ParticipantInfo info{p.userId, names_.intern(p.name)};
+        info.lastActiveTimestamp = p.lastActiveMs;
+        info.runStartTimestamp = p.runStartMs;
+        info.talkMs = p.talkMs;
+        info.turns = p.turns;
+        info.interruptions = p.interruptions;
+        info.overlapMs = p.overlapMs;
+        info.provisional = true;
+        if (p.active && p.lastActiveMs >= p.runStartMs) {
+            // Cut short by the restart: it ends at its last activity
+            info.talkMs += p.lastActiveMs - p.runStartMs;
+            endRun(info);
+            cutShort.push_back(p.lastActiveMs);
+        }
+        participants_[p.userId] = std::move(info);
     }
+
+    // The clocks were last advanced at a transition, when every open run
+    // was already going; from there, someone talked until the latest of
+    // those runs ended and two or more until the second latest did
+    speechMs_ = totals.speechMs;
+    overlapMs_ = totals.overlapMs;
+    overlaps_ = totals.overlaps;
+    std::sort(cutShort.rbegin(), cutShort.rend());
+    if (cutShort.size() >= 1 && cutShort[0] > totals.clockMs) speechMs_ += cutShort[0] - totals.clockMs;
+    if (cutShort.size() >= 2 && cutShort[1] > totals.clockMs) overlapMs_ += cutShort[1] - totals.clockMs;
+    std::cout << "[Participants] Restored " << participants_.size() << " participants from before the restart"
+              << std::endl;
 }
 
-void ParticipantTracker::updateName(uint32_t userId, const std::string& name) {
+RosterDiff ParticipantTracker::reconcile(const std::vector<ActiveSpeaker>& roster) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = participants_.find(userId);
-    if (it != participants_.end()) {
-        it->second.name = name;
+    RosterDiff diff;
+    std::unordered_set<uint32_t> present;
+
+    for (const auto& entry : roster) {
+        present.insert(entry.userId);
+        const std::pmr::string* name = names_.intern(entry.name);
+        auto [it, inserted] = participants_.try_emplace(entry.userId, ParticipantInfo{entry.userId, nullptr});
+        auto& info = it->second;
+        if (inserted) {
+            setName(info, name);
+            if (journal_) journal_->participantJoined(entry.userId, *name);
+            diff.joined.push_back(entry);
+            save(info);
+        } else {
+            if (info.provisional) diff.confirmed++;
+            info.provisional = false;
+            if (info.name != name) {
+                setName(info, name);
+                if (journal_) journal_->participantRenamed(entry.userId, *name);
+                diff.renamed.push_back(entry);
+                save(info);
+            }
+        }
+        names_.release(name);
+    }
+
+    // Restored participants the SDK no longer lists left during the restart
+    for (auto it = participants_.begin(); it != participants_.end();) {
+        if (it->second.provisional && present.count(it->first) == 0) {
+            diff.left.push_back({it->first, std::string(*it->second.name)});
+            retire(it->second);
+            names_.release(it->second.name);
+            it = participants_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return diff;
+}
+
+RosterDiff ParticipantTracker::apply(const std::vector<RosterChange>& changes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RosterDiff diff;
+    bool logEach = changes.size() <= LOG_EACH_MAX;
+
+    for (const auto& change : changes) {
+        auto it = participants_.find(change.userId);
+        switch (change.kind) {
+            case RosterChange::Kind::Join: {
+                if (it == participants_.end()) {
+                    it = participants_.emplace(change.userId, ParticipantInfo{change.userId, nullptr}).first;
+                    setName(it->second, change.name);
+                    if (journal_) journal_->participantJoined(change.userId, *change.name);
+                    diff.joined.push_back({change.userId, std::string(*change.name)});
+                    if (logEach) {
+                        std::cout << "[Participants] Added: " << *change.name << " (ID: " << change.userId << ")"
+                                  << std::endl;
+                    }
+                } else {
+                    if (it->second.provisional) diff.confirmed++;
+                    it->second.provisional = false;
+                    if (it->second.name == change.name) break;
+                    setName(it->second, change.name);
+                    if (journal_) journal_->participantRenamed(change.userId, *change.name);
+                    diff.renamed.push_back({change.userId, std::string(*change.name)});
+                }
+                save(it->second);
+                break;
+            }
+            case RosterChange::Kind::Rename:
+                if (it == participants_.end() || it->second.name == change.name) break;
+                setName(it->second, change.name);
+                if (journal_) journal_->participantRenamed(change.userId, *change.name);
+                diff.renamed.push_back({change.userId, std::string(*change.name)});
+                save(it->second);
+                break;
+            case RosterChange::Kind::Leave:
+                if (it == participants_.end()) break;
+                if (logEach) {
+                    std::cout << "[Participants] Removed: " << *it->second.name << " (ID: " << change.userId
+                              << ")" << std::endl;
+                }
+                diff.left.push_back({change.userId, std::string(*it->second.name)});
+                retire(it->second);
+                names_.release(it->second.name);
+                participants_.erase(it);
+                break;
+        }
+    }
+
+    if (!logEach) {
+        std::cout << "[Participants] " << diff.joined.size() << " joined, " << diff.left.size() << " left, "
+                  << diff.renamed.size() << " renamed (" << participants_.size() << " in the meeting)"
+                  << std::endl;
     }
+    return diff;
 }
 
 void ParticipantTracker::markActive(uint32_t userId, uint64_t timestamp) {
     std::lock_guard<std::mutex> lock(mutex_);
     auto it = participants_.find(userId);
     if (it != participants_.end()) {
-        it->second.isActive = true;
-        it->second.lastActiveTimestamp = timestamp;
+        auto& info = it->second;
+        if (!info.isActive) {
+            info.runStartTimestamp = timestamp;
+            startRun(info, timestamp);
+        } else if (timestamp - info.runStartTimestamp >= journal::MAX_RUN_MS) {
+            // Split long runs so journal readers can bound their seeks; the
+            // split is not a new turn
+            endRun(info);
+            info.talkMs += info.lastActiveTimestamp - info.runStartTimestamp;
+            info.runStartTimestamp = info.lastActiveTimestamp;
+        }
+        info.isActive = true;
+        info.lastActiveTimestamp = timestamp;
+        save(info);
     }
 }
 
@@ -38,7 +182,7 @@ std::vector<ActiveSpeaker> ParticipantTracker::getActiveSpeakers() const {
     std::vector<ActiveSpeaker> speakers;
     for (const auto& [id, info] : participants_) {
         if (info.isActive) {
-            speakers.push_back({info.userId, info.name});
+            speakers.push_back({info.userId, std::string(*info.name)});
         }
     }
     return speakers;
@@ -48,7 +192,9 @@ void ParticipantTracker::decayActivity(uint64_t currentTimestamp, uint64_t thres
     std::lock_guard<std::mutex> lock(mutex_);
     for (auto& [id, info] : participants_) {
         if (info.isActive && (currentTimestamp - info.lastActiveTimestamp) > thresholdMs) {
-            info.isActive = false;
+            endRun(info);
+            stopRun(info);
+            save(info);
         }
     }
 }
@@ -57,7 +203,7 @@ std::string ParticipantTracker::getName(uint32_t userId) const {
     std::lock_guard<std::mutex> lock(mutex_);
     auto it = participants_.find(userId);
     if (it != participants_.end()) {
-        return it->second.name;
+        return std::string(*it->second.name);
     }
     return "Unknown";
 }
@@ -70,3 +216,111 @@ std::vector<ParticipantInfo> ParticipantTracker::getAllParticipants() const {
     }
     return result;
 }
+
+TalkSummary ParticipantTracker::getTalkStats(uint64_t currentTimestamp) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TalkSummary summary;
+
+    // Project the meeting clocks to now without advancing them
+    uint64_t sinceClock = currentTimestamp > clockMs_ ? currentTimestamp - clockMs_ : 0;
+    summary.speechMs = speechMs_ + (activeCount_ >= 1 ? sinceClock : 0);
+    summary.overlapMs = overlapMs_ + (activeCount_ >= 2 ? sinceClock : 0);
+    summary.overlaps = overlaps_;
+
+    for (const auto& [id, info] : participants_) {
+        if (info.turns == 0) continue;
+        TalkStats stats = snapshot(info);
+        if (info.isActive) {
+            stats.talkMs += info.lastActiveTimestamp - info.runStartTimestamp;
+            // The clock is projected to now, the run only to its last activity
+            stats.overlapMs = std::min(stats.overlapMs + summary.overlapMs - info.runOverlapStart, stats.talkMs);
+        }
+        summary.participants.push_back(std::move(stats));
+    }
+    summary.participants.insert(summary.participants.end(), departed_.begin(), departed_.end());
+
+    std::sort(summary.participants.begin(), summary.participants.end(),
+              [](const TalkStats& a, const TalkStats& b) { return a.talkMs > b.talkMs; });
+    return summary;
+}
+
+uint64_t ParticipantTracker::advanceClocks(uint64_t timestamp) {
+    // Runs end at their last active time, which can be earlier than a
+    // transition already counted; the clocks never run backwards
+    if (timestamp > clockMs_) {
+        uint64_t elapsed = timestamp - clockMs_;
+        if (activeCount_ >= 1) speechMs_ += elapsed;
+        if (activeCount_ >= 2) overlapMs_ += elapsed;
+        clockMs_ = timestamp;
+    }
+    return clockMs_;
+}
+
+void ParticipantTracker::startRun(ParticipantInfo& info, uint64_t timestamp) {
+    advanceClocks(timestamp);
+    if (activeCount_ > 0) info.interruptions++;
+    if (activeCount_ == 1) overlaps_++;
+    info.turns++;
+    info.runOverlapStart = overlapMs_;
+    activeCount_++;
+    saveTotals();
+}
+
+void ParticipantTracker::stopRun(ParticipantInfo& info) {
+    advanceClocks(info.lastActiveTimestamp);
+    info.talkMs += info.lastActiveTimestamp - info.runStartTimestamp;
+    info.overlapMs = std::min(info.overlapMs + overlapMs_ - info.runOverlapStart, info.talkMs);
+    info.isActive = false;
+    activeCount_--;
+    saveTotals();
+}
+
+TalkStats ParticipantTracker::snapshot(const ParticipantInfo& info) {
+    return {info.userId, std::string(*info.name), info.talkMs, info.turns, info.interruptions, info.overlapMs,
+            info.isActive, true};
+}
+
+// Closes a departing participant's run and keeps their talk stats
+void ParticipantTracker::retire(ParticipantInfo& info) {
+    if (info.isActive) {
+        endRun(info);
+        stopRun(info);
+    }
+    if (info.turns > 0) {
+        departed_.push_back(snapshot(info));
+        departed_.back().present = false;
+        if (departed_.size() > MAX_DEPARTED) departed_.erase(departed_.begin());
+    }
+    if (journal_) journal_->participantLeft(info.userId);
+    if (snapshot_) snapshot_->removeParticipant(info.userId);
+}
+
+// Takes a reference to the new name and drops the one to the old
+void ParticipantTracker::setName(ParticipantInfo& info, const std::pmr::string* name) {
+    names_.retain(name);
+    names_.release(info.name);
+    info.name = name;
+}
+
+void ParticipantTracker::save(const ParticipantInfo& info) {
+    if (!snapshot_) return;
+    StateSnapshot::Participant p;
+    p.userId = info.userId;
+    p.name = *info.name;
+    p.runStartMs = info.runStartTimestamp;
+    p.lastActiveMs = info.lastActiveTimestamp;
+    p.active = info.isActive;
+    p.talkMs = info.talkMs;
+    p.turns = info.turns;
+    p.interruptions = info.interruptions;
+    p.overlapMs = info.overlapMs;
+    snapshot_->putParticipant(p);
+}
+
+void ParticipantTracker::saveTotals() {
+    if (snapshot_) snapshot_->putTotals({speechMs_, overlapMs_, overlaps_, clockMs_});
+}
+
+void ParticipantTracker::endRun(const ParticipantInfo& info) {
+    if (journal_) journal_->speakerRun(info.userId, info.runStartTimestamp, info.lastActiveTimestamp);
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "event_journal.h"
+#include "name_table.h"
+#include "state_snapshot.h"
+#include <memory_resource>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -8,9 +12,39 @@
 
 struct ParticipantInfo {
     uint32_t userId;
-    std::string name;
+    const std::pmr::string* name;  // interned in the tracker's NameTable, one reference held
     uint64_t lastActiveTimestamp = 0;
+    uint64_t runStartTimestamp = 0;  // start of the current speech run
     bool isActive = false;
+
+    // Talk-time statistics, updated when the participant starts or stops
+    // speaking; the current run is added when a snapshot is taken
+    uint64_t talkMs = 0;
+    uint32_t turns = 0;           // speech runs started
+    uint32_t interruptions = 0;   // runs started while someone else was talking
+    uint64_t overlapMs = 0;       // time spent talking over someone else
+    uint64_t runOverlapStart = 0; // meeting overlap clock when the current run began
+
+    bool provisional = false;     // restored from the state file, not yet in the SDK roster
+};
+
+// One participant's share of the meeting's talk time
+struct TalkStats {
+    uint32_t userId;
+    std::string name;
+    uint64_t talkMs;
+    uint32_t turns;
+    uint32_t interruptions;
+    uint64_t overlapMs;
+    bool speaking;
+    bool present;   // false once the participant has left
+};
+
+struct TalkSummary {
+    uint64_t speechMs;   // time with at least one person talking
+    uint64_t overlapMs;  // time with two or more talking at once
+    uint32_t overlaps;   // stretches of two or more talking at once
+    std::vector<TalkStats> participants;  // everyone who has spoken, most talk time first
 };
 
 struct ActiveSpeaker {
@@ -18,11 +52,53 @@ struct ActiveSpeaker {
     std::string name;
 };
 
+// One roster event from the SDK, with its name interned (the tracker
+// takes its own reference to names it keeps)
+struct RosterChange {
+    enum class Kind { Join, Leave, Rename };
+    Kind kind;
+    uint32_t userId;
+    const std::pmr::string* name;  // null for Leave
+};
+
+// Changes made to the tracker's roster by a batch or a reconcile
+struct RosterDiff {
+    std::vector<ActiveSpeaker> joined;   // not known before
+    std::vector<ActiveSpeaker> left;     // gone, with the name they had
+    std::vector<ActiveSpeaker> renamed;  // known under another name
+    size_t confirmed = 0;                // restored and still there
+
+    bool empty() const { return joined.empty() && left.empty() && renamed.empty(); }
+};
+
 class ParticipantTracker {
 public:
-    void addParticipant(uint32_t userId, const std::string& name);
-    void removeParticipant(uint32_t userId);
-    void updateName(uint32_t userId, const std::string& name);
+    // Entries and names are allocated from memory (the participant arena)
+    explicit ParticipantTracker(std::pmr::memory_resource* memory);
+
+    // Record roster changes and speech runs (optional, may be null)
+    void setJournal(EventJournal* journal);
+
+    // Keep a warm-restart copy of the roster and talk stats (optional, may
+    // be null). Set after restore().
+    void setSnapshot(StateSnapshot* snapshot);
+
+    // Take over the roster and talk stats a restarted bot saved. Restored
+    // participants are provisional until reconcile() or their join confirms
+    // them; speech runs cut short by the restart are closed at their last
+    // activity.
+    void restore(const StateSnapshot& snapshot);
+
+    // Bring the roster in line with the SDK's full participant list
+    RosterDiff reconcile(const std::vector<ActiveSpeaker>& roster);
+
+    // Apply a batch of joins, leaves and renames under one lock. A join of
+    // someone already known (restored, or reported twice) keeps their talk
+    // stats.
+    RosterDiff apply(const std::vector<RosterChange>& changes);
+
+    // Names shared with roster batches
+    NameTable& names() { return names_; }
 
     // Mark a participant as actively speaking
     void markActive(uint32_t userId, uint64_t timestamp);
@@ -39,7 +115,40 @@ public:
     // Get all participants
     std::vector<ParticipantInfo> getAllParticipants() const;
 
+    // Talk time, turns, interruptions and overlap so far, including runs
+    // still in progress at currentTimestamp
+    TalkSummary getTalkStats(uint64_t currentTimestamp) const;
+
 private:
     mutable std::mutex mutex_;
-    std::unordered_map<uint32_t, ParticipantInfo> participants_;
+    std::pmr::unordered_map<uint32_t, ParticipantInfo> participants_;
+    NameTable names_;
+    EventJournal* journal_ = nullptr;
+    StateSnapshot* snapshot_ = nullptr;
+
+    // Meeting-wide clocks, advanced only on activity transitions. A run's
+    // overlap is how far the overlap clock moved during it: while one
+    // participant talks, two or more talking means someone talks over them.
+    size_t activeCount_ = 0;
+    uint64_t clockMs_ = 0;
+    uint64_t speechMs_ = 0;
+    uint64_t overlapMs_ = 0;
+    uint32_t overlaps_ = 0;
+
+    // Stats of participants who left after speaking, oldest first
+    std::vector<TalkStats> departed_;
+    static constexpr size_t MAX_DEPARTED = 256;
+
+    // Batches larger than this are logged as one summary line
+    static constexpr size_t LOG_EACH_MAX = 8;
+
+    uint64_t advanceClocks(uint64_t timestamp);
+    void startRun(ParticipantInfo& info, uint64_t timestamp);
+    void stopRun(ParticipantInfo& info);
+    void endRun(const ParticipantInfo& info);
+    void retire(ParticipantInfo& info);
+    void setName(ParticipantInfo& info, const std::pmr::string* name);
+    void save(const ParticipantInfo& info);
+    void saveTotals();
+    static TalkStats snapshot(const ParticipantInfo& info);
 };
@@ -0,0 +1,18 @@
+#include "reconnect_policy.h"
+#include <algorithm>
+
+ReconnectPolicy::ReconnectPolicy(uint32_t baseMs, uint32_t maxMs, uint32_t stableMs)
+    : baseMs_(baseMs), maxMs_(std::max(baseMs, maxMs)), stableMs_(stableMs), rng_(std::random_device{}()) {}
+
+uint32_t ReconnectPolicy::nextDelayMs() {
+    uint32_t attempt = attempts_++;
+    if (attempt == 0) return 0;
+
+    // base * 2^(attempt-1), capped; shift bounded to avoid overflow
+    uint64_t ceiling = static_cast<uint64_t>(baseMs_) << std::min<uint32_t>(attempt - 1, 16);
+    ceiling = std::min<uint64_t>(ceiling, maxMs_);
+
+    // Jitter over the upper half of the window keeps a floor under the delay
+    std::uniform_int_distribution<uint64_t> dist(ceiling / 2, ceiling);
+    return static_cast<uint32_t>(dist(rng_));
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+// Delay schedule for gateway reconnects. The first attempt after a
+// disconnect is immediate, since most drops are brief network blips; after
+// that the delay grows exponentially from baseMs up to maxMs, with random
+// jitter so a gateway restart is not hit by every bot at once. A peer that
+// accepts and then closes straight away (overloaded, or rejecting us after
+// the upgrade) counts as a failed attempt: the schedule only starts over
+// once a connection has stayed up for stableMs.
+class ReconnectPolicy {
+public:
+    ReconnectPolicy(uint32_t baseMs, uint32_t maxMs, uint32_t stableMs = 10000);
+
+    // Delay before the next attempt, in ms
+    uint32_t nextDelayMs();
+
+    // Call when a connection closes after being up for upMs
+    void connectionClosed(uint64_t upMs) {
+        if (upMs >= stableMs_) attempts_ = 0;
+    }
+
+    uint32_t attempts() const { return attempts_; }
+
+private:
+    uint32_t baseMs_;
+    uint32_t maxMs_;
+    uint32_t stableMs_;
+    uint32_t attempts_ = 0;
+    std::mt19937 rng_;
+};
@@ -0,0 +1,107 @@
+#include "rewind_buffer.h"
+#include "thread_profile.h"
+#include <algorithm>
+#include <cstring>
+
+RewindBuffer::RewindBuffer(unsigned int sampleRate, unsigned int minutes)
+    : sampleRate_(sampleRate),
+      capacity_(static_cast<size_t>(sampleRate) * 60 * minutes),
+      samples_(capacity_ > 0 ? new int16_t[capacity_]() : nullptr),
+      anchorSlots_(capacity_ > 0 ? capacity_ / sampleRate + 2 : 0),
+      anchors_(anchorSlots_ > 0 ? new std::atomic<uint64_t>[anchorSlots_] : nullptr) {
+    for (size_t i = 0; i < anchorSlots_; i++) anchors_[i].store(0, std::memory_order_relaxed);
+}
+
+void RewindBuffer::write(const int16_t* samples, size_t count, uint64_t captureMs) {
+    if (!enabled() || count == 0) return;
+    uint64_t position = written_.load(std::memory_order_relaxed);
+
+    for (uint64_t k = (position + sampleRate_ - 1) / sampleRate_; k * sampleRate_ < position + count; k++) {
+        uint64_t offsetMs = (k * sampleRate_ - position) * 1000 / sampleRate_;
+        anchors_[k % anchorSlots_].store(captureMs + offsetMs, std::memory_order_relaxed);
+    }
+
+    size_t slot = position % capacity_;
+    size_t head = std::min(count, capacity_ - slot);
+    std::memcpy(&samples_[slot], samples, head * sizeof(int16_t));
+    std::memcpy(&samples_[0], samples + head, (count - head) * sizeof(int16_t));
+
+    written_.store(position + count, std::memory_order_release);
+}
+
+bool RewindBuffer::locate(uint64_t fromMs, uint64_t toMs, Range& range) const {
+    if (!enabled()) return false;
+    uint64_t written = written_.load(std::memory_order_acquire);
+    if (written == 0) return false;
+    uint64_t oldest = oldestHeld(written);
+
+    range.first = positionAt(fromMs, oldest, written);
+    range.end = positionAt(toMs, oldest, written);
+    if (range.end <= range.first) return false;
+    range.fromMs = timeAt(range.first);
+    range.toMs = timeAt(range.end);
+    return true;
+}
+
+bool RewindBuffer::read(uint64_t first, size_t count, int16_t* out) const {
+    if (!enabled()) return false;
+    uint64_t written = written_.load(std::memory_order_acquire);
+    if (first < oldestHeld(written) || first + count > written) return false;
+
+    size_t slot = first % capacity_;
+    size_t head = std::min(count, capacity_ - slot);
+    std::memcpy(out, &samples_[slot], head * sizeof(int16_t));
+    std::memcpy(out + head, &samples_[0], (count - head) * sizeof(int16_t));
+
+    // The writer may have moved on while we copied
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return first >= oldestHeld(written_.load(std::memory_order_relaxed));
+}
+
+double RewindBuffer::heldSeconds() const {
+    uint64_t written = written_.load(std::memory_order_relaxed);
+    return static_cast<double>(written - oldestHeld(written)) / sampleRate_;
+}
+
+void RewindBuffer::lockInMemory() const {
+    if (!enabled()) return;
+    lockMemory(samples_.get(), capacity_ * sizeof(int16_t), "rewind buffer");
+}
+
+uint64_t RewindBuffer::oldestHeld(uint64_t written) const {
+    // Keep 100ms clear of the slots the writer is about to overwrite, more
+    // than any one callback writes, so a reader's copy is checked against
+    // where the writer could be rather than where it was
+    uint64_t margin = sampleRate_ / 10;
+    return written + margin > capacity_ ? written + margin - capacity_ : 0;
+}
+
+uint64_t RewindBuffer::positionAt(uint64_t ms, uint64_t oldest, uint64_t written) const {
+    // Anchors held: the first at or after oldest, up to the last written
+    uint64_t lo = (oldest + sampleRate_ - 1) / sampleRate_;
+    uint64_t hi = (written - 1) / sampleRate_;
+    if (lo > hi) return oldest;
+
+    auto anchorAt = [this](uint64_t k) { return anchors_[k % anchorSlots_].load(std::memory_order_relaxed); };
+    // Offsets beyond the ring's length only ever clamp; cap them before scaling
+    uint64_t spanMs = capacity_ * 1000 / sampleRate_;
+    if (ms < anchorAt(lo)) {
+        uint64_t back = std::min(anchorAt(lo) - ms, spanMs) * sampleRate_ / 1000;
+        return lo * sampleRate_ > oldest + back ? lo * sampleRate_ - back : oldest;
+    }
+
+    // Last anchor at or before ms
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo + 1) / 2;
+        if (anchorAt(mid) <= ms) lo = mid; else hi = mid - 1;
+    }
+    uint64_t position = lo * sampleRate_ + std::min(ms - anchorAt(lo), spanMs) * sampleRate_ / 1000;
+    return std::min(position, written);
+}
+
+uint64_t RewindBuffer::timeAt(uint64_t position) const {
+    uint64_t written = written_.load(std::memory_order_relaxed);
+    uint64_t k = std::min(position / sampleRate_, written > 0 ? (written - 1) / sampleRate_ : 0);
+    uint64_t anchor = anchors_[k % anchorSlots_].load(std::memory_order_relaxed);
+    return anchor + (position - k * sampleRate_) * 1000 / sampleRate_;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// The last few minutes of the outgoing mixed stream (16kHz mono, after
+// concealment), kept so a stretch the gateway failed to transcribe can be
+// sent again. All memory is allocated and touched in the constructor; the
+// ring then overwrites its oldest audio.
+//
+// Samples are addressed by their position in the stream. Once per second of
+// stream, the wall-clock capture time of that sample is stored as an
+// anchor; wall-clock ranges are mapped to positions through the anchors.
+//
+// One writer (the SDK audio thread) and any number of readers, without
+// locks: a reader copies first and then checks that the writer has not
+// lapped the copied span in the meantime.
+class RewindBuffer {
+public:
+    struct Range {
+        uint64_t first = 0;   // stream position of the first sample
+        uint64_t end = 0;     // one past the last sample
+        uint64_t fromMs = 0;  // capture time of first
+        uint64_t toMs = 0;    // capture time of end
+    };
+
+    // minutes == 0 disables the buffer
+    RewindBuffer(unsigned int sampleRate, unsigned int minutes);
+
+    bool enabled() const { return capacity_ > 0; }
+    unsigned int sampleRate() const { return sampleRate_; }
+
+    // captureMs: wall-clock time of samples[0]
+    void write(const int16_t* samples, size_t count, uint64_t captureMs);
+
+    // The held part of [fromMs, toMs); false if none of it is held
+    bool locate(uint64_t fromMs, uint64_t toMs, Range& range) const;
+
+    // Copies count samples from stream position first; false if any of
+    // them are no longer (or not yet) held
+    bool read(uint64_t first, size_t count, int16_t* out) const;
+
+    // Seconds of audio currently held
+    double heldSeconds() const;
+
+    void lockInMemory() const;
+
+private:
+    unsigned int sampleRate_;
+    size_t capacity_;
+    std::unique_ptr<int16_t[]> samples_;
+
+    // anchors_[k % anchorSlots_] = capture time of stream position k * sampleRate_
+    size_t anchorSlots_;
+    std::unique_ptr<std::atomic<uint64_t>[]> anchors_;
+
+    std::atomic<uint64_t> written_{0};
+
+    uint64_t oldestHeld(uint64_t written) const;
+    uint64_t positionAt(uint64_t ms, uint64_t oldest, uint64_t written) const;
+    uint64_t timeAt(uint64_t position) const;
+};
@@ -0,0 +1,149 @@
+#include "rewind_streamer.h"
+#include "tracer.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <ixwebsocket/IXWebSocket.h>
+
+RewindStreamer::RewindStreamer(const Config& config, const RewindBuffer& buffer, WSClient& wsClient,
+                               Metrics& metrics)
+    : buffer_(buffer), wsClient_(wsClient), metrics_(metrics),
+      gatewayUrl_(config.gatewayUrl), caFile_(config.gatewayCaFile),
+      speed_(config.rewindSpeed) {}
+
+RewindStreamer::~RewindStreamer() {
+    stop();
+}
+
+void RewindStreamer::stop() {
+    std::lock_guard<std::mutex> lock(workerMutex_);
+    stopping_ = true;
+    wakeup_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+void RewindStreamer::handleRequest(const nlohmann::json& request) {
+    std::string requestId = request.value("requestId", "");
+    uint64_t fromMs = request.value("fromMs", uint64_t(0));
+    uint64_t toMs = request.value("toMs", uint64_t(0));
+    metrics_.addCounter("rewind.requests");
+
+    // The id goes into the rewind channel's URL
+    bool validId = !requestId.empty() && requestId.size() <= 64 &&
+        std::all_of(requestId.begin(), requestId.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_';
+        });
+    if (!validId || toMs <= fromMs) {
+        std::cerr << "[Rewind] Ignoring malformed request" << std::endl;
+        sendStatus(requestId, "invalid");
+        return;
+    }
+
+    RewindBuffer::Range range;
+    if (gatewayUrl_.compare(0, 6, "shm://") == 0 || !buffer_.locate(fromMs, toMs, range)) {
+        std::cout << "[Rewind] " << requestId << ": requested audio is not held" << std::endl;
+        sendStatus(requestId, "unavailable");
+        return;
+    }
+
+    if (busy_.exchange(true)) {
+        std::cout << "[Rewind] " << requestId << ": another rewind is streaming" << std::endl;
+        sendStatus(requestId, "busy");
+        return;
+    }
+    std::lock_guard<std::mutex> lock(workerMutex_);
+    if (stopping_) return;
+    if (worker_.joinable()) worker_.join();  // the previous stream has finished
+    worker_ = std::thread([this, requestId, range] {
+        stream(requestId, range);
+        busy_ = false;
+    });
+}
+
+void RewindStreamer::stream(const std::string& requestId, RewindBuffer::Range range) {
+    Tracer::nameThread("rewind");
+    TRACE_SCOPE("rewind.stream");
+
+    std::string base = gatewayUrl_;
+    while (!base.empty() && base.back() == '/') base.pop_back();
+
+    ix::WebSocket ws;
+    ws.setUrl(base + "/rewind?requestId=" + requestId);
+    if (!caFile_.empty()) {
+        ix::SocketTLSOptions tls;
+        tls.caFile = caFile_;
+        ws.setTLSOptions(tls);
+    }
+    ws.disableAutomaticReconnection();
+
+    auto result = ws.connect(HANDSHAKE_TIMEOUT_S);
+    if (!result.success) {
+        std::cerr << "[Rewind] " << requestId << ": cannot open rewind channel: " << result.errorStr << std::endl;
+        sendStatus(requestId, "failed");
+        return;
+    }
+
+    unsigned int rate = buffer_.sampleRate();
+    std::cout << "[Rewind] " << requestId << ": streaming " << (range.toMs - range.fromMs) / 1000.0
+              << "s at " << (speed_ > 0 ? std::to_string(speed_) + "x" : std::string("full speed")) << std::endl;
+
+    nlohmann::json start;
+    start["type"] = "rewind_start";
+    start["requestId"] = requestId;
+    start["fromMs"] = range.fromMs;
+    start["toMs"] = range.toMs;
+    start["sampleRate"] = rate;
+    ws.sendText(start.dump());
+
+    size_t chunkSamples = rate * CHUNK_MS / 1000;
+    std::vector<int16_t> chunk(chunkSamples);
+    auto interval = std::chrono::microseconds(speed_ > 0 ? CHUNK_MS * 1000 / speed_ : 0);
+    auto deadline = std::chrono::steady_clock::now();
+    uint64_t position = range.first;
+    bool complete = true;
+
+    while (position < range.end) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(chunkSamples, range.end - position));
+        // Replay started near the oldest end and the live audio caught up
+        if (!buffer_.read(position, count, chunk.data())) {
+            complete = false;
+            break;
+        }
+        if (!ws.sendBinary(std::string(reinterpret_cast<const char*>(chunk.data()),
+                                       count * sizeof(int16_t))).success) {
+            complete = false;
+            break;
+        }
+        position += count;
+
+        deadline += interval;
+        std::unique_lock<std::mutex> lock(waitMutex_);
+        if (wakeup_.wait_until(lock, deadline, [this] { return stopping_.load(); })) {
+            complete = false;
+            break;
+        }
+    }
+
+    uint64_t sentMs = (position - range.first) * 1000 / rate;
+    nlohmann::json end;
+    end["type"] = "rewind_end";
+    end["requestId"] = requestId;
+    end["sentMs"] = sentMs;
+    end["complete"] = complete;
+    ws.sendText(end.dump());
+    ws.close();
+
+    metrics_.addCounter("rewind.streamed_ms", sentMs);
+    std::cout << "[Rewind] " << requestId << ": sent " << sentMs << "ms"
+              << (complete ? "" : " (stopped early)") << std::endl;
+}
+
+void RewindStreamer::sendStatus(const std::string& requestId, const char* status) {
+    nlohmann::json msg;
+    msg["type"] = "rewind_status";
+    msg["requestId"] = requestId;
+    msg["status"] = status;
+    wsClient_.sendMetadata(msg);
+}
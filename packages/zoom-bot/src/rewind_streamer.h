@@ -0,0 +1,56 @@
+#pragma once
+
+#include "config.h"
+#include "metrics.h"
+#include "rewind_buffer.h"
+#include "ws_client.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+// Answers the gateway's rewind_request commands from the rewind buffer. Each
+// request is streamed over its own WebSocket (<gateway>/rewind?requestId=..)
+// so replayed audio never enters the live stream, at a multiple of real
+// time. One stream at a time; requests that cannot be served are answered
+// with a rewind_status message on the main connection.
+//
+// Rewind channel protocol:
+//   text   {"type":"rewind_start","requestId","fromMs","toMs","sampleRate"}
+//   binary 16kHz mono 16-bit PCM, 100ms per frame
+//   text   {"type":"rewind_end","requestId","sentMs","complete"}
+class RewindStreamer {
+public:
+    RewindStreamer(const Config& config, const RewindBuffer& buffer, WSClient& wsClient, Metrics& metrics);
+    ~RewindStreamer();
+
+    // {"type":"rewind_request","requestId":"..","fromMs":..,"toMs":..}
+    // (wall clock ms); called on the network thread
+    void handleRequest(const nlohmann::json& request);
+
+    // Abandons any stream in progress
+    void stop();
+
+private:
+    const RewindBuffer& buffer_;
+    WSClient& wsClient_;
+    Metrics& metrics_;
+    std::string gatewayUrl_;
+    std::string caFile_;
+    unsigned int speed_;
+
+    std::mutex workerMutex_;  // guards worker_ between the network thread and stop()
+    std::thread worker_;
+    std::atomic<bool> busy_{false};
+    std::atomic<bool> stopping_{false};
+    std::mutex waitMutex_;
+    std::condition_variable wakeup_;
+
+    void stream(const std::string& requestId, RewindBuffer::Range range);
+    void sendStatus(const std::string& requestId, const char* status);
+
+    static constexpr unsigned int CHUNK_MS = 100;
+    static constexpr int HANDSHAKE_TIMEOUT_S = 5;
+};
@@ -0,0 +1,91 @@
+#include "roster_batcher.h"
+#include "tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+nlohmann::json toJson(const std::vector<ActiveSpeaker>& entries) {
+    nlohmann::json list = nlohmann::json::array();
+    for (const auto& e : entries) list.push_back({{"userId", e.userId}, {"name", e.name}});
+    return list;
+}
+
+} // namespace
+
+RosterBatcher::RosterBatcher(const Config& config, ParticipantTracker& tracker, WSClient& wsClient,
+                             Metrics& metrics)
+    : tracker_(tracker), wsClient_(wsClient), metrics_(metrics),
+      intervalMs_(config.rosterBatchMs),
+      maxBatch_(std::max<size_t>(1, config.rosterBatchMax)) {
+    pending_.reserve(maxBatch_);
+}
+
+void RosterBatcher::joined(uint32_t userId, const std::string& name) {
+    queue({RosterChange::Kind::Join, userId, tracker_.names().intern(name)});
+}
+
+void RosterBatcher::left(uint32_t userId) {
+    queue({RosterChange::Kind::Leave, userId, nullptr});
+}
+
+void RosterBatcher::renamed(uint32_t userId, const std::string& name) {
+    queue({RosterChange::Kind::Rename, userId, tracker_.names().intern(name)});
+}
+
+void RosterBatcher::queue(RosterChange change) {
+    using Kind = RosterChange::Kind;
+    NameTable& names = tracker_.names();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = pendingIndex_.find(change.userId);
+    if (it == pendingIndex_.end()) {
+        pendingIndex_.emplace(change.userId, pending_.size());
+        pending_.push_back(change);
+    } else if (change.kind == Kind::Rename) {
+        // Renaming a queued join or rename updates its name; a queued leave stands
+        RosterChange& entry = pending_[it->second];
+        if (entry.kind != Kind::Leave) std::swap(entry.name, change.name);
+        names.release(change.name);
+    } else {
+        // Otherwise the latest event wins. A leave replacing a join of
+        // someone the tracker never had is ignored when applied.
+        names.release(pending_[it->second].name);
+        pending_[it->second] = change;
+    }
+
+    if (intervalMs_ == 0 || pending_.size() >= maxBatch_) flushLocked();
+}
+
+void RosterBatcher::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flushLocked();
+}
+
+void RosterBatcher::flushLocked() {
+    if (pending_.empty()) return;
+    TRACE_SCOPE("roster_batch");
+
+    RosterDiff diff = tracker_.apply(pending_);
+    metrics_.addCounter("roster.batches");
+    metrics_.addCounter("roster.changes", pending_.size());
+    for (const auto& change : pending_) tracker_.names().release(change.name);
+    pending_.clear();
+    pendingIndex_.clear();
+
+    send(diff);
+}
+
+void RosterBatcher::send(const RosterDiff& diff) {
+    if (diff.empty()) return;
+
+    nlohmann::json msg;
+    msg["type"] = "participants_delta";
+    msg["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    msg["joined"] = toJson(diff.joined);
+    msg["left"] = toJson(diff.left);
+    msg["renamed"] = toJson(diff.renamed);
+    wsClient_.sendMetadata(msg);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "config.h"
+#include "metrics.h"
+#include "participant_tracker.h"
+#include "ws_client.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Coalesces SDK roster events into batches. When a large meeting starts,
+// hundreds of joins arrive within a second; one at a time, each would take
+// the tracker lock, log, and send its own message. Instead, joins, leaves
+// and renames are queued with their names interned, and every
+// ZOOM_BOT_ROSTER_BATCH_MS (or as soon as ZOOM_BOT_ROSTER_BATCH_MAX are
+// queued) the batch is applied to the tracker in one call and sent to the
+// gateway as a single participants_delta.
+//
+// Within a batch only the net change per participant is kept, so someone
+// who joins and leaves again before the flush is never announced.
+class RosterBatcher {
+public:
+    RosterBatcher(const Config& config, ParticipantTracker& tracker, WSClient& wsClient, Metrics& metrics);
+
+    // SDK callbacks
+    void joined(uint32_t userId, const std::string& name);
+    void left(uint32_t userId);
+    void renamed(uint32_t userId, const std::string& name);
+
+    // Applies and sends whatever is queued; from the batch timer, and at shutdown
+    void flush();
+
+    // Sends changes already applied to the tracker (a full roster reconcile)
+    void send(const RosterDiff& diff);
+
+    unsigned int intervalMs() const { return intervalMs_; }
+
+private:
+    ParticipantTracker& tracker_;
+    WSClient& wsClient_;
+    Metrics& metrics_;
+    unsigned int intervalMs_;
+    size_t maxBatch_;
+
+    std::mutex mutex_;
+    std::vector<RosterChange> pending_;
+    std::unordered_map<uint32_t, size_t> pendingIndex_;  // userId -> entry in pending_
+
+    void queue(RosterChange change);
+    void flushLocked();
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+// Layout of the shared-memory ring used by the shm:// gateway transport.
+// Shared by the bot (ShmTransport, writer) and the local reader library
+// (ShmReader). Single producer, single consumer.
+//
+// The ring lives in a memfd created by the bot and handed to the reader over
+// a Unix socket with SCM_RIGHTS, together with an eventfd used for wakeups.
+// After the handshake the same socket carries the reader's commands to the
+// bot, one JSON text per SOCK_SEQPACKET message; the bot never writes to it.
+// Records are 16-byte aligned and never wrap: when the tail of the data area
+// is too short, the writer fills it with a padding record and starts again
+// at offset 0.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace shm {
+
+constexpr uint32_t MAGIC = 0x5a42534d;  // "ZBSM"
+constexpr uint32_t VERSION = 2;  // 2: reader commands over the socket
+
+enum class RecordType : uint16_t {
+    Audio = 1,     // 16 kHz mono 16-bit PCM
+    Metadata = 2,  // JSON text, same messages as WebSocket text frames
+    Padding = 3,   // skip to the start of the data area
+};
+
+struct RecordHeader {
+    uint32_t length;       // payload bytes, excluding this header
+    uint16_t type;         // RecordType
+    uint16_t flags;
+    uint64_t timestampNs;  // steady clock at write time, for latency measurement
+};
+static_assert(sizeof(RecordHeader) == 16, "RecordHeader must stay 16 bytes");
+
+struct RingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;  // bytes in the data area, power of two
+
+    alignas(64) std::atomic<uint64_t> writePos;  // monotonic byte positions
+    alignas(64) std::atomic<uint64_t> readPos;
+    std::atomic<uint32_t> readerWaiting;         // reader is about to block on the eventfd
+    alignas(64) std::atomic<uint64_t> dropped;   // records dropped because the ring was full
+};
+
+// Handshake message sent with the memfd and eventfd
+struct Hello {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t mappingSize;  // sizeof header area + capacity
+};
+
+constexpr size_t HEADER_AREA = 256;  // data area starts here
+static_assert(sizeof(RingHeader) <= HEADER_AREA, "RingHeader must fit in the header area");
+
+constexpr size_t recordSize(size_t payload) {
+    return (sizeof(RecordHeader) + payload + 15) & ~static_cast<size_t>(15);
+}
+
+} // namespace shm
@@ -0,0 +1,217 @@
+#include "shm_transport.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static size_t roundUpPowerOfTwo(size_t v) {
+    size_t p = 4096;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+ShmTransport::ShmTransport(size_t ringBytes) : capacity_(roundUpPowerOfTwo(ringBytes)) {}
+
+ShmTransport::~ShmTransport() {
+    disconnect();
+}
+
+void ShmTransport::connect(const std::string& socketPath) {
+    socketPath_ = socketPath;
+    running_ = true;
+    std::cout << "[SHM] Connecting to reader at " << socketPath_ << std::endl;
+    monitor_ = std::thread([this] { monitorLoop(); });
+}
+
+void ShmTransport::disconnect() {
+    running_ = false;
+    if (monitor_.joinable()) monitor_.join();
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    close();
+}
+
+bool ShmTransport::sendAudio(const char* pcm, size_t len) {
+    return write(shm::RecordType::Audio, pcm, len);
+}
+
+bool ShmTransport::sendMetadata(const std::string& json) {
+    return write(shm::RecordType::Metadata, json.data(), json.size());
+}
+
+bool ShmTransport::write(shm::RecordType type, const char* payload, size_t len) {
+    if (!connected_) return false;
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (!header_) return false;
+
+    size_t total = shm::recordSize(len);
+    if (total > capacity_ / 2) return false;
+
+    uint64_t w = header_->writePos.load(std::memory_order_relaxed);
+    uint64_t r = header_->readPos.load(std::memory_order_acquire);
+    size_t offset = w & (capacity_ - 1);
+    size_t contiguous = capacity_ - offset;
+    size_t needed = total + (contiguous < total ? contiguous : 0);
+
+    if (w + needed - r > capacity_) {
+        // Reader is not keeping up; drop rather than block the audio thread
+        header_->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (contiguous < total) {
+        auto* pad = reinterpret_cast<shm::RecordHeader*>(data_ + offset);
+        pad->length = static_cast<uint32_t>(contiguous - sizeof(shm::RecordHeader));
+        pad->type = static_cast<uint16_t>(shm::RecordType::Padding);
+        pad->flags = 0;
+        pad->timestampNs = 0;
+        w += contiguous;
+        offset = 0;
+    }
+
+    auto* rec = reinterpret_cast<shm::RecordHeader*>(data_ + offset);
+    rec->length = static_cast<uint32_t>(len);
+    rec->type = static_cast<uint16_t>(type);
+    rec->flags = 0;
+    rec->timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::memcpy(data_ + offset + sizeof(shm::RecordHeader), payload, len);
+
+    // Publish, then wake the reader only if it has gone to sleep. Both sides
+    // use seq_cst here so the reader cannot miss a record it just checked for.
+    header_->writePos.store(w + total, std::memory_order_seq_cst);
+    if (header_->readerWaiting.load(std::memory_order_seq_cst)) {
+        uint64_t one = 1;
+        ssize_t n = ::write(eventFd_, &one, sizeof(one));
+        (void)n;
+    }
+    return true;
+}
+
+bool ShmTransport::open() {
+    int sock = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sock < 0) return false;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath_.c_str(), sizeof(addr.sun_path) - 1);
+    if (::connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(sock);
+        return false;
+    }
+
+    size_t mappingSize = shm::HEADER_AREA + capacity_;
+    int memFd = memfd_create("zoom-bot-ring", MFD_CLOEXEC);
+    int eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    void* mapping = MAP_FAILED;
+    if (memFd >= 0 && eventFd >= 0 && ftruncate(memFd, mappingSize) == 0) {
+        mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, memFd, 0);
+    }
+    if (mapping == MAP_FAILED) {
+        std::cerr << "[SHM] Failed to create ring: " << std::strerror(errno) << std::endl;
+        if (memFd >= 0) ::close(memFd);
+        if (eventFd >= 0) ::close(eventFd);
+        ::close(sock);
+        return false;
+    }
+
+    auto* header = new (mapping) shm::RingHeader();
+    header->magic = shm::MAGIC;
+    header->version = shm::VERSION;
+    header->capacity = capacity_;
+
+    // Hand the memfd and eventfd to the reader
+    shm::Hello hello{shm::MAGIC, shm::VERSION, mappingSize};
+    iovec iov{&hello, sizeof(hello)};
+    char control[CMSG_SPACE(2 * sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(2 * sizeof(int));
+    int fds[2] = {memFd, eventFd};
+    std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    if (::sendmsg(sock, &msg, MSG_NOSIGNAL) < 0) {
+        std::cerr << "[SHM] Handshake failed: " << std::strerror(errno) << std::endl;
+        munmap(mapping, mappingSize);
+        ::close(memFd);
+        ::close(eventFd);
+        ::close(sock);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    socketFd_ = sock;
+    memFd_ = memFd;
+    eventFd_ = eventFd;
+    mapping_ = mapping;
+    mappingSize_ = mappingSize;
+    header_ = header;
+    data_ = static_cast<char*>(mapping) + shm::HEADER_AREA;
+    connected_ = true;
+    std::cout << "[SHM] Connected to reader (" << capacity_ / 1024 << " KB ring)" << std::endl;
+    return true;
+}
+
+void ShmTransport::close() {
+    connected_ = false;
+    if (mapping_) munmap(mapping_, mappingSize_);
+    if (memFd_ >= 0) ::close(memFd_);
+    if (eventFd_ >= 0) ::close(eventFd_);
+    if (socketFd_ >= 0) ::close(socketFd_);
+    mapping_ = nullptr;
+    header_ = nullptr;
+    data_ = nullptr;
+    memFd_ = eventFd_ = socketFd_ = -1;
+}
+
+void ShmTransport::monitorLoop() {
+    bool loggedWaiting = false;
+    while (running_) {
+        if (!connected_) {
+            if (open()) {
+                loggedWaiting = false;
+            } else {
+                if (!loggedWaiting) {
+                    std::cout << "[SHM] Reader not available, retrying..." << std::endl;
+                    loggedWaiting = true;
+                }
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+            }
+            continue;
+        }
+
+        pollfd pfd{socketFd_, POLLIN, 0};
+        if (poll(&pfd, 1, 200) > 0 && !receive()) {
+            std::cout << "[SHM] Reader disconnected" << std::endl;
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            close();
+        }
+    }
+}
+
+bool ShmTransport::receive() {
+    // One command per message; end of file or an error means the reader
+    // went away
+    char buffer[MAX_COMMAND_BYTES];
+    ssize_t n = ::recv(socketFd_, buffer, sizeof(buffer), MSG_DONTWAIT | MSG_TRUNC);
+    if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    if (n == 0) return false;
+    if (static_cast<size_t>(n) > sizeof(buffer)) {
+        std::cerr << "[SHM] Ignoring " << n << "-byte command from reader" << std::endl;
+        return true;
+    }
+    if (messageHandler_) messageHandler_(std::string(buffer, static_cast<size_t>(n)));
+    return true;
+}
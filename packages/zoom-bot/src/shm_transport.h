@@ -0,0 +1,61 @@
+#pragma once
+
+#include "shm_ring.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Gateway transport for a co-located reader (shm:// URLs). Audio and
+// metadata frames are written once into a memfd-backed ring shared with the
+// reader process; an eventfd wakes the reader only when it is idle. The
+// reader's Unix socket is used for the handshake, for the reader's commands
+// (one JSON text per message, as in gateway WebSocket text frames) and to
+// detect it going away, after which the transport reconnects with a fresh
+// ring.
+class ShmTransport {
+public:
+    explicit ShmTransport(size_t ringBytes);
+    ~ShmTransport();
+
+    // socketPath: Unix socket the reader listens on
+    void connect(const std::string& socketPath);
+    void disconnect();
+
+    bool sendAudio(const char* pcm, size_t len);
+    bool sendMetadata(const std::string& json);
+
+    bool isConnected() const { return connected_; }
+
+    // Commands from the reader; called on the monitor thread. Set before connect().
+    using MessageHandler = std::function<void(const std::string&)>;
+    void onMessage(MessageHandler handler) { messageHandler_ = std::move(handler); }
+
+private:
+    static constexpr size_t MAX_COMMAND_BYTES = 64 * 1024;
+
+    size_t capacity_;
+    std::string socketPath_;
+    MessageHandler messageHandler_;
+
+    std::mutex writeMutex_;  // audio and metadata come from different threads
+    int socketFd_ = -1;
+    int memFd_ = -1;
+    int eventFd_ = -1;
+    void* mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+    shm::RingHeader* header_ = nullptr;
+    char* data_ = nullptr;
+
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> running_{false};
+    std::thread monitor_;
+
+    bool write(shm::RecordType type, const char* payload, size_t len);
+    bool open();
+    void close();
+    void monitorLoop();
+    bool receive();
+};
@@ -0,0 +1,270 @@
+#include "speaker_change_detector.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// One radix-2 stage over split real/imaginary arrays: for each block of
+// 2 * half, x[k] += w[k] * x[k + half] and x[k + half] = x[k] - w[k] * x[k + half]
+void butterflies(float* re, float* im, size_t n, size_t half, const float* wr, const float* wi) {
+    for (size_t start = 0; start < n; start += 2 * half) {
+        float* ar = re + start;
+        float* ai = im + start;
+        float* br = ar + half;
+        float* bi = ai + half;
+        size_t k = 0;
+#if defined(__SSE2__)
+        for (; k + 4 <= half; k += 4) {
+            __m128 xr = _mm_loadu_ps(br + k);
+            __m128 xi = _mm_loadu_ps(bi + k);
+            __m128 cr = _mm_loadu_ps(wr + k);
+            __m128 ci = _mm_loadu_ps(wi + k);
+            __m128 tr = _mm_sub_ps(_mm_mul_ps(xr, cr), _mm_mul_ps(xi, ci));
+            __m128 ti = _mm_add_ps(_mm_mul_ps(xr, ci), _mm_mul_ps(xi, cr));
+            __m128 yr = _mm_loadu_ps(ar + k);
+            __m128 yi = _mm_loadu_ps(ai + k);
+            _mm_storeu_ps(ar + k, _mm_add_ps(yr, tr));
+            _mm_storeu_ps(ai + k, _mm_add_ps(yi, ti));
+            _mm_storeu_ps(br + k, _mm_sub_ps(yr, tr));
+            _mm_storeu_ps(bi + k, _mm_sub_ps(yi, ti));
+        }
+#endif
+        for (; k < half; k++) {
+            float tr = br[k] * wr[k] - bi[k] * wi[k];
+            float ti = br[k] * wi[k] + bi[k] * wr[k];
+            br[k] = ar[k] - tr;
+            bi[k] = ai[k] - ti;
+            ar[k] += tr;
+            ai[k] += ti;
+        }
+    }
+}
+
+// power[i] = re[i]^2 + im[i]^2
+void powerSpectrum(const float* re, const float* im, float* power, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= n; i += 4) {
+        __m128 r = _mm_loadu_ps(re + i);
+        __m128 m = _mm_loadu_ps(im + i);
+        _mm_storeu_ps(power + i, _mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(m, m)));
+    }
+#endif
+    for (; i < n; i++) power[i] = re[i] * re[i] + im[i] * im[i];
+}
+
+// sum[i] += x[i]; squares[i] += x[i]^2, for n a multiple of 4
+void accumulate(const float* x, float* sum, float* squares, size_t n) {
+#if defined(__SSE2__)
+    for (size_t i = 0; i < n; i += 4) {
+        __m128 v = _mm_loadu_ps(x + i);
+        _mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), v));
+        _mm_storeu_ps(squares + i, _mm_add_ps(_mm_loadu_ps(squares + i), _mm_mul_ps(v, v)));
+    }
+#else
+    for (size_t i = 0; i < n; i++) {
+        sum[i] += x[i];
+        squares[i] += x[i] * x[i];
+    }
+#endif
+}
+
+double melOf(double hz) { return 2595.0 * std::log10(1.0 + hz / 700.0); }
+double hzOf(double mel) { return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0); }
+
+} // namespace
+
+SpeakerChangeDetector::SpeakerChangeDetector(double speechRms)
+    : speechPower_(static_cast<float>(speechRms * speechRms)),
+      window_(FRAME_SAMPLES), windowLag_(MAX_LAG + 1, 0.0f), bitReverse_(FFT_SIZE),
+      twiddleRe_(FFT_SIZE), twiddleIm_(FFT_SIZE),
+      re_(FFT_SIZE), im_(FFT_SIZE), power_(FFT_SIZE),
+      features_(HISTORY * BANDS, 0.0f), speech_(HISTORY, 0), pitch_(HISTORY, 0.0f) {
+    const double pi = std::acos(-1.0);
+    for (size_t i = 0; i < FRAME_SAMPLES; i++) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * pi * i / (FRAME_SAMPLES - 1)));
+    }
+    for (size_t lag = 0; lag <= MAX_LAG; lag++) {
+        for (size_t i = 0; i + lag < FRAME_SAMPLES; i++) windowLag_[lag] += window_[i] * window_[i + lag];
+    }
+    for (size_t i = 0; i < FFT_SIZE; i++) {
+        size_t r = 0;
+        for (size_t b = 0; b < FFT_BITS; b++) r |= ((i >> b) & 1) << (FFT_BITS - 1 - b);
+        bitReverse_[i] = static_cast<uint16_t>(r);
+    }
+    for (size_t half = 1; half < FFT_SIZE; half *= 2) {
+        for (size_t k = 0; k < half; k++) {
+            twiddleRe_[half + k] = static_cast<float>(std::cos(-pi * k / half));
+            twiddleIm_[half + k] = static_cast<float>(std::sin(-pi * k / half));
+        }
+    }
+
+    double binHz = static_cast<double>(SAMPLE_RATE) / FFT_SIZE;
+    double lowMel = melOf(LOW_HZ);
+    double stepMel = (melOf(HIGH_HZ) - lowMel) / BANDS;
+    for (size_t b = 0; b < BANDS; b++) {
+        size_t first = static_cast<size_t>(std::lround(hzOf(lowMel + b * stepMel) / binHz));
+        size_t last = static_cast<size_t>(std::lround(hzOf(lowMel + (b + 1) * stepMel) / binHz));
+        bands_.push_back({first, std::max(last, first + 1)});
+    }
+
+    pending_.reserve(FRAME_SAMPLES + SAMPLE_RATE);
+}
+
+void SpeakerChangeDetector::push(const int16_t* samples, size_t count, std::vector<Change>& changes) {
+    pending_.insert(pending_.end(), samples, samples + count);
+    samples_ += count;
+
+    size_t offset = 0;
+    while (pending_.size() - offset >= FRAME_SAMPLES) {
+        analyse(pending_.data() + offset);
+        offset += HOP_SAMPLES;
+        uint64_t frame = frames_++;
+
+        // The candidate has RIGHT_FRAMES of audio after it, this frame included
+        if (frame + 1 < RIGHT_FRAMES) continue;
+        uint64_t candidate = frame + 1 - RIGHT_FRAMES;
+        float distance = 0.0f;
+        bool valid = distanceAt(candidate, distance);
+
+        // Report the previous candidate once the distance has peaked there
+        if (lastValid_ && lastDistance_ >= THRESHOLD && (!valid || distance < lastDistance_) &&
+            lastCandidate_ >= segmentStart_ + MIN_TURN_FRAMES) {
+            uint64_t boundary = frameBase_ + lastCandidate_ * HOP_SAMPLES;
+            changes.push_back({samples_ - boundary, lastDistance_});
+            segmentStart_ = lastCandidate_;
+            valid = false;
+        }
+        lastValid_ = valid;
+        lastDistance_ = distance;
+        lastCandidate_ = candidate;
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + offset);
+}
+
+void SpeakerChangeDetector::skip(size_t count) {
+    samples_ += count;
+    pending_.clear();
+    frameBase_ = samples_;
+    frames_ = 0;
+    segmentStart_ = 0;
+    lastValid_ = false;
+}
+
+void SpeakerChangeDetector::analyse(const int16_t* frame) {
+    float energy = 0.0f;
+    for (size_t i = 0; i < FRAME_SAMPLES; i++) {
+        float s = frame[i];
+        energy += s * s;
+    }
+    size_t slot = frames_ % HISTORY;
+    speech_[slot] = energy >= speechPower_ * FRAME_SAMPLES;
+    if (!speech_[slot]) return;
+
+    std::fill(re_.begin(), re_.end(), 0.0f);
+    std::fill(im_.begin(), im_.end(), 0.0f);
+    for (size_t i = 0; i < FRAME_SAMPLES; i++) re_[bitReverse_[i]] = frame[i] * window_[i];
+    transform();
+    powerSpectrum(re_.data(), im_.data(), power_.data(), power_.size());
+
+    // Spectral shape: log band energies relative to their mean
+    float* feature = &features_[slot * BANDS];
+    float mean = 0.0f;
+    for (size_t b = 0; b < BANDS; b++) {
+        float sum = 0.0f;
+        for (size_t k = bands_[b].first; k < bands_[b].last; k++) sum += power_[k];
+        feature[b] = std::log(sum + 1.0f);
+        mean += feature[b];
+    }
+    mean /= BANDS;
+    for (size_t b = 0; b < BANDS; b++) feature[b] -= mean;
+
+    pitch_[slot] = pitch();
+}
+
+float SpeakerChangeDetector::pitch() {
+    // The power spectrum transformed again is the frame's autocorrelation
+    // (scaled by FFT_SIZE, which the ratios below cancel)
+    for (size_t k = 0; k < FFT_SIZE; k++) re_[bitReverse_[k]] = power_[k];
+    std::fill(im_.begin(), im_.end(), 0.0f);
+    transform();
+    float zero = re_[0];
+    if (zero <= 0.0f) return 0.0f;
+
+    // Normalised for the window's taper; the shortest lag near the best
+    // one is taken, as multiples of the period correlate almost as well
+    float best = 0.0f;
+    for (size_t lag = MIN_LAG; lag <= MAX_LAG; lag++) {
+        im_[lag] = re_[lag] / zero * windowLag_[0] / windowLag_[lag];
+        best = std::max(best, im_[lag]);
+    }
+    if (best < VOICING) return 0.0f;
+    size_t lag = MIN_LAG;
+    while (im_[lag] < best * OCTAVE_RATIO) lag++;
+
+    // Between samples: the vertex of a parabola through the peak and its neighbours
+    float period = static_cast<float>(lag);
+    if (lag > MIN_LAG && lag < MAX_LAG) {
+        float left = im_[lag - 1], centre = im_[lag], right = im_[lag + 1];
+        float curvature = left - 2.0f * centre + right;
+        if (curvature < 0.0f) period += 0.5f * (left - right) / curvature;
+    }
+    return std::log2(static_cast<float>(SAMPLE_RATE) / period);
+}
+
+void SpeakerChangeDetector::transform() {
+    for (size_t half = 1; half < FFT_SIZE; half *= 2) {
+        butterflies(re_.data(), im_.data(), FFT_SIZE, half, &twiddleRe_[half], &twiddleIm_[half]);
+    }
+}
+
+bool SpeakerChangeDetector::distanceAt(uint64_t candidate, float& distance) {
+    static_assert(BANDS % 4 == 0, "bands are accumulated four at a time");
+    float sum[2][BANDS] = {};
+    float squares[2][BANDS] = {};
+    size_t count[2] = {0, 0};
+    float pitchSum[2] = {0.0f, 0.0f};
+    float pitchSquares[2] = {0.0f, 0.0f};
+    size_t voiced[2] = {0, 0};
+
+    uint64_t first = std::max<uint64_t>(segmentStart_, candidate >= LEFT_FRAMES ? candidate - LEFT_FRAMES : 0);
+    uint64_t end = candidate + RIGHT_FRAMES;
+    for (uint64_t f = first; f < end; f++) {
+        size_t slot = f % HISTORY;
+        if (!speech_[slot]) continue;
+        int side = f < candidate ? 0 : 1;
+        accumulate(&features_[slot * BANDS], sum[side], squares[side], BANDS);
+        count[side]++;
+        if (pitch_[slot] > 0.0f) {
+            pitchSum[side] += pitch_[slot];
+            pitchSquares[side] += pitch_[slot] * pitch_[slot];
+            voiced[side]++;
+        }
+    }
+    if (count[0] < MIN_LEFT_SPEECH || count[1] < MIN_RIGHT_SPEECH) return false;
+
+    float total = 0.0f;
+    for (size_t b = 0; b < BANDS; b++) {
+        float meanL = sum[0][b] / count[0];
+        float meanR = sum[1][b] / count[1];
+        float varL = std::max(squares[0][b] / count[0] - meanL * meanL, 0.0f);
+        float varR = std::max(squares[1][b] / count[1] - meanR * meanR, 0.0f);
+        float diff = meanL - meanR;
+        total += diff * diff / (varL + varR + VARIANCE_FLOOR);
+    }
+    distance = total / BANDS;
+
+    if (voiced[0] >= MIN_VOICED && voiced[1] >= MIN_VOICED) {
+        float meanL = pitchSum[0] / voiced[0];
+        float meanR = pitchSum[1] / voiced[1];
+        float varL = std::max(pitchSquares[0] / voiced[0] - meanL * meanL, 0.0f);
+        float varR = std::max(pitchSquares[1] / voiced[1] - meanR * meanR, 0.0f);
+        float diff = meanL - meanR;
+        distance += PITCH_WEIGHT * diff * diff / (varL + varR + PITCH_VARIANCE_FLOOR);
+    }
+    return true;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Finds turn boundaries in the outgoing mixed stream from the audio alone,
+// so they arrive long before diarized results and also split participants
+// who share one user id (dial-in rooms, a phone bridge).
+//
+// The stream is cut into 25ms frames every 10ms and each frame gets two
+// features from one FFT: its spectral shape (power summed into mel-spaced
+// bands, log band energies minus their mean so loudness drops out) and, for
+// voiced frames, its pitch (log2 of F0, from the autocorrelation computed
+// as the inverse transform of the power spectrum). The shape follows the
+// vowel as much as the voice, so pitch carries most of the weight.
+//
+// At every frame, the candidate boundary RIGHT_FRAMES back splits the
+// speech frames around it into a left window of up to LEFT_FRAMES and a
+// right window of RIGHT_FRAMES, and the two are compared feature by
+// feature:
+//
+//   d = (meanL - meanR)^2 / (varL + varR + floor)
+//   distance = mean d over bands + PITCH_WEIGHT * d for pitch
+//
+// A change is reported at the candidate where the distance peaks above
+// THRESHOLD. The left window never reaches back past the previous change,
+// so it describes only the current talker. Reports trail the boundary by
+// the right window plus one frame, under 200ms.
+//
+// Silent frames are skipped, so pauses neither trigger changes nor dilute
+// the windows. Not thread-safe: push from the SDK audio thread.
+class SpeakerChangeDetector {
+public:
+    struct Change {
+        uint64_t samplesAgo;  // boundary, counted back from the end of the audio pushed so far
+        double distance;
+    };
+
+    // speechRms: minimum RMS level (16-bit scale) of a frame that counts as speech
+    explicit SpeakerChangeDetector(double speechRms);
+
+    // 16kHz mono; appends any boundaries found to changes
+    void push(const int16_t* samples, size_t count, std::vector<Change>& changes);
+
+    // Audio that was not analysed (shed under load): positions stay aligned,
+    // and the next boundary is searched for from scratch
+    void skip(size_t count);
+
+    static constexpr unsigned int SAMPLE_RATE = 16000;
+
+private:
+    static constexpr size_t FRAME_SAMPLES = 400;   // 25ms
+    static constexpr size_t HOP_SAMPLES = 160;     // 10ms
+    static constexpr size_t FFT_SIZE = 1024;       // twice the frame, so autocorrelation does not wrap
+    static constexpr size_t FFT_BITS = 10;
+    static constexpr size_t BANDS = 24;            // multiple of 4 for the vector loops
+    static constexpr double LOW_HZ = 100.0;
+    static constexpr double HIGH_HZ = 7000.0;
+    static constexpr size_t MIN_LAG = SAMPLE_RATE / 400;  // pitch search range, 60-400Hz
+    static constexpr size_t MAX_LAG = SAMPLE_RATE / 60;
+    static constexpr float VOICING = 0.4f;         // normalised autocorrelation at the pitch lag
+    static constexpr float OCTAVE_RATIO = 0.9f;    // shortest lag this close to the best one wins
+
+    static constexpr size_t LEFT_FRAMES = 100;     // 1s before the candidate
+    static constexpr size_t RIGHT_FRAMES = 12;     // 120ms after it
+    static constexpr size_t MIN_LEFT_SPEECH = 30;
+    static constexpr size_t MIN_RIGHT_SPEECH = 8;
+    static constexpr size_t MIN_TURN_FRAMES = 50;  // 500ms between changes
+    static constexpr size_t HISTORY = LEFT_FRAMES + RIGHT_FRAMES;
+    static constexpr float THRESHOLD = 16.0f;
+    static constexpr float VARIANCE_FLOOR = 0.01f;
+    static constexpr float PITCH_VARIANCE_FLOOR = 0.005f;  // octaves squared
+    static constexpr float PITCH_WEIGHT = 4.0f;
+    static constexpr size_t MIN_VOICED = 5;        // per side, or pitch is left out
+
+    struct Band {
+        size_t first;  // FFT bins [first, last)
+        size_t last;
+    };
+
+    float speechPower_;
+
+    // Samples not yet consumed by a frame; a frame starts at pending_[0]
+    std::vector<int16_t> pending_;
+    uint64_t samples_ = 0;    // everything pushed or skipped
+    uint64_t frameBase_ = 0;  // sample where frame 0 starts
+    uint64_t frames_ = 0;     // frames analysed since the last skip
+
+    // Fixed tables
+    std::vector<float> window_;
+    std::vector<float> windowLag_;  // the window's own autocorrelation, to undo its taper
+    std::vector<uint16_t> bitReverse_;
+    std::vector<float> twiddleRe_;  // stage with half-size h at [h, 2h)
+    std::vector<float> twiddleIm_;
+    std::vector<Band> bands_;
+
+    // Per-frame scratch
+    std::vector<float> re_;
+    std::vector<float> im_;
+    std::vector<float> power_;
+
+    // Ring of the last HISTORY frames' features, indexed by frame % HISTORY
+    std::vector<float> features_;
+    std::vector<uint8_t> speech_;
+    std::vector<float> pitch_;  // log2 F0, or 0 when unvoiced
+
+    // Candidate search
+    uint64_t segmentStart_ = 0;     // first frame after the last change
+    float lastDistance_ = 0.0f;
+    uint64_t lastCandidate_ = 0;
+    bool lastValid_ = false;
+
+    void analyse(const int16_t* frame);
+    void transform();
+    float pitch();
+    bool distanceAt(uint64_t candidate, float& distance);
+};
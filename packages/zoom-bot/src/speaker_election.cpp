@@ -0,0 +1,184 @@
+#include "speaker_election.h"
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+float rowMax(const float* row, size_t n) {
+    size_t i = 0;
+    float best = 0.0f;
+#if defined(__SSE2__)
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) acc = _mm_max_ps(acc, _mm_loadu_ps(row + i));
+    acc = _mm_max_ps(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_max_ps(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    best = _mm_cvtss_f32(acc);
+#endif
+    for (; i < n; i++) best = std::max(best, row[i]);
+    return best;
+}
+
+// mean[i] = energy[i] / max(samples[i], 1)
+void rowMean(const float* energy, const float* samples, float* mean, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= n; i += 4) {
+        __m128 count = _mm_max_ps(_mm_loadu_ps(samples + i), one);
+        _mm_storeu_ps(mean + i, _mm_div_ps(_mm_loadu_ps(energy + i), count));
+    }
+#endif
+    for (; i < n; i++) mean[i] = energy[i] / std::max(samples[i], 1.0f);
+}
+
+// speaking[i] += mean[i] >= threshold; wins[i] += mean[i] == best
+void rowVote(const float* mean, float threshold, float best, float* speaking, float* wins, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 thr = _mm_set1_ps(threshold);
+    const __m128 top = _mm_set1_ps(best);
+    for (; i + 4 <= n; i += 4) {
+        __m128 m = _mm_loadu_ps(mean + i);
+        __m128 s = _mm_and_ps(_mm_cmpge_ps(m, thr), one);
+        __m128 w = _mm_and_ps(_mm_cmpeq_ps(m, top), one);
+        _mm_storeu_ps(speaking + i, _mm_add_ps(_mm_loadu_ps(speaking + i), s));
+        _mm_storeu_ps(wins + i, _mm_add_ps(_mm_loadu_ps(wins + i), w));
+    }
+#endif
+    for (; i < n; i++) {
+        if (mean[i] >= threshold) speaking[i] += 1.0f;
+        if (mean[i] == best) wins[i] += 1.0f;
+    }
+}
+
+} // namespace
+
+SpeakerElection::SpeakerElection(double speechRms)
+    : speechPower_(static_cast<float>(speechRms * speechRms)) {}
+
+float SpeakerElection::energy(const int16_t* samples, size_t count) {
+    float sumSquares = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        float s = samples[i];
+        sumSquares += s * s;
+    }
+    return sumSquares;
+}
+
+void SpeakerElection::addEnergy(uint32_t userId, float sumSquares, size_t count, uint64_t nowMs) {
+    if (count == 0) return;
+
+    size_t slot = slotFor(userId);
+    uint64_t bin = nowMs / BIN_MS;
+    if (bin + WINDOW_BINS <= slots_[slot].lastBin) return;  // its cell now holds a newer bin
+    advance(slot, bin);
+    size_t cell = (bin % WINDOW_BINS) * stride_ + slot;
+    energy_[cell] += sumSquares;
+    samples_[cell] += static_cast<float>(count);
+}
+
+std::vector<SpeakerElection::Candidate> SpeakerElection::elect(uint64_t nowMs) {
+    std::vector<Candidate> result;
+    uint64_t current = nowMs / BIN_MS;
+
+    // Bring every stream up to now; streams silent for a whole window
+    // (muted, or gone) give up their column
+    for (size_t s = 0; s < slots_.size(); s++) {
+        if (!slots_[s].used) continue;
+        if (slots_[s].lastBin + WINDOW_BINS <= current) {
+            release(s);
+        } else {
+            advance(s, current);
+        }
+    }
+    if (slotOf_.empty()) return result;
+
+    std::fill(speaking_.begin(), speaking_.end(), 0.0f);
+    std::fill(wins_.begin(), wins_.end(), 0.0f);
+
+    // Completed bins only; the current one is still filling
+    size_t speechBins = 0;
+    for (uint64_t bin = current - (WINDOW_BINS - 1); bin < current; bin++) {
+        size_t row = (bin % WINDOW_BINS) * stride_;
+        rowMean(&energy_[row], &samples_[row], mean_.data(), stride_);
+        float best = rowMax(mean_.data(), stride_);
+        if (best < speechPower_) continue;
+
+        speechBins++;
+        float threshold = std::max(best * BLEED_RATIO, speechPower_);
+        rowVote(mean_.data(), threshold, best, speaking_.data(), wins_.data(), stride_);
+    }
+    if (speechBins == 0) return result;
+
+    for (size_t s = 0; s < slots_.size(); s++) {
+        if (!slots_[s].used) continue;
+        double confidence = speaking_[s] / speechBins;
+        double dominance = wins_[s] / speechBins;
+        if (confidence < MIN_CONFIDENCE || dominance < MIN_DOMINANCE) continue;
+        result.push_back({slots_[s].userId, confidence, dominance});
+    }
+    std::sort(result.begin(), result.end(), [](const Candidate& a, const Candidate& b) {
+        return a.dominance != b.dominance ? a.dominance > b.dominance : a.confidence > b.confidence;
+    });
+    return result;
+}
+
+size_t SpeakerElection::slotFor(uint32_t userId) {
+    auto it = slotOf_.find(userId);
+    if (it != slotOf_.end()) return it->second;
+
+    if (freeSlots_.empty()) grow();
+    size_t slot = freeSlots_.back();
+    freeSlots_.pop_back();
+    slots_[slot] = {userId, 0, true};
+    slotOf_[userId] = slot;
+    return slot;
+}
+
+void SpeakerElection::grow() {
+    // Columns come in groups of 8 so rows stay a multiple of the vector width
+    size_t newStride = std::max<size_t>(8, stride_ * 2);
+    std::vector<float> energy(WINDOW_BINS * newStride, 0.0f);
+    std::vector<float> samples(WINDOW_BINS * newStride, 0.0f);
+    for (size_t row = 0; row < WINDOW_BINS; row++) {
+        std::copy_n(&energy_[row * stride_], stride_, &energy[row * newStride]);
+        std::copy_n(&samples_[row * stride_], stride_, &samples[row * newStride]);
+    }
+    energy_.swap(energy);
+    samples_.swap(samples);
+
+    slots_.resize(newStride);
+    for (size_t s = newStride; s-- > stride_;) freeSlots_.push_back(s);
+    stride_ = newStride;
+    mean_.assign(stride_, 0.0f);
+    speaking_.assign(stride_, 0.0f);
+    wins_.assign(stride_, 0.0f);
+}
+
+void SpeakerElection::advance(size_t slot, uint64_t bin) {
+    // Clear the cells this stream skipped so stale energy from a previous
+    // lap of the ring is not read as current
+    uint64_t last = slots_[slot].lastBin;
+    if (bin <= last) return;
+    uint64_t first = std::max(last + 1, bin >= WINDOW_BINS ? bin - WINDOW_BINS + 1 : 0);
+    for (uint64_t b = first; b <= bin; b++) {
+        size_t cell = (b % WINDOW_BINS) * stride_ + slot;
+        energy_[cell] = 0.0f;
+        samples_[cell] = 0.0f;
+    }
+    slots_[slot].lastBin = bin;
+}
+
+void SpeakerElection::release(size_t slot) {
+    for (size_t row = 0; row < WINDOW_BINS; row++) {
+        energy_[row * stride_ + slot] = 0.0f;
+        samples_[row * stride_ + slot] = 0.0f;
+    }
+    slotOf_.erase(slots_[slot].userId);
+    slots_[slot].used = false;
+    freeSlots_.push_back(slot);
+}
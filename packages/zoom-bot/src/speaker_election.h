@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Picks the participants who are actually talking from the one-way streams.
+// A loud talker is picked up by other open mics, so a per-stream threshold
+// reports several "speakers" at once. Instead, energies are accumulated in
+// time-aligned 20ms bins over a 500ms window and compared across streams
+// bin by bin: a stream counts as speaking in a bin only if it is within
+// BLEED_RATIO of the loudest stream, otherwise it is treated as bleed. Two
+// people talking over each other each come out on top in some bins, as
+// their syllables alternate; a mic that only picks them up never does, so
+// electing a stream also takes a minimum share of bins won.
+//
+// Energies are stored bin-major (one row per bin, one column per stream)
+// so each cross-stream comparison is a single vectorized pass over a row;
+// an election costs O(window bins x streams). Not thread-safe: feed and
+// elect from the SDK audio thread (energy() may run anywhere).
+class SpeakerElection {
+public:
+    struct Candidate {
+        uint32_t userId;
+        double confidence;  // share of speech bins in which this user was speaking
+        double dominance;   // share of speech bins in which this user was loudest
+    };
+
+    // speechRms: minimum RMS level (16-bit scale) of the loudest stream for
+    // a bin to count as containing speech at all
+    explicit SpeakerElection(double speechRms);
+
+    // A frame is fed in two halves, so the pass over its samples can run on
+    // another thread: its sum of squares, then adding that in. A frame
+    // older than the window is ignored.
+    static float energy(const int16_t* samples, size_t count);
+    void addEnergy(uint32_t userId, float sumSquares, size_t count, uint64_t nowMs);
+
+    // Speakers over the last window, most dominant first
+    std::vector<Candidate> elect(uint64_t nowMs);
+
+    size_t streams() const { return slotOf_.size(); }
+
+private:
+    static constexpr uint64_t BIN_MS = 20;
+    static constexpr size_t WINDOW_BINS = 25;      // 500ms
+    static constexpr float BLEED_RATIO = 0.1f;     // 10dB below the loudest stream
+    static constexpr double MIN_CONFIDENCE = 0.2;
+    static constexpr double MIN_DOMINANCE = 0.1;
+
+    struct Slot {
+        uint32_t userId = 0;
+        uint64_t lastBin = 0;  // newest bin written or cleared
+        bool used = false;
+    };
+
+    float speechPower_;
+    std::unordered_map<uint32_t, size_t> slotOf_;
+    std::vector<Slot> slots_;
+    std::vector<size_t> freeSlots_;
+
+    // WINDOW_BINS rows of stride_ columns, indexed by bin % WINDOW_BINS
+    size_t stride_ = 0;
+    std::vector<float> energy_;   // sum of squares
+    std::vector<float> samples_;  // samples summed into energy_
+
+    // Per-election scratch, one entry per column
+    std::vector<float> mean_;
+    std::vector<float> speaking_;
+    std::vector<float> wins_;
+
+    size_t slotFor(uint32_t userId);
+    void grow();
+    void advance(size_t slot, uint64_t bin);
+    void release(size_t slot);
+};
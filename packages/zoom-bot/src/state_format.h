@@ -0,0 +1,66 @@
+#pragma once
+
+// Layout of the warm-restart state file (ZOOM_BOT_STATE_FILE), written by
+// StateSnapshot through a shared mapping so every update is in the page
+// cache as soon as it is made and survives the process crashing.
+//
+// A fixed header is followed by a fixed table of participant slots. Each
+// slot, and the header's meeting totals, carry a version that is odd while
+// a write is in progress; a reader after a crash skips anything left odd.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace state {
+
+constexpr char MAGIC[8] = {'Z', 'B', 'S', 'T', 'A', 'T', 'E', '1'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t SLOT_COUNT = 1024;  // Zoom meetings hold up to 1000 participants
+constexpr size_t NAME_BYTES = 128;     // longer names are truncated
+constexpr unsigned int SAMPLE_RATE = 16000;  // of streamPosition
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t slotCount;
+    uint64_t meetingNumber;
+    uint32_t restarts;                     // warm restarts of this meeting so far
+    uint32_t reserved;
+
+    // Updated from the audio thread on every mixed callback
+    alignas(64) std::atomic<uint64_t> streamPosition;  // samples emitted, 16kHz
+    std::atomic<uint64_t> savedMs;                     // wall clock of the last update
+
+    // Meeting-wide talk clocks (see ParticipantTracker)
+    alignas(64) std::atomic<uint32_t> totalsVersion;
+    uint32_t overlaps;
+    uint64_t speechMs;
+    uint64_t overlapMs;
+    uint64_t clockMs;  // wall clock the totals were advanced to
+};
+
+struct Slot {
+    std::atomic<uint32_t> version;  // odd while being written
+    uint32_t used;
+    uint32_t userId;
+    uint32_t nameLength;
+    char name[NAME_BYTES];
+
+    // Speech run in progress at the last update, and talk stats so far
+    uint64_t runStartMs;
+    uint64_t lastActiveMs;
+    uint32_t active;
+    uint32_t turns;
+    uint32_t interruptions;
+    uint32_t reserved;
+    uint64_t talkMs;
+    uint64_t overlapMs;
+};
+
+constexpr size_t HEADER_AREA = 256;  // slots start here
+static_assert(sizeof(Header) <= HEADER_AREA, "Header must fit in the header area");
+
+constexpr size_t FILE_SIZE = HEADER_AREA + SLOT_COUNT * sizeof(Slot);
+
+}  // namespace state
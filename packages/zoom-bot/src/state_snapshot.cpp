@@ -0,0 +1,207 @@
+#include "state_snapshot.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+uint64_t StateSnapshot::wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+StateSnapshot::~StateSnapshot() {
+    close();
+}
+
+bool StateSnapshot::open(const std::string& path, uint64_t meetingNumber) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ < 0) {
+        std::cerr << "[State] Cannot open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // A file of the wrong size is from another build; start it again zeroed
+    struct stat st{};
+    bool sized = fstat(fd_, &st) == 0 && static_cast<size_t>(st.st_size) == state::FILE_SIZE;
+    void* mapping = MAP_FAILED;
+    if (sized || (ftruncate(fd_, 0) == 0 && ftruncate(fd_, state::FILE_SIZE) == 0)) {
+        mapping = mmap(nullptr, state::FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    }
+    if (mapping == MAP_FAILED) {
+        std::cerr << "[State] Cannot map " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    header_ = static_cast<state::Header*>(mapping);
+    slots_ = reinterpret_cast<state::Slot*>(static_cast<char*>(mapping) + state::HEADER_AREA);
+
+    uint64_t now = wallClockMs();
+    uint64_t savedMs = header_->savedMs.load(std::memory_order_relaxed);
+    bool resumable = sized &&
+        std::memcmp(header_->magic, state::MAGIC, sizeof(state::MAGIC)) == 0 &&
+        header_->version == state::VERSION && header_->slotCount == state::SLOT_COUNT &&
+        header_->meetingNumber == meetingNumber &&
+        savedMs <= now && now - savedMs <= RESUME_WINDOW_MS;
+
+    if (resumable) {
+        restore();
+        header_->restarts++;
+        std::cout << "[State] Resuming from " << path << ": " << restored_.size()
+                  << " participants, stream at " << restoredPosition_ / static_cast<double>(state::SAMPLE_RATE)
+                  << "s, down " << downtimeMs_ << "ms (restart #" << header_->restarts << ")" << std::endl;
+    } else {
+        reset(meetingNumber);
+        std::cout << "[State] Keeping warm-restart state in " << path << std::endl;
+    }
+    return true;
+}
+
+void StateSnapshot::close() {
+    if (!header_) return;
+    msync(header_, state::FILE_SIZE, MS_SYNC);
+    munmap(header_, state::FILE_SIZE);
+    ::close(fd_);
+    header_ = nullptr;
+    slots_ = nullptr;
+    fd_ = -1;
+    slotOf_.clear();
+    freeSlots_.clear();
+}
+
+void StateSnapshot::reset(uint64_t meetingNumber) {
+    std::memset(static_cast<void*>(header_), 0, state::FILE_SIZE);
+    new (header_) state::Header();
+    std::memcpy(header_->magic, state::MAGIC, sizeof(state::MAGIC));
+    header_->version = state::VERSION;
+    header_->slotCount = state::SLOT_COUNT;
+    header_->meetingNumber = meetingNumber;
+    header_->savedMs.store(wallClockMs(), std::memory_order_relaxed);
+
+    // Lowest slots are handed out first
+    for (uint32_t i = state::SLOT_COUNT; i > 0; i--) freeSlots_.push_back(i - 1);
+}
+
+void StateSnapshot::restore() {
+    resumed_ = true;
+    restoredPosition_ = header_->streamPosition.load(std::memory_order_relaxed);
+    downtimeMs_ = wallClockMs() - header_->savedMs.load(std::memory_order_relaxed);
+
+    if (header_->totalsVersion.load(std::memory_order_acquire) & 1) {
+        // The previous process died halfway through the totals; start them
+        // over with an even version, or every later write would leave it odd
+        header_->speechMs = header_->overlapMs = header_->clockMs = 0;
+        header_->overlaps = 0;
+        header_->totalsVersion.store(0, std::memory_order_release);
+    } else {
+        restoredTotals_ = {header_->speechMs, header_->overlapMs, header_->overlaps, header_->clockMs};
+    }
+
+    for (uint32_t i = state::SLOT_COUNT; i > 0; i--) {
+        state::Slot& slot = slots_[i - 1];
+        uint32_t version = slot.version.load(std::memory_order_acquire);
+        if (version & 1) {
+            // The previous process died halfway through this slot
+            std::memset(static_cast<void*>(&slot), 0, sizeof(slot));
+        }
+        if (!slot.used) {
+            freeSlots_.push_back(i - 1);
+            continue;
+        }
+
+        Participant p;
+        p.userId = slot.userId;
+        p.name.assign(slot.name, std::min<size_t>(slot.nameLength, state::NAME_BYTES));
+        p.runStartMs = slot.runStartMs;
+        p.lastActiveMs = slot.lastActiveMs;
+        p.active = slot.active != 0;
+        p.talkMs = slot.talkMs;
+        p.turns = slot.turns;
+        p.interruptions = slot.interruptions;
+        p.overlapMs = slot.overlapMs;
+        restored_.push_back(std::move(p));
+        slotOf_[slot.userId] = i - 1;
+    }
+}
+
+void StateSnapshot::putParticipant(const Participant& participant) {
+    if (!header_) return;
+
+    uint32_t index;
+    auto it = slotOf_.find(participant.userId);
+    if (it != slotOf_.end()) {
+        index = it->second;
+    } else if (!freeSlots_.empty()) {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+        slotOf_[participant.userId] = index;
+    } else {
+        if (!fullLogged_) {
+            std::cerr << "[State] All " << state::SLOT_COUNT << " slots in use, new participants are not saved"
+                      << std::endl;
+            fullLogged_ = true;
+        }
+        return;
+    }
+
+    state::Slot& slot = slots_[index];
+    uint32_t version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.used = 1;
+    slot.userId = participant.userId;
+    slot.nameLength = static_cast<uint32_t>(std::min(participant.name.size(), state::NAME_BYTES));
+    std::memcpy(slot.name, participant.name.data(), slot.nameLength);
+    slot.runStartMs = participant.runStartMs;
+    slot.lastActiveMs = participant.lastActiveMs;
+    slot.active = participant.active ? 1 : 0;
+    slot.turns = participant.turns;
+    slot.interruptions = participant.interruptions;
+    slot.talkMs = participant.talkMs;
+    slot.overlapMs = participant.overlapMs;
+
+    slot.version.store(version + 2, std::memory_order_release);
+    header_->savedMs.store(wallClockMs(), std::memory_order_relaxed);
+}
+
+void StateSnapshot::removeParticipant(uint32_t userId) {
+    if (!header_) return;
+    auto it = slotOf_.find(userId);
+    if (it == slotOf_.end()) return;
+
+    state::Slot& slot = slots_[it->second];
+    uint32_t version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.used = 0;
+    slot.version.store(version + 2, std::memory_order_release);
+
+    freeSlots_.push_back(it->second);
+    slotOf_.erase(it);
+    header_->savedMs.store(wallClockMs(), std::memory_order_relaxed);
+}
+
+void StateSnapshot::putTotals(const Totals& totals) {
+    if (!header_) return;
+    uint32_t version = header_->totalsVersion.load(std::memory_order_relaxed);
+    header_->totalsVersion.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->speechMs = totals.speechMs;
+    header_->overlapMs = totals.overlapMs;
+    header_->overlaps = totals.overlaps;
+    header_->clockMs = totals.clockMs;
+    header_->totalsVersion.store(version + 2, std::memory_order_release);
+}
+
+void StateSnapshot::setStreamPosition(uint64_t samples, uint64_t nowMs) {
+    if (!header_) return;
+    header_->streamPosition.store(samples, std::memory_order_relaxed);
+    header_->savedMs.store(nowMs, std::memory_order_relaxed);
+}
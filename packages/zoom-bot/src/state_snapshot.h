@@ -0,0 +1,85 @@
+#pragma once
+
+#include "state_format.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Small memory-mapped copy of the tracker's roster and talk stats and of
+// the outgoing stream position (layout in state_format.h), kept so a bot
+// restarted into the same meeting can carry on where it stopped: names are
+// known before the SDK has re-enumerated the roster, and stream positions
+// continue instead of starting again at zero.
+//
+// Updates are written in place, one slot per participant, as they happen.
+// Participant and totals updates come from ParticipantTracker under its
+// lock; the stream position is a lone atomic store from the audio thread.
+class StateSnapshot {
+public:
+    struct Participant {
+        uint32_t userId = 0;
+        std::string name;
+        uint64_t runStartMs = 0;
+        uint64_t lastActiveMs = 0;
+        bool active = false;
+        uint64_t talkMs = 0;
+        uint32_t turns = 0;
+        uint32_t interruptions = 0;
+        uint64_t overlapMs = 0;
+    };
+
+    struct Totals {
+        uint64_t speechMs = 0;
+        uint64_t overlapMs = 0;
+        uint32_t overlaps = 0;
+        uint64_t clockMs = 0;
+    };
+
+    ~StateSnapshot();
+
+    // Maps the state file, creating it if needed. Its contents are restored
+    // if they belong to this meeting and were updated within the last
+    // RESUME_WINDOW_MS; otherwise the file starts afresh.
+    bool open(const std::string& path, uint64_t meetingNumber);
+    void close();
+
+    bool enabled() const { return header_ != nullptr; }
+
+    // What open() restored (empty unless resumed())
+    bool resumed() const { return resumed_; }
+    const std::vector<Participant>& restoredParticipants() const { return restored_; }
+    const Totals& restoredTotals() const { return restoredTotals_; }
+    uint64_t restoredPosition() const { return restoredPosition_; }
+    uint64_t downtimeMs() const { return downtimeMs_; }
+
+    // Called with the tracker's lock held
+    void putParticipant(const Participant& participant);
+    void removeParticipant(uint32_t userId);
+    void putTotals(const Totals& totals);
+
+    // Audio thread: samples emitted so far, and the wall clock now
+    void setStreamPosition(uint64_t samples, uint64_t nowMs);
+
+private:
+    int fd_ = -1;
+    state::Header* header_ = nullptr;
+    state::Slot* slots_ = nullptr;
+    std::unordered_map<uint32_t, uint32_t> slotOf_;  // userId -> slot index
+    std::vector<uint32_t> freeSlots_;
+    bool fullLogged_ = false;
+
+    bool resumed_ = false;
+    std::vector<Participant> restored_;
+    Totals restoredTotals_;
+    uint64_t restoredPosition_ = 0;
+    uint64_t downtimeMs_ = 0;
+
+    void reset(uint64_t meetingNumber);
+    void restore();
+
+    static uint64_t wallClockMs();
+
+    // An older file is another stretch of the meeting, not the same one
+    static constexpr uint64_t RESUME_WINDOW_MS = 10 * 60 * 1000;
+};
@@ -0,0 +1,260 @@
+#include "stream_workers.h"
+#include "speaker_election.h"
+#include "tracer.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+StreamWorkers::StreamWorkers(unsigned int workers, std::pmr::memory_resource* memory)
+    : memory_(memory), mailboxes_(memory) {
+    for (unsigned int i = 0; i < workers; i++) {
+        auto worker = std::make_unique<Worker>();
+        worker->energies.slots.resize(RING_SLOTS);
+        workers_.push_back(std::move(worker));
+    }
+    for (size_t i = 0; i < workers_.size(); i++) {
+        workers_[i]->thread = std::thread([this, i] { run(i); });
+    }
+    if (!workers_.empty()) {
+        std::cout << "[Audio] Processing participant streams on " << workers_.size() << " workers"
+                  << std::endl;
+    }
+}
+
+StreamWorkers::~StreamWorkers() {
+    stopping_ = true;
+    for (auto& worker : workers_) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->wakeup.notify_one();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+StreamWorkers::Mailbox& StreamWorkers::mailboxFor(uint32_t userId) {
+    auto [it, inserted] = mailboxes_.try_emplace(userId, memory_);
+    Mailbox& mailbox = it->second;
+    if (inserted) {
+        mailbox.userId = userId;
+        mailbox.home = workers_.empty() ? 0 : nextHome_++ % workers_.size();
+    }
+    return mailbox;
+}
+
+void StreamWorkers::dispatch(uint32_t userId, const int16_t* samples, size_t count, unsigned int sampleRate,
+                             unsigned int channels, uint64_t nowMs, bool reduced) {
+    if (count == 0) return;
+    Mailbox& mailbox = mailboxFor(userId);
+    Frame frame{0, static_cast<uint32_t>(count), sampleRate, channels, reduced, nowMs,
+                AudioStats::Clock::now()};
+
+    if (workers_.empty()) {
+        float sumSquares = process(mailbox, samples, frame);
+        inline_.push_back({userId, frame.count, sumSquares, nowMs});
+        inlineFrames_++;
+        return;
+    }
+
+    bool wasIdle;
+    {
+        std::lock_guard<std::mutex> lock(mailbox.queueMutex);
+        if (mailbox.frames.size() >= MAX_QUEUED_FRAMES) {
+            dispatchDropped_++;
+            return;
+        }
+        frame.offset = mailbox.samples.size();
+        mailbox.samples.insert(mailbox.samples.end(), samples, samples + count);
+        mailbox.frames.push_back(frame);
+        wasIdle = !mailbox.scheduled;
+        mailbox.scheduled = true;
+    }
+    if (wasIdle) schedule(mailbox);
+}
+
+void StreamWorkers::schedule(Mailbox& mailbox) {
+    Worker& home = *workers_[mailbox.home];
+    bool homeAsleep;
+    size_t backlog;
+    {
+        std::lock_guard<std::mutex> lock(home.mutex);
+        home.queue.push_back(&mailbox);
+        homeAsleep = home.sleeping;
+        backlog = home.queue.size();
+    }
+    if (homeAsleep) {
+        home.wakeup.notify_one();
+        return;
+    }
+    if (backlog < STEAL_BACKLOG) return;
+
+    // Home is falling behind: wake one sleeping worker to steal. If none
+    // is asleep, whoever finishes first gets to it.
+    for (auto& worker : workers_) {
+        if (worker.get() == &home || !worker->idle.load(std::memory_order_relaxed)) continue;
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            if (!worker->sleeping) continue;
+            worker->poked = true;
+        }
+        worker->wakeup.notify_one();
+        return;
+    }
+}
+
+void StreamWorkers::run(size_t index) {
+    std::string name = "stream-worker-" + std::to_string(index);
+    Tracer::nameThread(name.c_str());
+
+    // Swapped with each mailbox's buffers, so capacity circulates instead
+    // of being allocated per frame
+    std::pmr::vector<int16_t> samples(memory_);
+    std::pmr::vector<Frame> frames(memory_);
+    while (Mailbox* mailbox = next(index)) {
+        drainMailbox(index, *mailbox, samples, frames);
+    }
+}
+
+StreamWorkers::Mailbox* StreamWorkers::next(size_t index) {
+    Worker& self = *workers_[index];
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(self.mutex);
+            if (!self.queue.empty()) {
+                Mailbox* mailbox = self.queue.front();
+                self.queue.pop_front();
+                return mailbox;
+            }
+        }
+
+        // Steal the most recently queued mailbox of a worker that has fallen
+        // behind; a short queue is left to its home, whose cache holds its
+        // participants' state
+        for (size_t k = 1; k < workers_.size(); k++) {
+            Worker& victim = *workers_[(index + k) % workers_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.queue.size() < STEAL_BACKLOG) continue;
+            Mailbox* mailbox = victim.queue.back();
+            victim.queue.pop_back();
+            self.steals.fetch_add(1, std::memory_order_relaxed);
+            return mailbox;
+        }
+
+        std::unique_lock<std::mutex> lock(self.mutex);
+        if (stopping_) return nullptr;
+        if (!self.queue.empty()) continue;
+        self.sleeping = true;
+        self.idle.store(true, std::memory_order_relaxed);
+        self.wakeup.wait(lock, [&] { return stopping_ || self.poked || !self.queue.empty(); });
+        self.sleeping = false;
+        self.poked = false;
+        self.idle.store(false, std::memory_order_relaxed);
+        if (stopping_) return nullptr;
+    }
+}
+
+void StreamWorkers::drainMailbox(size_t index, Mailbox& mailbox, std::pmr::vector<int16_t>& samples,
+                                 std::pmr::vector<Frame>& frames) {
+    TRACE_SCOPE("stream_worker");
+    Worker& self = *workers_[index];
+    EnergyRing& ring = self.energies;
+    auto start = std::chrono::steady_clock::now();
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mailbox.queueMutex);
+            if (mailbox.frames.empty()) {
+                // The mailbox may be rescheduled (or forgotten) from here on
+                mailbox.scheduled = false;
+                break;
+            }
+            samples.clear();
+            frames.clear();
+            samples.swap(mailbox.samples);
+            frames.swap(mailbox.frames);
+        }
+
+        for (const Frame& frame : frames) {
+            float sumSquares = process(mailbox, samples.data() + frame.offset, frame);
+            uint64_t head = ring.head.load(std::memory_order_relaxed);
+            if (head - ring.tail.load(std::memory_order_acquire) >= ring.slots.size()) {
+                self.dropped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            ring.slots[head & (ring.slots.size() - 1)] = {mailbox.userId, frame.count, sumSquares, frame.nowMs};
+            ring.head.store(head + 1, std::memory_order_release);
+        }
+        self.frames.fetch_add(frames.size(), std::memory_order_relaxed);
+    }
+
+    self.busyUs.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+}
+
+float StreamWorkers::process(Mailbox& mailbox, const int16_t* samples, const Frame& frame) {
+    if (!frame.reduced) {
+        std::lock_guard<std::mutex> lock(mailbox.statsMutex);
+        mailbox.stats.addFrame(samples, frame.count, frame.sampleRate, frame.channels, frame.arrival);
+    }
+    return SpeakerElection::energy(samples, frame.count);
+}
+
+void StreamWorkers::drain(std::vector<Energy>& out) {
+    out.insert(out.end(), inline_.begin(), inline_.end());
+    inline_.clear();
+
+    for (auto& worker : workers_) {
+        EnergyRing& ring = worker->energies;
+        uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+        uint64_t head = ring.head.load(std::memory_order_acquire);
+        for (; tail < head; tail++) out.push_back(ring.slots[tail & (ring.slots.size() - 1)]);
+        ring.tail.store(tail, std::memory_order_release);
+    }
+}
+
+void StreamWorkers::takeStats(std::vector<std::pair<uint32_t, AudioStats::Summary>>& out) {
+    for (auto it = mailboxes_.begin(); it != mailboxes_.end();) {
+        Mailbox& mailbox = it->second;
+        bool heard;
+        {
+            std::lock_guard<std::mutex> lock(mailbox.statsMutex);
+            heard = mailbox.stats.hasFrames();
+            if (heard) {
+                out.emplace_back(mailbox.userId, mailbox.stats.summarize());
+                mailbox.stats.resetWindow();
+            }
+        }
+        if (heard) {
+            ++it;
+            continue;
+        }
+
+        // Only safe to free once no worker holds or will pick up the mailbox
+        bool scheduled;
+        {
+            std::lock_guard<std::mutex> lock(mailbox.queueMutex);
+            scheduled = mailbox.scheduled;
+        }
+        it = scheduled ? std::next(it) : mailboxes_.erase(it);
+    }
+}
+
+StreamWorkers::Counters StreamWorkers::takeCounters(uint64_t intervalMs) {
+    Counters counters;
+    counters.frames = inlineFrames_;
+    counters.dropped = dispatchDropped_;
+    inlineFrames_ = 0;
+    dispatchDropped_ = 0;
+
+    uint64_t busyUs = 0;
+    for (auto& worker : workers_) {
+        busyUs += worker->busyUs.exchange(0, std::memory_order_relaxed);
+        counters.frames += worker->frames.exchange(0, std::memory_order_relaxed);
+        counters.steals += worker->steals.exchange(0, std::memory_order_relaxed);
+        counters.dropped += worker->dropped.exchange(0, std::memory_order_relaxed);
+    }
+    if (!workers_.empty() && intervalMs > 0) {
+        counters.busyPct = busyUs / (intervalMs * 10.0 * workers_.size());
+    }
+    return counters;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "audio_stats.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Runs the per-participant part of one-way audio processing (quality stats
+// and the frame energies the speaker election is fed) on a small pool of
+// threads, so a webinar with hundreds of open mics does not serialise on
+// the SDK's callback thread.
+//
+// Each participant has a mailbox. The SDK thread copies a frame in and, if
+// the mailbox was idle, queues it on its home worker (assigned round robin
+// when the participant is first heard). A worker drains a mailbox in one
+// go, so one participant's frames are processed in order, by one thread at
+// a time, and normally always by the same thread, which keeps that
+// participant's state in its cache. A worker that runs out of mailboxes
+// steals from the back of another worker's queue once STEAL_BACKLOG
+// mailboxes are waiting there.
+//
+// Energies come back through one single-producer ring per worker, which
+// the SDK thread drains before electing, so no lock is shared by all
+// workers. Per-participant stats sit behind that participant's own lock.
+//
+// With zero workers every frame is processed inline by dispatch().
+class StreamWorkers {
+public:
+    struct Energy {
+        uint32_t userId;
+        uint32_t samples;
+        float sumSquares;
+        uint64_t nowMs;
+    };
+
+    struct Counters {
+        double busyPct = 0.0;   // mean over workers
+        uint64_t frames = 0;
+        uint64_t steals = 0;    // mailboxes run by a worker other than their home
+        uint64_t dropped = 0;   // frames refused by a backed-up mailbox or a full ring
+    };
+
+    // Mailboxes and their frame buffers are allocated from memory (the
+    // participant arena)
+    StreamWorkers(unsigned int workers, std::pmr::memory_resource* memory);
+    ~StreamWorkers();
+
+    // dispatch() and drain() are called from the SDK audio thread; takeStats()
+    // and takeCounters() from the main loop, which the caller keeps from
+    // running alongside dispatch().
+
+    // Queues one frame of interleaved 16-bit PCM; reduced skips the quality
+    // stats and keeps only the energy
+    void dispatch(uint32_t userId, const int16_t* samples, size_t count, unsigned int sampleRate,
+                  unsigned int channels, uint64_t nowMs, bool reduced);
+
+    // Appends the energies computed since the last call
+    void drain(std::vector<Energy>& out);
+
+    // Summaries for participants heard from since the last call, each
+    // starting a new window; participants silent for a whole window are
+    // forgotten so the table does not grow with everyone who ever joined
+    void takeStats(std::vector<std::pair<uint32_t, AudioStats::Summary>>& out);
+
+    Counters takeCounters(uint64_t intervalMs);
+
+    unsigned int size() const { return static_cast<unsigned int>(workers_.size()); }
+
+private:
+    struct Frame {
+        size_t offset;  // into Mailbox::samples
+        uint32_t count;
+        uint32_t sampleRate;
+        uint32_t channels;
+        bool reduced;
+        uint64_t nowMs;
+        AudioStats::Clock::time_point arrival;
+    };
+
+    struct Mailbox {
+        explicit Mailbox(std::pmr::memory_resource* memory) : samples(memory), frames(memory) {}
+
+        uint32_t userId = 0;
+        size_t home = 0;
+
+        // Hand-off between the SDK thread and the worker draining it. The
+        // buffers are swapped with the worker's, which share their arena.
+        std::mutex queueMutex;
+        std::pmr::vector<int16_t> samples;
+        std::pmr::vector<Frame> frames;
+        bool scheduled = false;  // queued on a worker or being drained
+
+        // Worker while processing, main loop while summarising
+        std::mutex statsMutex;
+        AudioStats stats;
+    };
+
+    // Single producer (the worker), single consumer (the SDK thread)
+    struct EnergyRing {
+        std::vector<Energy> slots;
+        std::atomic<uint64_t> head{0};
+        std::atomic<uint64_t> tail{0};
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;  // guards queue, sleeping and poked
+        std::condition_variable wakeup;
+        std::deque<Mailbox*> queue;
+        bool sleeping = false;
+        bool poked = false;  // woken to steal
+        std::atomic<bool> idle{false};  // sleeping, readable without the lock
+
+        EnergyRing energies;
+        std::atomic<uint64_t> busyUs{0};
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    std::pmr::memory_resource* memory_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> stopping_{false};
+
+    // SDK thread, or the main loop with dispatch() held off
+    std::pmr::unordered_map<uint32_t, Mailbox> mailboxes_;
+    size_t nextHome_ = 0;
+    uint64_t dispatchDropped_ = 0;
+    std::vector<Energy> inline_;  // energies from inline processing
+    uint64_t inlineFrames_ = 0;
+
+    Mailbox& mailboxFor(uint32_t userId);
+    void schedule(Mailbox& mailbox);
+    void run(size_t index);
+    Mailbox* next(size_t index);
+    void drainMailbox(size_t index, Mailbox& mailbox, std::pmr::vector<int16_t>& samples,
+                      std::pmr::vector<Frame>& frames);
+    static float process(Mailbox& mailbox, const int16_t* samples, const Frame& frame);
+
+    static constexpr size_t MAX_QUEUED_FRAMES = 50;  // 500ms of 10ms frames per participant
+    static constexpr size_t RING_SLOTS = 4096;       // power of two
+    static constexpr size_t STEAL_BACKLOG = 4;       // queued mailboxes before others help out
+};
@@ -0,0 +1,95 @@
+#include "thread_profile.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <sys/mman.h>
+
+ThreadProfile::ThreadProfile() : policy(SCHED_OTHER) {}
+
+ThreadProfile ThreadProfile::parse(const std::string& cpuList, const std::string& policy, int priority) {
+    ThreadProfile profile;
+
+    std::stringstream ss(cpuList);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        size_t dash = item.find('-');
+        try {
+            int first = std::stoi(item.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) profile.cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            std::cerr << "[Threads] Ignoring invalid CPU list entry: " << item << std::endl;
+        }
+    }
+
+    if (policy == "fifo") {
+        profile.policy = SCHED_FIFO;
+    } else if (policy == "rr") {
+        profile.policy = SCHED_RR;
+    } else if (!policy.empty() && policy != "none") {
+        std::cerr << "[Threads] Unknown real-time policy: " << policy << std::endl;
+    }
+
+    if (profile.policy != SCHED_OTHER) {
+        int lo = sched_get_priority_min(profile.policy);
+        int hi = sched_get_priority_max(profile.policy);
+        profile.priority = priority < lo ? lo : (priority > hi ? hi : priority);
+    }
+    return profile;
+}
+
+bool ThreadProfile::empty() const {
+    return cpus.empty() && policy == SCHED_OTHER;
+}
+
+void ThreadProfile::applyToCurrentThread(const char* role) const {
+    if (empty()) return;
+    pthread_t self = pthread_self();
+
+    if (!cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        int rc = pthread_setaffinity_np(self, sizeof(set), &set);
+        if (rc != 0) {
+            std::cerr << "[Threads] Cannot pin " << role << " thread: " << std::strerror(rc) << std::endl;
+        }
+    }
+
+    if (policy != SCHED_OTHER) {
+        sched_param param{};
+        param.sched_priority = priority;
+        int rc = pthread_setschedparam(self, policy, &param);
+        if (rc != 0) {
+            // Keep the default policy; affinity alone still helps
+            std::cerr << "[Threads] Real-time scheduling not permitted for " << role
+                      << " thread (" << std::strerror(rc) << "), using default policy" << std::endl;
+            return;
+        }
+    }
+
+    std::cout << "[Threads] " << role << " thread: "
+              << (policy == SCHED_FIFO ? "SCHED_FIFO" : policy == SCHED_RR ? "SCHED_RR" : "SCHED_OTHER");
+    if (policy != SCHED_OTHER) std::cout << " priority " << priority;
+    if (!cpus.empty()) {
+        std::cout << ", CPUs";
+        for (int cpu : cpus) std::cout << " " << cpu;
+    }
+    std::cout << std::endl;
+}
+
+bool lockMemory(const void* addr, size_t len, const char* what) {
+    if (len == 0) return true;
+    if (mlock(addr, len) != 0) {
+        std::cerr << "[Threads] Cannot lock " << what << " in memory (" << std::strerror(errno)
+                  << "), check the memlock limit" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Scheduling profile for a latency-sensitive thread: CPU affinity and an
+// optional real-time policy. Applying it never fails hard; anything the
+// process is not permitted to do (typically SCHED_FIFO/RR without
+// CAP_SYS_NICE or an RLIMIT_RTPRIO) is logged once and skipped.
+struct ThreadProfile {
+    std::vector<int> cpus;  // empty: leave affinity alone
+    int policy;             // SCHED_OTHER, SCHED_FIFO or SCHED_RR
+    int priority = 0;       // 1-99 for the real-time policies
+
+    ThreadProfile();
+
+    // cpuList: "2,3" or "4-7" (empty for none); policy: "", "fifo" or "rr"
+    static ThreadProfile parse(const std::string& cpuList, const std::string& policy, int priority);
+
+    bool empty() const;
+
+    // role names the thread in log messages
+    void applyToCurrentThread(const char* role) const;
+};
+
+// Pin a buffer's pages in RAM so the audio path never takes a major fault.
+// Returns false (after logging) when the memlock limit does not allow it.
+bool lockMemory(const void* addr, size_t len, const char* what);
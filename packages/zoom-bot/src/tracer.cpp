@@ -0,0 +1,152 @@
+#include "tracer.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+struct Event {
+    const char* name;
+    uint64_t startNs;
+    uint64_t durNs;     // spans
+    double value;       // counters
+    bool isCounter;
+};
+
+// One per recording thread. Only the owning thread writes; head is the
+// number of events ever written, so slot i % size holds event i.
+struct ThreadRing {
+    explicit ThreadRing(size_t size) : events(size) {}
+
+    std::vector<Event> events;
+    std::atomic<uint64_t> head{0};
+    long tid = 0;
+    std::string name;
+    std::mutex nameMutex;
+};
+
+constexpr size_t RING_EVENTS = 32768;
+
+// Rings outlive their threads so a dump still shows threads that exited.
+// Never destroyed: SDK threads may still record while statics are torn down.
+std::mutex& g_registryMutex = *new std::mutex;
+std::vector<std::unique_ptr<ThreadRing>>& g_rings = *new std::vector<std::unique_ptr<ThreadRing>>;
+
+thread_local ThreadRing* t_ring = nullptr;
+
+ThreadRing* currentRing() {
+    if (t_ring) return t_ring;
+
+    auto ring = std::make_unique<ThreadRing>(RING_EVENTS);
+    ring->tid = syscall(SYS_gettid);
+    char name[16] = {};
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    ring->name = name;
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    t_ring = ring.get();
+    g_rings.push_back(std::move(ring));
+    return t_ring;
+}
+
+void append(const Event& event) {
+    ThreadRing* ring = currentRing();
+    uint64_t i = ring->head.load(std::memory_order_relaxed);
+    ring->events[i % ring->events.size()] = event;
+    ring->head.store(i + 1, std::memory_order_release);
+}
+
+} // namespace
+
+void Tracer::enable() {
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::nameThread(const char* name) {
+    if (!enabled()) return;
+    ThreadRing* ring = currentRing();
+    std::lock_guard<std::mutex> lock(ring->nameMutex);
+    ring->name = name;
+}
+
+void Tracer::complete(const char* name, uint64_t startNs, uint64_t endNs) {
+    append({name, startNs, endNs - startNs, 0.0, false});
+}
+
+void Tracer::counter(const char* name, double value) {
+    append({name, nowNs(), 0, value, true});
+}
+
+uint64_t Tracer::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool Tracer::dump(const std::string& path) {
+    if (!enabled()) return false;
+    auto start = std::chrono::steady_clock::now();
+
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out) {
+        std::cerr << "[Trace] Cannot write " << path << std::endl;
+        return false;
+    }
+
+    long pid = getpid();
+    uint64_t written = 0;
+    std::vector<Event> events;
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", out);
+    bool first = true;
+    for (const auto& ring : g_rings) {
+        // Copy, then drop whatever the owner may have overwritten meanwhile:
+        // event i is intact only if the writer has not yet started on
+        // event i + size, i.e. head is still at most i + size - 1 after it
+        size_t size = ring->events.size();
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t begin = head > size ? head - size : 0;
+        events.clear();
+        for (uint64_t i = begin; i < head; i++) events.push_back(ring->events[i % size]);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = ring->head.load(std::memory_order_relaxed);
+        uint64_t valid = after >= size ? after - size + 1 : 0;
+        size_t skip = valid > begin ? static_cast<size_t>(valid - begin) : 0;
+
+        std::string threadName;
+        {
+            std::lock_guard<std::mutex> nameLock(ring->nameMutex);
+            threadName = ring->name;
+        }
+        fprintf(out, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%ld,\"tid\":%ld,\"args\":{\"name\":%s}}",
+                first ? "" : ",\n", pid, ring->tid, nlohmann::json(threadName).dump().c_str());
+        first = false;
+
+        for (size_t i = skip; i < events.size(); i++) {
+            const Event& e = events[i];
+            std::string name = nlohmann::json(e.name).dump();
+            if (e.isCounter) {
+                fprintf(out, ",\n{\"ph\":\"C\",\"name\":%s,\"pid\":%ld,\"tid\":%ld,\"ts\":%.3f,\"args\":{\"value\":%g}}",
+                        name.c_str(), pid, ring->tid, e.startNs / 1000.0, e.value);
+            } else {
+                fprintf(out, ",\n{\"ph\":\"X\",\"name\":%s,\"pid\":%ld,\"tid\":%ld,\"ts\":%.3f,\"dur\":%.3f}",
+                        name.c_str(), pid, ring->tid, e.startNs / 1000.0, e.durNs / 1000.0);
+            }
+            written++;
+        }
+    }
+    fputs("\n]}\n", out);
+    bool ok = fclose(out) == 0;
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[Trace] Wrote " << written << " events from " << g_rings.size() << " threads to "
+              << path << " in " << static_cast<int>(ms) << "ms" << std::endl;
+    return ok;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Flight-recorder tracing of the audio pipeline. Spans and counters are
+// written to a fixed-size ring per thread (the newest 32768 events are
+// kept), with no locks or allocation after a thread's first event, and
+// dumped as Chrome trace event JSON for chrome://tracing or ui.perfetto.dev.
+//
+// Recording is switched on once at startup (ZOOM_BOT_TRACE); while it is
+// off, TRACE_SCOPE and TRACE_COUNTER cost one relaxed atomic load.
+class Tracer {
+public:
+    static void enable();
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Label for the calling thread in the trace (defaults to its OS name)
+    static void nameThread(const char* name);
+
+    // name must be a string literal or otherwise outlive the tracer
+    static void complete(const char* name, uint64_t startNs, uint64_t endNs);
+    static void counter(const char* name, double value);
+    static uint64_t nowNs();
+
+    // Writes the events currently held by every thread's ring. Safe to call
+    // while other threads keep recording.
+    static bool dump(const std::string& path);
+
+private:
+    static inline std::atomic<bool> enabled_{false};
+};
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : name_(Tracer::enabled() ? name : nullptr), startNs_(name_ ? Tracer::nowNs() : 0) {}
+    ~TraceScope() {
+        if (name_) Tracer::complete(name_, startNs_, Tracer::nowNs());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t startNs_;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+// Records the enclosing block as a span
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+#define TRACE_COUNTER(name, value) \
+    do { if (Tracer::enabled()) Tracer::counter(name, static_cast<double>(value)); } while (0)
@@ -0,0 +1,284 @@
+#include "transcription_client.h"
+#include "tracer.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+static uint64_t wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Typed field lookups for messages from the service: a field that is absent
+// or of an unexpected type reads as the fallback instead of throwing, since
+// an exception out of the socket callback would end the process
+static const nlohmann::json& field(const nlohmann::json& obj, const char* key) {
+    static const nlohmann::json none;
+    if (!obj.is_object()) return none;
+    auto it = obj.find(key);
+    return it != obj.end() ? *it : none;
+}
+
+static double numberOr(const nlohmann::json& obj, const char* key, double fallback) {
+    const auto& value = field(obj, key);
+    return value.is_number() ? value.get<double>() : fallback;
+}
+
+static bool flagSet(const nlohmann::json& obj, const char* key) {
+    const auto& value = field(obj, key);
+    return value.is_boolean() && value.get<bool>();
+}
+
+TranscriptionClient::TranscriptionClient(const Config& config, Metrics& metrics)
+    : metrics_(metrics),
+      auth_(config.transcribeAuth),
+      policy_(RECONNECT_BASE_MS, config.reconnectMaxMs),
+      stream_(std::random_device{}()),
+      backlogLimitBytes_(config.reconnectBacklogMs * AUDIO_BYTES_PER_MS) {
+    url_ = config.transcribeUrl;
+    if (!config.transcribeParams.empty()) {
+        url_ += (url_.find('?') == std::string::npos ? "?" : "&") + config.transcribeParams;
+    }
+}
+
+TranscriptionClient::~TranscriptionClient() {
+    disconnect();
+}
+
+void TranscriptionClient::connect() {
+    ws_.setUrl(url_);
+    if (!auth_.empty()) ws_.setExtraHeaders({{"Authorization", auth_}});
+    ws_.disableAutomaticReconnection();
+    ws_.setHandshakeTimeout(HANDSHAKE_TIMEOUT_S);
+
+    ws_.setOnMessageCallback([this](const ix::WebSocketMessagePtr& msg) {
+        switch (msg->type) {
+            case ix::WebSocketMessageType::Open:
+                onOpen();
+                break;
+
+            case ix::WebSocketMessageType::Close:
+                std::cout << "[Transcribe] Disconnected: " << msg->closeInfo.code << " "
+                          << msg->closeInfo.reason << std::endl;
+                onClose();
+                break;
+
+            case ix::WebSocketMessageType::Error:
+                std::cerr << "[Transcribe] Error: " << msg->errorInfo.reason;
+                if (msg->errorInfo.http_status != 0) std::cerr << " (HTTP " << msg->errorInfo.http_status << ")";
+                std::cerr << std::endl;
+                onClose();
+                break;
+
+            case ix::WebSocketMessageType::Message:
+                if (!msg->binary) onMessage(msg->str);
+                break;
+
+            default:
+                break;
+        }
+    });
+
+    // The query string may carry credentials; log the endpoint only
+    std::cout << "[Transcribe] Streaming audio directly to " << url_.substr(0, url_.find('?'))
+              << " (paused until the gateway reports transcription active)" << std::endl;
+    running_ = true;
+    supervisor_ = std::thread([this] { supervise(); });
+}
+
+void TranscriptionClient::disconnect() {
+    if (!running_.exchange(false)) return;
+
+    // Ask the service to flush its last results before the socket goes
+    {
+        std::unique_lock<std::mutex> lock(streamMutex_);
+        if (connected_) {
+            ws_.sendText(R"({"type":"CloseStream"})");
+            closed_.wait_for(lock, std::chrono::milliseconds(CLOSE_WAIT_MS), [this] { return !connected_; });
+        }
+    }
+
+    wakeup_.notify_all();
+    ws_.close();
+    if (supervisor_.joinable()) supervisor_.join();
+}
+
+void TranscriptionClient::supervise() {
+    Tracer::nameThread("transcribe");
+
+    while (running_) {
+        auto start = Clock::now();
+        ix::WebSocketInitResult result;
+        {
+            TRACE_SCOPE("transcribe.connect");
+            result = ws_.connect(HANDSHAKE_TIMEOUT_S);
+        }
+
+        if (result.success) {
+            metrics_.setGauge("transcribe.connect_ms",
+                              std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+            if (!running_) {
+                ws_.close();
+                break;
+            }
+            auto opened = Clock::now();
+            ws_.run();  // returns once the connection closes
+            policy_.connectionClosed(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - opened).count()));
+        } else if (policy_.attempts() == 0 || policy_.attempts() % 10 == 0) {
+            std::cerr << "[Transcribe] Connect failed: " << result.errorStr;
+            if (result.http_status != 0) std::cerr << " (HTTP " << result.http_status << ")";
+            std::cerr << std::endl;
+        }
+
+        if (!running_) break;
+        uint32_t delayMs = policy_.nextDelayMs();
+        std::unique_lock<std::mutex> lock(waitMutex_);
+        wakeup_.wait_for(lock, std::chrono::milliseconds(delayMs), [this] { return !running_; });
+    }
+}
+
+void TranscriptionClient::onOpen() {
+    std::lock_guard<std::mutex> lock(streamMutex_);
+    std::cout << "[Transcribe] Connected";
+
+    // A new connection is a new stream: its offsets start again at zero
+    connected_ = true;
+    stream_++;
+    anchors_.clear();
+    sentSeconds_ = 0.0;
+    needAnchor_ = true;
+    lastKeepAlive_ = Clock::now();
+
+    if (!backlog_.empty()) {
+        std::cout << ", sending " << backlogBytes_ / AUDIO_BYTES_PER_MS << "ms of held audio";
+        metrics_.addCounter("transcribe.backlog_replayed_ms", backlogBytes_ / AUDIO_BYTES_PER_MS);
+        for (const auto& [captureMs, pcm] : backlog_) {
+            if (!sendLocked(pcm, captureMs)) break;
+        }
+        backlog_.clear();
+        backlogBytes_ = 0;
+    }
+    std::cout << std::endl;
+}
+
+void TranscriptionClient::onClose() {
+    std::lock_guard<std::mutex> lock(streamMutex_);
+    connected_ = false;
+    closed_.notify_all();
+}
+
+void TranscriptionClient::setPaused(bool paused) {
+    if (paused_.exchange(paused) == paused) return;
+    std::cout << "[Transcribe] " << (paused ? "Paused" : "Resumed") << " by the gateway" << std::endl;
+
+    std::lock_guard<std::mutex> lock(streamMutex_);
+    needAnchor_ = true;
+    if (paused) {
+        // Nothing held from before the pause may be sent after it
+        backlog_.clear();
+        backlogBytes_ = 0;
+        if (connected_) ws_.sendText(R"({"type":"Finalize"})");
+    }
+}
+
+void TranscriptionClient::sendAudio(const char* pcm, size_t len) {
+    TRACE_SCOPE("transcribe.send_audio");
+    uint64_t captureMs = wallClockMs() - len / AUDIO_BYTES_PER_MS;
+    std::lock_guard<std::mutex> lock(streamMutex_);
+
+    if (paused_) {
+        // The service closes idle streams after ~10s without audio
+        auto now = Clock::now();
+        if (connected_ && now - lastKeepAlive_ >= std::chrono::seconds(KEEPALIVE_INTERVAL_S)) {
+            ws_.sendText(R"({"type":"KeepAlive"})");
+            lastKeepAlive_ = now;
+        }
+        return;
+    }
+
+    std::string frame(pcm, len);
+    if (connected_ && sendLocked(frame, captureMs)) return;
+
+    if (backlogLimitBytes_ == 0) return;
+    backlogBytes_ += frame.size();
+    backlog_.emplace_back(captureMs, std::move(frame));
+    while (backlogBytes_ > backlogLimitBytes_) {
+        backlogBytes_ -= backlog_.front().second.size();
+        backlog_.pop_front();
+    }
+}
+
+bool TranscriptionClient::sendLocked(const std::string& pcm, uint64_t captureMs) {
+    if (needAnchor_) {
+        anchors_.push_back({sentSeconds_, captureMs});
+        if (anchors_.size() > MAX_ANCHORS) anchors_.erase(anchors_.begin());
+        needAnchor_ = false;
+    }
+    if (!ws_.sendBinary(pcm).success) {
+        needAnchor_ = true;
+        return false;
+    }
+    sentSeconds_ += static_cast<double>(pcm.size()) / (AUDIO_BYTES_PER_MS * 1000);
+    return true;
+}
+
+uint64_t TranscriptionClient::captureTimeLocked(double audioSeconds) const {
+    for (auto it = anchors_.rbegin(); it != anchors_.rend(); ++it) {
+        if (it->audioSeconds <= audioSeconds) {
+            return it->captureMs + static_cast<uint64_t>((audioSeconds - it->audioSeconds) * 1000);
+        }
+    }
+    return 0;
+}
+
+void TranscriptionClient::onMessage(const std::string& text) {
+    auto msg = nlohmann::json::parse(text, nullptr, false);
+    if (field(msg, "type") != "Results") return;
+    if (!flagSet(msg, "is_final") && !flagSet(msg, "speech_final")) return;
+
+    const auto& alternatives = field(field(msg, "channel"), "alternatives");
+    if (!alternatives.is_array() || alternatives.empty()) return;
+    const auto& best = alternatives[0];
+    const auto& transcriptValue = field(best, "transcript");
+    if (!transcriptValue.is_string()) return;
+    const auto& transcript = transcriptValue.get_ref<const std::string&>();
+    if (transcript.find_first_not_of(" \t\r\n") == std::string::npos) return;
+
+    // Same labels as the gateway's own Deepgram client, so its speaker map
+    // resolves them the same way
+    std::string speaker = "Speaker 0";
+    const auto& words = field(best, "words");
+    if (words.is_array() && !words.empty()) {
+        const auto& label = field(words[0], "speaker");
+        if (label.is_number_integer()) speaker = "Speaker " + std::to_string(label.get<int>());
+    }
+
+    double start = numberOr(msg, "start", 0.0);
+    double duration = std::max(numberOr(msg, "duration", 0.0), 0.0);
+    uint64_t startMs;
+    uint64_t endMs;
+    uint32_t stream;
+    {
+        std::lock_guard<std::mutex> lock(streamMutex_);
+        startMs = captureTimeLocked(start);
+        endMs = captureTimeLocked(start + duration);
+        stream = stream_;
+    }
+
+    nlohmann::json result;
+    result["type"] = "transcript_result";
+    result["timestamp"] = startMs != 0 ? startMs : wallClockMs();
+    result["durationMs"] = static_cast<uint64_t>(duration * 1000);
+    result["speaker"] = speaker;
+    result["text"] = transcript;
+    result["confidence"] = numberOr(best, "confidence", 0.0);
+    result["stream"] = stream;
+
+    metrics_.addCounter("transcribe.results");
+    if (endMs != 0) {
+        uint64_t now = wallClockMs();
+        metrics_.setGauge("transcribe.result_lag_ms", now > endMs ? static_cast<double>(now - endMs) : 0.0);
+    }
+    if (resultHandler_) resultHandler_(result);
+}
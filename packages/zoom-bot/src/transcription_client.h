@@ -0,0 +1,99 @@
+#pragma once
+
+#include "config.h"
+#include "metrics.h"
+#include "reconnect_policy.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ixwebsocket/IXWebSocket.h>
+#include <nlohmann/json.hpp>
+
+// Streams the outgoing audio straight to a Deepgram-compatible live
+// transcription WebSocket (ZOOM_BOT_TRANSCRIBE_URL), skipping the gateway
+// hop; final results are handed back as transcript_result messages for the
+// gateway to attribute and publish.
+//
+// Starts paused: audio is only sent once the gateway reports transcription
+// as active, so pausing from IRC still keeps speech away from the service.
+// While paused the socket is kept open with KeepAlive messages.
+//
+// Result times are the service's offsets into the audio it received; each
+// run of contiguous audio (after a connect, a pause or a lost frame) is
+// anchored to its capture time so results carry wall-clock timestamps.
+// Every connection is a new stream with its own diarization, so results
+// carry a stream id that changes on each connect: the gateway starts its
+// speaker map over when it does.
+class TranscriptionClient {
+public:
+    using ResultHandler = std::function<void(const nlohmann::json&)>;
+
+    TranscriptionClient(const Config& config, Metrics& metrics);
+    ~TranscriptionClient();
+
+    // Set before connect(); called on the network thread
+    void onResult(ResultHandler handler) { resultHandler_ = std::move(handler); }
+
+    void connect();
+    void disconnect();
+
+    // 16kHz mono 16-bit PCM, from the audio thread
+    void sendAudio(const char* pcm, size_t len);
+
+    void setPaused(bool paused);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Anchor {
+        double audioSeconds;  // service-side offset where the run starts
+        uint64_t captureMs;   // wall-clock capture time of that audio
+    };
+
+    Metrics& metrics_;
+    std::string url_;
+    std::string auth_;
+    ResultHandler resultHandler_;
+
+    ix::WebSocket ws_;
+    ReconnectPolicy policy_;
+    std::thread supervisor_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> paused_{true};
+    std::mutex waitMutex_;
+    std::condition_variable wakeup_;
+
+    // Guarded by streamMutex_: connection state, the current stream's time
+    // anchors, and audio held while disconnected (with capture times)
+    std::mutex streamMutex_;
+    std::condition_variable closed_;
+    bool connected_ = false;
+    uint32_t stream_;  // random start, so a restarted bot does not repeat one
+    std::vector<Anchor> anchors_;
+    double sentSeconds_ = 0.0;
+    bool needAnchor_ = true;
+    std::deque<std::pair<uint64_t, std::string>> backlog_;
+    size_t backlogBytes_ = 0;
+    size_t backlogLimitBytes_;
+    Clock::time_point lastKeepAlive_;
+
+    void supervise();
+    void onOpen();
+    void onClose();
+    void onMessage(const std::string& text);
+    bool sendLocked(const std::string& pcm, uint64_t captureMs);
+    uint64_t captureTimeLocked(double audioSeconds) const;
+
+    static constexpr int HANDSHAKE_TIMEOUT_S = 5;
+    static constexpr uint32_t RECONNECT_BASE_MS = 250;
+    static constexpr int KEEPALIVE_INTERVAL_S = 5;
+    static constexpr int CLOSE_WAIT_MS = 2000;
+    static constexpr size_t MAX_ANCHORS = 256;
+    static constexpr size_t AUDIO_BYTES_PER_MS = 16000 * 2 / 1000;  // 16kHz mono 16-bit
+};
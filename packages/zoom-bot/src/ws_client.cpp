@@ -1,39 +1,63 @@
 #include "ws_client.h"
+#include "tracer.h"
+#include "transcription_client.h"
 #include <iostream>
 
-WSClient::WSClient() {}
+static constexpr uint32_t RECONNECT_BASE_MS = 250;
+
+WSClient::WSClient(const Config& config, Metrics& metrics)
+    : metrics_(metrics),
+      caFile_(config.gatewayCaFile),
+      policy_(RECONNECT_BASE_MS, config.reconnectMaxMs, STABLE_CONNECTION_MS),
+      endpoints_(config.gatewayDnsTtlMs),
+      networkProfile_(ThreadProfile::parse(config.networkCpus, config.realtimePolicy,
+                                           config.realtimePriority)),
+      backlogLimitBytes_(config.reconnectBacklogMs * AUDIO_BYTES_PER_MS) {}
 
 WSClient::~WSClient() {
     disconnect();
 }
 
 void WSClient::connect(const std::string& url) {
-    ws_.setUrl(url);
+    const std::string shmScheme = "shm://";
+    if (url.compare(0, shmScheme.size(), shmScheme) == 0) {
+        shm_ = std::make_unique<ShmTransport>(SHM_RING_BYTES);
+        shm_->onMessage([this](const std::string& text) { onMessage(text); });
+        shm_->connect(url.substr(shmScheme.size()));
+        return;
+    }
+
+    url_ = url;
+    if (!caFile_.empty()) {
+        ix::SocketTLSOptions tls;
+        tls.caFile = caFile_;
+        ws_.setTLSOptions(tls);
+    }
 
-    // Auto-reconnect with exponential backoff
-    ws_.enableAutomaticReconnection();
-    ws_.setMinWaitBetweenReconnectionRetries(1000);  // 1s
-    ws_.setMaxWaitBetweenReconnectionRetries(10000); // 10s
+    // Reconnects are driven by supervise(); ixwebsocket's built-in loop
+    // waits at least its minimum delay even for the first retry
+    ws_.disableAutomaticReconnection();
+    ws_.setHandshakeTimeout(HANDSHAKE_TIMEOUT_S);
+    ws_.setPingInterval(PING_INTERVAL_S);
 
     ws_.setOnMessageCallback([this](const ix::WebSocketMessagePtr& msg) {
         switch (msg->type) {
             case ix::WebSocketMessageType::Open:
-                std::cout << "[WS] Connected to gateway" << std::endl;
-                connected_ = true;
+                onOpen();
                 break;
 
             case ix::WebSocketMessageType::Close:
                 std::cout << "[WS] Disconnected from gateway: " << msg->closeInfo.reason << std::endl;
-                connected_ = false;
+                onClose();
                 break;
 
             case ix::WebSocketMessageType::Error:
                 std::cerr << "[WS] Error: " << msg->errorInfo.reason << std::endl;
-                connected_ = false;
+                onClose();
                 break;
 
             case ix::WebSocketMessageType::Message:
-                // Gateway might send commands back (future use)
+                if (!msg->binary) onMessage(msg->str);
                 break;
 
             default:
@@ -42,20 +66,179 @@ void WSClient::connect(const std::string& url) {
     });
 
     std::cout << "[WS] Connecting to " << url << std::endl;
-    ws_.start();
+    running_ = true;
+    supervisor_ = std::thread([this] { supervise(); });
 }
 
 void WSClient::disconnect() {
-    ws_.stop();
+    if (shm_) {
+        shm_->disconnect();
+        return;
+    }
+    running_ = false;
+    wakeup_.notify_all();
+    ws_.close();
+    if (supervisor_.joinable()) supervisor_.join();
     connected_ = false;
 }
 
+void WSClient::supervise() {
+    networkProfile_.applyToCurrentThread("network");
+    Tracer::nameThread("ws-supervisor");
+
+    while (running_) {
+        auto start = Clock::now();
+        ws_.setUrl(endpoints_.resolve(url_));
+        if (endpoints_.lookupMs() >= 0) metrics_.setGauge("ws.dns_ms", endpoints_.lookupMs());
+
+        auto handshakeStart = Clock::now();
+        ix::WebSocketInitResult result;
+        {
+            TRACE_SCOPE("ws.connect");
+            result = ws_.connect(HANDSHAKE_TIMEOUT_S);
+        }
+
+        if (result.success) {
+            // ixwebsocket does TCP, TLS and the upgrade in one call (and the
+            // DNS lookup too when it was not ours), so they are timed together
+            auto opened = Clock::now();
+            metrics_.setGauge("ws.handshake_ms",
+                              std::chrono::duration<double, std::milli>(opened - handshakeStart).count());
+            metrics_.setGauge("ws.connect_ms", std::chrono::duration<double, std::milli>(opened - start).count());
+
+            // disconnect() may have run while the handshake was in flight
+            if (!running_) {
+                ws_.close();
+                break;
+            }
+            ws_.run();  // returns once the connection closes
+            policy_.connectionClosed(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - opened).count()));
+        } else {
+            endpoints_.failed();
+            if (policy_.attempts() == 0 || policy_.attempts() % 10 == 0) {
+                std::cerr << "[WS] Connect failed: " << result.errorStr << std::endl;
+            }
+        }
+
+        if (!running_) break;
+        uint32_t delayMs = policy_.nextDelayMs();
+        std::unique_lock<std::mutex> lock(waitMutex_);
+        wakeup_.wait_for(lock, std::chrono::milliseconds(delayMs), [this] { return !running_; });
+    }
+}
+
+void WSClient::onOpen() {
+    TRACE_SCOPE("ws.open");
+    std::lock_guard<std::mutex> lock(backlogMutex_);
+
+    if (everConnected_) {
+        double outageMs = std::chrono::duration<double, std::milli>(Clock::now() - disconnectedAt_).count();
+        metrics_.setGauge("ws.outage_ms", outageMs);
+        metrics_.addCounter("ws.reconnects");
+        std::cout << "[WS] Reconnected to gateway after " << static_cast<int>(outageMs) << "ms";
+    } else {
+        std::cout << "[WS] Connected to gateway";
+    }
+    everConnected_ = true;
+
+    // Replay held audio ahead of live audio so the stream stays in order
+    if (!backlog_.empty()) {
+        std::cout << ", replaying " << backlogBytes_ / AUDIO_BYTES_PER_MS << "ms of audio";
+        metrics_.addCounter("ws.backlog_replayed_ms", backlogBytes_ / AUDIO_BYTES_PER_MS);
+        for (const auto& frame : backlog_) ws_.sendBinary(frame);
+        backlog_.clear();
+        backlogBytes_ = 0;
+        TRACE_COUNTER("ws.backlog_bytes", 0);
+    }
+    if (backlogDroppedBytes_ > 0) {
+        std::cout << " (" << backlogDroppedBytes_ / AUDIO_BYTES_PER_MS << "ms lost)";
+        metrics_.addCounter("ws.backlog_dropped_ms", backlogDroppedBytes_ / AUDIO_BYTES_PER_MS);
+        backlogDroppedBytes_ = 0;
+    }
+    if (!heldResults_.empty() || droppedResults_ > 0) {
+        std::cout << ", sending " << heldResults_.size() << " held results";
+        if (droppedResults_ > 0) std::cout << " (" << droppedResults_ << " lost)";
+        metrics_.addCounter("ws.results_held", heldResults_.size());
+        if (droppedResults_ > 0) metrics_.addCounter("ws.results_dropped", droppedResults_);
+        for (const auto& text : heldResults_) ws_.send(text);
+        heldResults_.clear();
+        droppedResults_ = 0;
+    }
+    std::cout << std::endl;
+
+    connected_ = true;
+}
+
+void WSClient::onClose() {
+    std::lock_guard<std::mutex> lock(backlogMutex_);
+    if (connected_) disconnectedAt_ = Clock::now();
+    connected_ = false;
+}
+
+void WSClient::onMessage(const std::string& text) {
+    if (!commandHandler_) return;
+    auto command = nlohmann::json::parse(text, nullptr, false);
+    if (!command.is_object() || !command.contains("type")) {
+        std::cerr << "[WS] Ignoring malformed command from gateway" << std::endl;
+        return;
+    }
+    commandHandler_(command);
+}
+
 void WSClient::sendAudio(const char* pcm, size_t len) {
-    if (!connected_) return;
-    ws_.sendBinary(std::string(pcm, len));
+    if (audioRoute_) {
+        audioRoute_->sendAudio(pcm, len);
+        return;
+    }
+    TRACE_SCOPE("ws.send_audio");
+    if (shm_) {
+        shm_->sendAudio(pcm, len);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(backlogMutex_);
+    if (connected_) {
+        if (ws_.sendBinary(std::string(pcm, len)).success) return;
+        // The socket died before the close was reported; keep this frame
+        disconnectedAt_ = Clock::now();
+        connected_ = false;
+    }
+
+    if (backlogLimitBytes_ == 0) return;
+    backlog_.emplace_back(pcm, len);
+    backlogBytes_ += len;
+    while (backlogBytes_ > backlogLimitBytes_) {
+        backlogBytes_ -= backlog_.front().size();
+        backlogDroppedBytes_ += backlog_.front().size();
+        backlog_.pop_front();
+    }
+    TRACE_COUNTER("ws.backlog_bytes", backlogBytes_);
 }
 
 void WSClient::sendMetadata(const nlohmann::json& msg) {
+    TRACE_SCOPE("ws.send_metadata");
+    if (shm_) {
+        shm_->sendMetadata(msg.dump());
+        return;
+    }
     if (!connected_) return;
     ws_.send(msg.dump());
 }
+
+void WSClient::sendResult(const nlohmann::json& msg) {
+    if (shm_) {
+        shm_->sendMetadata(msg.dump());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(backlogMutex_);
+    std::string text = msg.dump();
+    if (connected_ && ws_.send(text).success) return;
+
+    heldResults_.push_back(std::move(text));
+    if (heldResults_.size() > MAX_HELD_RESULTS) {
+        heldResults_.pop_front();
+        droppedResults_++;
+    }
+}
@@ -1,26 +1,103 @@
 #pragma once
 
+#include "config.h"
+#include "endpoint_cache.h"
+#include "metrics.h"
+#include "reconnect_policy.h"
+#include "shm_transport.h"
+#include "thread_profile.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <ixwebsocket/IXWebSocket.h>
 #include <nlohmann/json.hpp>
 
+class TranscriptionClient;
+
 class WSClient {
 public:
-    WSClient();
+    WSClient(const Config& config, Metrics& metrics);
     ~WSClient();
 
+    // ws:// and wss:// URLs use a WebSocket; shm:///path/to/socket uses a
+    // shared-memory ring with a reader on the same host
     void connect(const std::string& url);
     void disconnect();
 
-    // Send raw PCM audio data (binary frame)
+    // Send raw PCM audio data (binary frame). While the gateway is
+    // unreachable, the most recent ZOOM_BOT_RECONNECT_BACKLOG_MS of audio is
+    // held and replayed on reconnect (by default none is).
     void sendAudio(const char* pcm, size_t len);
 
-    // Send JSON metadata (text frame)
+    // Direct transcription: audio goes to this client instead of the
+    // gateway, which then only receives metadata. Set before audio flows.
+    void routeAudioTo(TranscriptionClient* client) { audioRoute_ = client; }
+
+    // Send JSON metadata (text frame); dropped while the gateway is
+    // unreachable
     void sendMetadata(const nlohmann::json& msg);
 
-    bool isConnected() const { return connected_; }
+    // Like sendMetadata, for results that cannot be produced again (direct
+    // transcription): up to MAX_HELD_RESULTS are held while the gateway is
+    // unreachable and sent, in order, once it is back
+    void sendResult(const nlohmann::json& msg);
+
+    // JSON commands sent by the gateway (or the shm:// reader); called on
+    // the network thread, or the shm transport's monitor thread.
+    // Set before connect().
+    using CommandHandler = std::function<void(const nlohmann::json&)>;
+    void onCommand(CommandHandler handler) { commandHandler_ = std::move(handler); }
+
+    bool isConnected() const { return shm_ ? shm_->isConnected() : connected_.load(); }
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    Metrics& metrics_;
+    std::string caFile_;
     ix::WebSocket ws_;
-    bool connected_ = false;
+    std::atomic<bool> connected_{false};
+    std::unique_ptr<ShmTransport> shm_;
+    CommandHandler commandHandler_;
+    TranscriptionClient* audioRoute_ = nullptr;
+
+    // Connection supervisor: replaces ixwebsocket's own reconnect loop so
+    // the first retry is immediate and later ones are jittered
+    ReconnectPolicy policy_;
+    EndpointCache endpoints_;
+    std::string url_;
+    ThreadProfile networkProfile_;  // the supervisor also runs the socket I/O
+    std::thread supervisor_;
+    std::atomic<bool> running_{false};
+    std::mutex waitMutex_;
+    std::condition_variable wakeup_;
+    Clock::time_point disconnectedAt_;
+    bool everConnected_ = false;
+
+    // Audio held while disconnected, oldest first
+    std::mutex backlogMutex_;
+    std::deque<std::string> backlog_;
+    size_t backlogBytes_ = 0;
+    size_t backlogLimitBytes_;
+    uint64_t backlogDroppedBytes_ = 0;
+    std::deque<std::string> heldResults_;
+    uint64_t droppedResults_ = 0;
+
+    void supervise();
+    void onOpen();
+    void onClose();
+    void onMessage(const std::string& text);
+
+    static constexpr size_t SHM_RING_BYTES = 4 * 1024 * 1024;
+    static constexpr int HANDSHAKE_TIMEOUT_S = 5;
+    static constexpr int PING_INTERVAL_S = 5;
+    static constexpr uint32_t STABLE_CONNECTION_MS = 10000;  // resets the reconnect backoff
+    static constexpr size_t MAX_HELD_RESULTS = 1000;
+    static constexpr size_t AUDIO_BYTES_PER_MS = 16000 * 2 / 1000;  // 16kHz mono 16-bit
 };
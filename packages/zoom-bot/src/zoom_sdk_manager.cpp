@@ -1,11 +1,16 @@
 #include "zoom_sdk_manager.h"
 #include "jwt.h"
+#include "tracer.h"
 #include <glib.h>
+#include <algorithm>
 #include <iostream>
 
-ZoomSDKManager::ZoomSDKManager(const Config& config, ParticipantTracker& tracker, WSClient& wsClient)
-    : config_(config), tracker_(tracker), wsClient_(wsClient),
-      meetingEventHandler_(tracker, wsClient) {}
+ZoomSDKManager::ZoomSDKManager(const Config& config, ParticipantTracker& tracker, RosterBatcher& roster,
+                               WSClient& wsClient, Metrics& metrics, RewindBuffer& rewind, StateSnapshot& state,
+                               ParticipantArena& arena)
+    : config_(config), tracker_(tracker), wsClient_(wsClient), metrics_(metrics), rewind_(rewind), state_(state),
+      arena_(arena),
+      meetingEventHandler_(tracker, roster) {}
 
 ZoomSDKManager::~ZoomSDKManager() {
     cleanup();
@@ -121,7 +126,7 @@ void ZoomSDKManager::joinMeeting() {
     join.isVideoOff = true;
     join.isAudioOff = false;  // Must join audio to receive raw audio data
     join.isMyVoiceInMix = false;
-    join.isAudioRawDataStereo = false;
+    join.isAudioRawDataStereo = config_.audioStereo;
 
     err = meetingService_->Join(joinParam);
     if (err != ZOOMSDK::SDKERR_SUCCESS) {
@@ -132,8 +137,25 @@ void ZoomSDKManager::joinMeeting() {
     // Meeting status will arrive via callback
 }
 
+// GLib callback to flush partially aggregated audio frames
+static gboolean flushAudio(gpointer data) {
+    TRACE_SCOPE("flushAudio");
+    auto* mgr = static_cast<ZoomSDKManager*>(data);
+    mgr->flushStaleAudio();
+    return TRUE;
+}
+
+// GLib callback to publish the audio quality summary
+static gboolean publishAudioStats(gpointer data) {
+    TRACE_SCOPE("publishAudioStats");
+    auto* mgr = static_cast<ZoomSDKManager*>(data);
+    mgr->publishAudioStats();
+    return TRUE;
+}
+
 // GLib callback to attempt raw audio subscription after delay
 static gboolean trySubscribeAudio(gpointer data) {
+    TRACE_SCOPE("trySubscribeAudio");
     auto* mgr = static_cast<ZoomSDKManager*>(data);
     mgr->attemptAudioSubscription();
     return FALSE;  // Don't repeat
@@ -198,7 +220,7 @@ void ZoomSDKManager::attemptAudioSubscription() {
         return;
     }
 
-    audioHandler_ = new AudioRawDataHandler(tracker_, wsClient_);
+    audioHandler_ = new AudioRawDataHandler(config_, tracker_, wsClient_, metrics_, rewind_, state_, arena_);
 
     auto err = audioHelper->subscribe(audioHandler_);
     if (err != ZOOMSDK::SDKERR_SUCCESS) {
@@ -215,6 +237,21 @@ void ZoomSDKManager::attemptAudioSubscription() {
     }
 
     std::cout << "[SDK] Subscribed to raw audio successfully!" << std::endl;
+
+    // Check for stale partial frames at twice the allowed latency rate
+    guint flushIntervalMs = std::max(5u, config_.frameMaxLatencyMs / 2);
+    audioFlushSource_ = g_timeout_add(flushIntervalMs, flushAudio, this);
+    if (config_.statsIntervalMs > 0) {
+        audioStatsSource_ = g_timeout_add(config_.statsIntervalMs, ::publishAudioStats, this);
+    }
+}
+
+void ZoomSDKManager::flushStaleAudio() {
+    if (audioHandler_) audioHandler_->flushStaleAudio();
+}
+
+void ZoomSDKManager::publishAudioStats() {
+    if (audioHandler_) audioHandler_->publishAudioStats();
 }
 
 void ZoomSDKManager::leave() {
@@ -246,6 +283,14 @@ void ZoomSDKManager::cleanup() {
 
     ZOOMSDK::CleanUPSDK();
 
+    if (audioFlushSource_) {
+        g_source_remove(audioFlushSource_);
+        audioFlushSource_ = 0;
+    }
+    if (audioStatsSource_) {
+        g_source_remove(audioStatsSource_);
+        audioStatsSource_ = 0;
+    }
     delete audioHandler_;
     audioHandler_ = nullptr;
 
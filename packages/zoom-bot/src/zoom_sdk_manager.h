@@ -5,17 +5,25 @@
 #include "meeting_event_handler.h"
 #include "audio_raw_data_handler.h"
 #include "participant_tracker.h"
+#include "roster_batcher.h"
 #include "ws_client.h"
+#include "metrics.h"
+#include "rewind_buffer.h"
+#include "state_snapshot.h"
+#include "participant_arena.h"
 #include "zoom_sdk.h"
 #include "auth_service_interface.h"
 #include "meeting_service_interface.h"
 #include "rawdata/zoom_rawdata_api.h"
 #include "meeting_service_components/meeting_recording_interface.h"
+#include <glib.h>
 #include <atomic>
 
 class ZoomSDKManager {
 public:
-    ZoomSDKManager(const Config& config, ParticipantTracker& tracker, WSClient& wsClient);
+    ZoomSDKManager(const Config& config, ParticipantTracker& tracker, RosterBatcher& roster,
+                   WSClient& wsClient, Metrics& metrics, RewindBuffer& rewind, StateSnapshot& state,
+                   ParticipantArena& arena);
     ~ZoomSDKManager();
 
     bool initialize();
@@ -30,10 +38,20 @@ public:
     // Called by GLib timeout to attempt audio subscription
     void attemptAudioSubscription();
 
+    // Called by GLib timeout to send audio held in a partial frame
+    void flushStaleAudio();
+
+    // Called by GLib timeout to send the audio quality summary
+    void publishAudioStats();
+
 private:
     Config config_;
     ParticipantTracker& tracker_;
     WSClient& wsClient_;
+    Metrics& metrics_;
+    RewindBuffer& rewind_;
+    StateSnapshot& state_;
+    ParticipantArena& arena_;
 
     ZOOMSDK::IAuthService* authService_ = nullptr;
     ZOOMSDK::IMeetingService* meetingService_ = nullptr;
@@ -46,6 +64,8 @@ private:
     std::atomic<bool> inMeeting_{false};
     std::atomic<bool> failed_{false};
     int audioRetryCount_ = 0;
+    guint audioFlushSource_ = 0;
+    guint audioStatsSource_ = 0;
 
     void onAuthComplete(ZOOMSDK::AuthResult result);
     void joinMeeting();